@@ -18,6 +18,7 @@
 void print_usage(void)
 {
 	fprintf(stderr, "usage: bench -l <len> -c <cnt> -x <mismatch rate> -d <indel rate>\n");
+	fprintf(stderr, "       bench -r <watchdog dump> -c <cnt>\n");
 }
 
 /**
@@ -104,6 +105,7 @@ struct params {
 	double d;
 	char **pa;
 	char **pb;
+	char const *replay;
 };
 
 /**
@@ -123,6 +125,7 @@ int parse_args(struct params *p, int c, char *arg)
 		 */
 		case 'c': p->cnt = atoi((char *)arg); return 0;
 		case 'a': printf("%s\n", arg); return 0;
+		case 'r': p->replay = arg; return 0;
 		/**
 		 * the others: print help message
 		 */
@@ -131,6 +134,201 @@ int parse_args(struct params *p, int c, char *arg)
 	}
 }
 
+/**
+ * @struct replay_chain_s
+ *
+ * @brief section pairs of a chain in a watchdog record, listed from the tail back to the root.
+ */
+struct replay_chain_s {
+	uint64_t cnt;
+	uint32_t apos, bpos;
+	uint32_t end;						/* closed by gaba_dp_fill_end */
+	struct gaba_section_s *sec;			/* a and b, 2 * cnt */
+	uint8_t **seq;						/* sequence buffers, NULL where the section is shared with the previous pair */
+};
+
+/**
+ * @fn replay_load_section
+ *
+ * @brief load a section line of the watchdog dump, the sequence is decoded from hex string,
+ * "=" refers to the section of the previous line with the same tag.
+ */
+int replay_load_section(FILE *fp, struct gaba_section_s *sec, struct gaba_section_s const *prev, uint8_t **seq, uint32_t *pos)
+{
+	char tag;
+	uint32_t id, len;
+	*seq = NULL;
+	if(fscanf(fp, " %c\t%" SCNu32 "\t%" SCNu32 "\t%" SCNu32 "\t", &tag, &id, &len, pos) != 4) {
+		return 1;
+	}
+
+	int c = fgetc(fp);
+	if(c == '=') {
+		if(prev == NULL) { return 1; }
+		*sec = *prev;
+		return 0;
+	}
+	ungetc(c, fp);
+
+	/* 32-bytes margin at the tail, and zeros at the head, where the fill may load from */
+	if((*seq = (uint8_t *)calloc(len + 96, sizeof(uint8_t))) == NULL) { return 1; }
+	for(uint32_t i = 0; i < len; i++) {
+		c = fgetc(fp);
+		(*seq)[32 + i] = (c >= 'a') ? c - 'a' + 10 : c - '0';
+	}
+	*sec = gaba_build_section(id, *seq + 32, len);
+	return 0;
+}
+
+/**
+ * @fn replay_free_chain
+ */
+void replay_free_chain(struct replay_chain_s *c)
+{
+	for(uint64_t i = 0; i < 2 * c->cnt; i++) {
+		if(c->seq != NULL) { free(c->seq[i]); }
+	}
+	free(c->sec);
+	free(c->seq);
+	*c = (struct replay_chain_s){ 0 };
+	return;
+}
+
+/**
+ * @fn replay_load_chain
+ */
+int replay_load_chain(FILE *fp, struct replay_chain_s *c)
+{
+	*c = (struct replay_chain_s){ 0 };
+	if(fscanf(fp, " chain\t%" SCNu64 "\t%" SCNu32, &c->cnt, &c->end) != 2) {
+		return 1;
+	}
+	c->sec = (struct gaba_section_s *)calloc(2 * c->cnt + 1, sizeof(struct gaba_section_s));
+	c->seq = (uint8_t **)calloc(2 * c->cnt + 1, sizeof(uint8_t *));
+	if(c->sec == NULL || c->seq == NULL) {
+		replay_free_chain(c);
+		return 1;
+	}
+
+	for(uint64_t i = 0; i < c->cnt; i++) {
+		uint32_t apos, bpos;
+		if(replay_load_section(fp, &c->sec[2 * i], (i == 0) ? NULL : &c->sec[2 * i - 2], &c->seq[2 * i], &apos)
+		|| replay_load_section(fp, &c->sec[2 * i + 1], (i == 0) ? NULL : &c->sec[2 * i - 1], &c->seq[2 * i + 1], &bpos)) {
+			replay_free_chain(c);
+			return 1;
+		}
+		c->apos = apos; c->bpos = bpos;		/* root positions are on the last pair */
+	}
+	return 0;
+}
+
+/**
+ * @fn replay_fill_chain
+ *
+ * @brief rebuild a chain with fill_root, fill, and fill_end, the last call is timed.
+ */
+struct gaba_fill_s const *replay_fill_chain(gaba_dp_t *dp, struct replay_chain_s const *c, bench_t *b)
+{
+	struct gaba_fill_s const *f = NULL;
+	for(uint64_t i = c->cnt; i > 0; i--) {
+		struct gaba_section_s const *s = &c->sec[2 * (i - 1)];
+		if(i == 1 && !c->end) { bench_start(*b); }
+		f = (i == c->cnt)
+			? gaba_dp_fill_root(dp, &s[0], c->apos, &s[1], c->bpos)
+			: gaba_dp_fill(dp, f, &s[0], &s[1]);
+		if(i == 1 && !c->end) { bench_end(*b); }
+		if(f == NULL) { return NULL; }
+	}
+	if(c->end && f != NULL) {
+		bench_start(*b);
+		f = gaba_dp_fill_end(dp, f);
+		bench_end(*b);
+	}
+	return f;
+}
+
+/**
+ * @fn replay
+ *
+ * @brief replay records dumped by the watchdog (see gaba_dp_set_watchdog). the recorded chains
+ * are rebuilt, then the last fill of a fill record or the trace of a trace record is timed.
+ */
+int replay(char const *path, int64_t cnt)
+{
+	FILE *fp = fopen(path, "r");
+	if(fp == NULL) {
+		fprintf(stderr, "failed to open %s\n", path);
+		return 1;
+	}
+
+	char call[16];
+	uint64_t size, usec;
+	int m, x, gi, ge, xdrop, ebonus, recenter, steer;
+	unsigned tf, mode, ungapped;
+	long long score_stop;
+	void const *lim = (void const *)0x800000000000;
+	while(fscanf(fp, " call\t%15s\t%" SCNu64 "\t%" SCNu64, call, &size, &usec) == 3) {
+		if(fscanf(fp, " params\t%d\t%d\t%d\t%d\t%d\t%u\t%u\t%d\t%d\t%d\t%u\t%lld",
+			&m, &x, &gi, &ge, &xdrop, &tf, &mode, &ebonus, &recenter, &steer, &ungapped, &score_stop) != 12) {
+			break;
+		}
+
+		int trace = strcmp(call, "trace") == 0;
+		struct replay_chain_s fw, rv = { 0 };
+		if(replay_load_chain(fp, &fw)) { break; }
+		if(trace && replay_load_chain(fp, &rv)) {
+			replay_free_chain(&fw);
+			break;
+		}
+
+		gaba_t *ctx = gaba_init(GABA_PARAMS(
+			.xdrop = xdrop,
+			.filter_thresh = tf,
+			.mode = mode,
+			.ebonus = ebonus,
+			.recenter = recenter,
+			.steer = steer,
+			.ungapped = ungapped,
+			.score_stop = score_stop,
+			GABA_SCORE_SIMPLE(m, x, gi, ge)));
+
+		bench_t fill, trace_bench, dummy;
+		bench_init(fill);
+		bench_init(trace_bench);
+		bench_init(dummy);
+
+		int64_t score = 0;
+		for(int64_t i = 0; i < cnt; i++) {
+			gaba_dp_t *dp = gaba_dp_init(ctx, lim, lim);
+
+			struct gaba_fill_s const *f = replay_fill_chain(dp, &fw, trace ? &dummy : &fill);
+			if(!trace) {
+				score = (f == NULL) ? -1 : f->max;
+			} else {
+				struct gaba_fill_s const *r = replay_fill_chain(dp, &rv, &dummy);
+
+				bench_start(trace_bench);
+				struct gaba_alignment_s *a = gaba_dp_trace(dp, f, r, NULL);
+				bench_end(trace_bench);
+				score = (a == NULL) ? -1 : a->score;
+			}
+			gaba_dp_clean(dp);
+		}
+
+		/* recorded call, size, usec, then replayed time of the call and the score */
+		printf("%s\t%" PRIu64 "\t%" PRIu64 "\t%" PRId64 "\t%" PRId64 "\n",
+			call, size, usec,
+			trace ? bench_get(trace_bench) : bench_get(fill),
+			score);
+
+		gaba_clean(ctx);
+		replay_free_chain(&fw);
+		replay_free_chain(&rv);
+	}
+	fclose(fp);
+	return 0;
+}
+
 /**
  * @fn main
  */
@@ -149,12 +347,18 @@ int main(int argc, char *argv[])
 	p.x = 0.1;
 	p.d = 0.1;
 	p.pa = p.pb = NULL;
+	p.replay = NULL;
 
 	/** parse args */
-	while((i = getopt(argc, argv, "q:t:o:l:x:d:c:a:seb:h")) != -1) {
+	while((i = getopt(argc, argv, "q:t:o:l:x:d:c:a:r:seb:h")) != -1) {
 		if(parse_args(&p, i, optarg) != 0) { exit(1); }
 	}
 
+	/** replay watchdog dump */
+	if(p.replay != NULL) {
+		return replay(p.replay, p.cnt);
+	}
+
 	fprintf(stderr, "len\t%" PRId64 "\ncnt\t%" PRId64 "\nx\t%f\nd\t%f\n", p.len, p.cnt, p.x, p.d);
 
 	/** init sequence */
@@ -22,6 +22,19 @@
 // #  define MODEL 					LINEAR
 #endif
 
+/* band steering policy, compiled as separate kernels */
+#define EDGE 						0
+#define CENTER 						1
+#define HYBRID 						2
+
+#ifdef STEER
+#  if !(STEER == EDGE || STEER == CENTER || STEER == HYBRID)
+#    error "STEER must be EDGE (0), CENTER (1), or HYBRID (2)."
+#  endif
+#else
+#  define STEER 					EDGE
+#endif
+
 
 /* import unittest */
 #ifndef UNITTEST_UNIQUE_ID
@@ -38,6 +51,7 @@
 #include <stdint.h>				/* uint32_t, uint64_t, ... */
 #include <stddef.h>				/* offsetof */
 #include <string.h>				/* memset, memcpy */
+#include <sys/time.h>			/* gettimeofday in watchdog */
 #include "gaba.h"
 #include "log.h"
 #include "lmm.h"
@@ -53,10 +67,17 @@
 
 /* add suffix */
 #ifdef SUFFIX
+#  if STEER == EDGE
+#    define suffix_steer(_base)		_base
+#  elif STEER == CENTER
+#    define suffix_steer(_base)		_base##_center
+#  else
+#    define suffix_steer(_base)		_base##_hybrid
+#  endif
 #  if MODEL == LINEAR
-#    define suffix(_base)			_base##_linear
+#    define suffix(_base)			suffix_steer(_base##_linear)
 #  else
-#    define suffix(_base)			_base##_affine
+#    define suffix(_base)			suffix_steer(_base##_affine)
 #  endif
 #else
 #  define suffix(_base)				_base
@@ -72,10 +93,13 @@
 
 
 #define MIN_BULK_BLOCKS				( 32 )
+#define RECENTER_SEGMENT			( 64 )		/* blocks between the checkpoints where the recentering refill restarts */
 #define MEM_ALIGN_SIZE				( 32 )		/* 32byte aligned for AVX2 environments */
 #define MEM_INIT_SIZE				( (uint64_t)256 * 1024 * 1024 )
 #define MEM_MARGIN_SIZE				( 2048 )
 #define PSUM_BASE					( 1 )
+#define TRACE_BATCH					( 16 )		/* pairs of leaves loaded ahead in gaba_dp_trace_batch */
+#define TRACE_JOIN_INIT				( 64 )		/* initial capacity of the walk states in gaba_dp_trace_tree */
 
 _static_assert(V2I32_MASK_01 == GABA_STATUS_UPDATE_A);
 _static_assert(V2I32_MASK_10 == GABA_STATUS_UPDATE_B);
@@ -95,17 +119,23 @@ _static_assert(V2I32_MASK_10 == GABA_STATUS_UPDATE_B);
 #define _force_inline	inline
 // #define _force_inline
 
+/**
+ * @macro _prefetch
+ * @brief read prefetch hint for gcc-compatible compilers
+ */
+#define _prefetch(x)	__builtin_prefetch((x), 0, 3)
+
 
 /** assume 64bit little-endian system */
 _static_assert(sizeof(void *) == 8);
 
 /** check size of structs declared in gaba.h */
-_static_assert(sizeof(struct gaba_params_s) == 8);
+_static_assert(sizeof(struct gaba_params_s) == 24);
 _static_assert(sizeof(struct gaba_section_s) == 16);
-_static_assert(sizeof(struct gaba_fill_s) == 64);
+_static_assert(sizeof(struct gaba_fill_s) == 152);
 _static_assert(sizeof(struct gaba_path_section_s) == 32);
 _static_assert(sizeof(struct gaba_path_s) == 8);
-_static_assert(sizeof(struct gaba_alignment_s) == 80);
+_static_assert(sizeof(struct gaba_alignment_s) == 112);
 _static_assert(sizeof(vec_masku_t) == 4);
 
 /**
@@ -224,11 +254,30 @@ _static_assert(sizeof(struct gaba_block_s) == 704);
 _static_assert(sizeof(struct gaba_phantom_block_s) == 192);
 #define _last_block(x)				( (struct gaba_block_s *)(x) - 1 )
 
+/**
+ * @struct gaba_leaf_s
+ * @brief (internal) a cell in the band, traceback starts from a leaf
+ */
+struct gaba_leaf_s {
+	struct gaba_joint_tail_s const *tail;
+	struct gaba_block_s const *blk;
+	uint32_t aridx, bridx;
+	int32_t p, q;
+	int64_t score;
+};
+_static_assert(sizeof(struct gaba_leaf_s) == 40);
+_static_assert(offsetof(struct gaba_leaf_s, tail) == offsetof(struct gaba_max_s, fill));
+_static_assert(offsetof(struct gaba_leaf_s, blk) == offsetof(struct gaba_max_s, blk));
+_static_assert(offsetof(struct gaba_leaf_s, aridx) == offsetof(struct gaba_max_s, aridx));
+_static_assert(offsetof(struct gaba_leaf_s, p) == offsetof(struct gaba_max_s, p));
+_static_assert(offsetof(struct gaba_leaf_s, score) == offsetof(struct gaba_max_s, score));
+#define _leaf(x)				( (struct gaba_leaf_s *)(x) )
+
 /**
  * @struct gaba_joint_tail_s
  *
  * @brief (internal) init vector container.
- * sizeof(struct gaba_joint_tail_s) == 64
+ * sizeof(struct gaba_joint_tail_s) == 192
  */
 struct gaba_joint_tail_s {
 	/* coordinates */
@@ -241,18 +290,42 @@ struct gaba_joint_tail_s {
 
 	/* status */
 	uint32_t stat;				/** (4) */
-	uint32_t rem_len;			/** (4) */
+	uint32_t mblk;				/** (4) #blocks back from the tail to the max block, zero if in the phantom */
 
 	/* section info */
 	struct gaba_joint_tail_s const *tail;/** (8) */
 	uint32_t apos, bpos;		/** (8) pos */
 	uint32_t alen, blen;		/** (8) len */
 	uint32_t aid, bid;			/** (8) id */
+	/** 64, 64 */
+
+	/* sequence pointers */
+	uint8_t const *aend, *bend;	/** (16) end pointers of the sections, base + len */
+
+	/* end cell, valid if stat has GABA_STATUS_END */
+	struct gaba_leaf_s end;		/** (40) */
+	uint32_t rapos, rbpos;		/** (8) root positions, on the first tail of the extension while the watchdog is enabled */
+	/** 64, 128 */
+
+	/* max in this fragment */
+	int64_t fmax;				/** (8) */
+	uint32_t faid, fbid;		/** (8) */
+	uint32_t fapos, fbpos;		/** (8) */
+	uint32_t emask;				/** (4) max on the edge lanes of the band, bit 0 for lane 0, for the recentering refill */
+	uint8_t inner;				/** (1) nonzero on the tails of the fills made by gaba_dp_fill_end on the margins */
+	uint8_t _pad2[3];
+	struct gaba_block_s const *fblk;/** (8) block where fmax was first reached, NULL if no cell was filled */
+	uint32_t aroot, broot;		/** (8) lengths filled from the root to the tail, capped at BW except on the intermediate tails (CONT) */
+	uint8_t _pad3[16];
+	/** 64, 192 */
 };
-_static_assert(sizeof(struct gaba_joint_tail_s) == 64);
+_static_assert(sizeof(struct gaba_joint_tail_s) == 192);
 _static_assert(offsetof(struct gaba_joint_tail_s, psum) == offsetof(struct gaba_fill_s, psum));
 _static_assert(offsetof(struct gaba_joint_tail_s, p) == offsetof(struct gaba_fill_s, p));
 _static_assert(offsetof(struct gaba_joint_tail_s, max) == offsetof(struct gaba_fill_s, max));
+_static_assert(offsetof(struct gaba_joint_tail_s, fmax) == offsetof(struct gaba_fill_s, fmax));
+_static_assert(offsetof(struct gaba_joint_tail_s, faid) == offsetof(struct gaba_fill_s, faid));
+_static_assert(offsetof(struct gaba_joint_tail_s, fapos) == offsetof(struct gaba_fill_s, fapos));
 #define _tail(x)				( (struct gaba_joint_tail_s *)(x) )
 #define _fill(x)				( (struct gaba_fill_s *)(x) )
 
@@ -312,8 +385,8 @@ struct gaba_reader_work_s {
 	uint8_t const *atail, *btail;		/** (16) tail of the current section */
 	int32_t alen, blen;					/** (8) lengths of the current section */
 	uint32_t aid, bid;					/** (8) ids */
-	uint64_t plim;						/** (8) p limit coordinate */
-	uint64_t _pad;						/** (8) */
+	int64_t max;						/** (8) max score in the current fragment */
+	struct gaba_block_s const *mblk;	/** (8) block where the max was first reached, NULL if in the phantom */
 	/** 64, 64 */
 
 	/** 64byte aligned */
@@ -400,18 +473,30 @@ struct gaba_stack_s {
 };
 _static_assert(sizeof(struct gaba_stack_s) == 32);
 
+/**
+ * @struct gaba_watchdog_s
+ * @brief slow-call capture config
+ */
+struct gaba_watchdog_s {
+	uint64_t cell_thresh;				/** (8) dump fills of more cells or traces of longer paths than this, zero to disable */
+	uint64_t usec_thresh;				/** (8) dump calls taking longer than this, zero to disable */
+	char const *path;					/** (8) dump file, the watchdog is disabled if NULL */
+	uint8_t _pad[40];
+};
+_static_assert(sizeof(struct gaba_watchdog_s) == 64);
+
 /**
  * @struct gaba_dp_context_s
  *
  * @brief (internal) container for dp implementations
- * sizeof(struct gaba_dp_context_s) == 640
+ * sizeof(struct gaba_dp_context_s) == 960
  */
 struct gaba_dp_context_s {
 	/** API function pointers */
-	void *api[6];						/** (48) */
+	void *api[14];						/** (112) */
 	uint8_t *stack_top;					/** (8) dynamic programming matrix */
 	uint8_t *stack_end;					/** (8) the end of dp matrix */
-	/** 64, 64 */
+	/** 128, 128 */
 
 	/** individually stored on init */
 
@@ -420,12 +505,12 @@ struct gaba_dp_context_s {
 		struct gaba_writer_work_s l;	/** (192) */
 		struct gaba_reader_work_s r;	/** (192) */
 	} w;
-	/** 192, 256 */
+	/** 192, 320 */
 
 	/** 64byte aligned */
 	/** loaded on init */
 	struct gaba_score_vec_s scv;		/** (80) substitution matrix and gaps */
-	/** 80, 336 */
+	/** 80, 400 */
 
 	/** 64byte aligned */
 	int8_t m;							/** (1) match award */
@@ -442,22 +527,45 @@ struct gaba_dp_context_s {
 	/* memory management */
 	struct gaba_mem_block_s *curr_mem;	/** (8) */
 	struct gaba_mem_block_s mem;		/** (32) */
-	/** 48, 384 */
+	/** 48, 448 */
 
 	/** phantom vectors */
 	/** 64byte aligned */
 	struct gaba_phantom_block_s blk;	/** (192) */
-	/** 192, 576 */
+	/** 192, 640 */
+
+	/** 64byte aligned */
+	struct gaba_joint_tail_s tail;		/** (192) */
+	/** 192, 832 */
+
+	/** 64byte aligned */
+	struct gaba_watchdog_s wd;			/** (64) */
+	/** 64, 896 */
 
 	/** 64byte aligned */
-	struct gaba_joint_tail_s tail;		/** (64) */
-	/** 64, 640 */
+	/** extended options */
+	uint8_t mode;						/** (1) GABA_MODE_EXTEND or GABA_MODE_GLOBAL */
+	int8_t eb;							/** (1) end bonus */
+	int8_t rc;							/** (1) direction bias for the recentering refill */
+	int8_t bias;						/** (1) bias added to the direction accumulator at the head of the next fill */
+	uint8_t ut;							/** (1) ungapped prefilter threshold */
+	uint8_t ur;							/** (1) set while the root section pair is rejected by the ungapped prefilter */
+	uint8_t _pad1[2];
+	int64_t ts;							/** (8) target score, the fill stops once the max reaches it */
+	int64_t tc;							/** (8) target score of the current fill, disabled if reached before */
+
+	/** max in the current fragment */
+	int64_t fmax;						/** (8) max of the cells filled in the fragment */
+	struct gaba_block_s const *fblk;	/** (8) block where fmax was first reached, NULL if no cell was filled */
+	int32_t abnd, bbnd;					/** (8) reverse indices of the root, lanes at or beyond them are outside the matrix */
+	uint8_t _pad[16];
+	/** 64, 960 */
 };
-_static_assert(sizeof(struct gaba_dp_context_s) == 640);
+_static_assert(sizeof(struct gaba_dp_context_s) == 960);
 #define GABA_DP_CONTEXT_LOAD_OFFSET	( offsetof(struct gaba_dp_context_s, scv) )
 #define GABA_DP_CONTEXT_LOAD_SIZE	( sizeof(struct gaba_dp_context_s) - GABA_DP_CONTEXT_LOAD_OFFSET )
-_static_assert(GABA_DP_CONTEXT_LOAD_OFFSET == 256);
-_static_assert(GABA_DP_CONTEXT_LOAD_SIZE == 384);
+_static_assert(GABA_DP_CONTEXT_LOAD_OFFSET == 320);
+_static_assert(GABA_DP_CONTEXT_LOAD_SIZE == 640);
 
 /**
  * @struct gaba_context_s
@@ -465,19 +573,19 @@ _static_assert(GABA_DP_CONTEXT_LOAD_SIZE == 384);
  * @brief (API) an algorithmic context.
  *
  * @sa gaba_init, gaba_close
- * sizeof(struct gaba_context_s) = 704
+ * sizeof(struct gaba_context_s) = 1024
  */
 struct gaba_context_s {
 	/** templates */
 	/** 64byte aligned */
-	struct gaba_dp_context_s k;		/** (640) */
-	/** 640, 640 */
+	struct gaba_dp_context_s k;		/** (960) */
+	/** 960, 960 */
 
 	/** 64byte aligned */
 	struct gaba_middle_delta_s md;	/** (64) */
-	/** 64, 704 */
+	/** 64, 1024 */
 };
-_static_assert(sizeof(struct gaba_context_s) == 704);
+_static_assert(sizeof(struct gaba_context_s) == 1024);
 
 /**
  * @enum _STATE
@@ -485,11 +593,13 @@ _static_assert(sizeof(struct gaba_context_s) == 704);
 enum _STATE {
 	CONT 	= 0,
 	UPDATE  = 0x0100,
-	TERM 	= 0x0200
+	TERM 	= 0x0200,
+	STOP	= 0x1000
 };
 _static_assert((int32_t)CONT == (int32_t)GABA_STATUS_CONT);
 _static_assert((int32_t)UPDATE == (int32_t)GABA_STATUS_UPDATE);
 _static_assert((int32_t)TERM == (int32_t)GABA_STATUS_TERM);
+_static_assert((int32_t)STOP == (int32_t)GABA_STATUS_STOP);
 
 
 /**
@@ -498,6 +608,22 @@ _static_assert((int32_t)TERM == (int32_t)GABA_STATUS_TERM);
 #define _rev(pos, len)				( (len) + (uint64_t)(len) - (uint64_t)(pos) - 1 )
 #define _roundup(x, base)			( ((x) + (base) - 1) & ~((base) - 1) )
 
+/**
+ * @fn fetch_char
+ * @brief load a base at ptr, complemented if ptr is in the mirrored space
+ */
+static inline
+uint8_t fetch_char(
+	uint8_t const *ptr,
+	uint8_t const *lim)
+{
+	static uint8_t const comp[16] = {
+		0x00, 0x08, 0x04, 0x0c, 0x02, 0x0a, 0x06, 0x0e,
+		0x01, 0x09, 0x05, 0x0d, 0x03, 0x0b, 0x07, 0x0f
+	};
+	return((ptr < lim) ? *ptr : comp[*((uint8_t const *)_rev(ptr, lim)) & 0x0f]);
+}
+
 /**
  * max and min
  */
@@ -554,10 +680,37 @@ void gaba_aligned_free(
  * @macro _dir_update
  * @brief update direction determiner for the next band
  */
+#if STEER == CENTER
+/* the accumulator holds the remaining steps to the target, a diagonal path alternates around zero */
+#define _dir_update(_dir, _vector, _sign) { \
+	(_dir).dynamic.acc += ((_dir).dynamic.array & 0x01) ? 1 : -1; \
+}
+#else
 #define _dir_update(_dir, _vector, _sign) { \
 	(_dir).dynamic.acc += (_sign) * (_ext(_vector, 0) - _ext(_vector, BW-1)); \
 	/*debug("acc(%d), (%d, %d)", (_dir).dynamic.acc, _ext(_vector, 0), _ext(_vector, BW-1));*/ \
 }
+#endif
+/**
+ * @macro _dir_recenter
+ * @brief steer toward the lane of the max score at the end of each block (lane 0 is on
+ * the right side), two steps shift a diagonal path by one lane.
+ */
+#if STEER == CENTER
+#define _dir_recenter(_dir, _delta) { \
+	(_dir).dynamic.acc = 2 * dir_calc_center_offset(this, _delta); \
+}
+#elif STEER == HYBRID
+/* edge steering inside the central half, centering outside */
+#define _dir_recenter(_dir, _delta) { \
+	int32_t _d = dir_calc_center_offset(this, _delta); \
+	if(_d > BW/4 || _d < -BW/4) { \
+		(_dir).dynamic.acc = MAX2(MIN2((_dir).dynamic.acc + 2 * _d, INT8_MAX), INT8_MIN); \
+	} \
+}
+#else
+#define _dir_recenter(_dir, _delta)			{ /* nothing to do */ }
+#endif
 /**
  * @macro _dir_adjust_remainder
  * @brief adjust direction array when termination is detected in the middle of the block
@@ -628,9 +781,29 @@ void gaba_aligned_free(
 #define _dir_windback(_dir) { \
 	(_dir).guided.ptr--; \
 }
+#define _dir_recenter(_dir, _delta)			{ /* nothing to do */ }
 
 #endif
 
+/**
+ * @fn dir_calc_center_offset
+ * @brief distance from the lane of the current max score (md + delta) to the center of
+ * the band, the middle of the lanes is taken on ties. positive if the max is on the right
+ * (lane 0) side.
+ */
+static _force_inline
+int32_t dir_calc_center_offset(
+	struct gaba_dp_context_s const *this,
+	vec_t delta)
+{
+	v32i16_t d = _add_v32i16(_load_v32i16(_last_block(&this->tail)->md), _cvt_v32i8_v32i16(delta));
+	uint64_t mask = ((vec_masku_t){
+		.mask = _mask_v32i16(_eq_v32i16(_set_v32i16(_hmax_v32i16(d)), d))
+	}).all;
+	int32_t q = (tzcnt(mask) + (63 - lzcnt(mask)))>>1;
+	return(BW/2 - 1 - q);
+}
+
 
 /**
  * @macro _match
@@ -698,8 +871,7 @@ static _force_inline
 void fill_load_section(
 	struct gaba_dp_context_s *this,
 	struct gaba_section_s const *a,
-	struct gaba_section_s const *b,
-	uint64_t plim)
+	struct gaba_section_s const *b)
 {
 	/* load current section lengths */
 	struct gaba_trans_section_s c = transpose_section_pair(
@@ -716,7 +888,6 @@ void fill_load_section(
 	_store_v2i64(&this->w.r.atail, c_tail);
 	_store_v2i32(&this->w.r.alen, c.len);
 	_store_v2i32(&this->w.r.aid, c.id);
-	this->w.r.plim = plim;
 
 	return;
 }
@@ -1050,6 +1221,89 @@ int32_t fill_gapless_filter(
 	return((cnt > this->tf) ? CONT : TERM);
 }
 
+/**
+ * @fn fill_calc_max
+ * @brief calculate the max score of a block from its max vector
+ */
+static _force_inline
+int64_t fill_calc_max(
+	struct gaba_dp_context_s const *this,
+	struct gaba_block_s const *blk)
+{
+	v32i16_t md = _load_v32i16(_last_block(&this->tail)->md);
+	v32i16_t sd = _cvt_v32i8_v32i16(_load(&blk->sd.max));
+	return(_hmax_v32i16(_add_v32i16(md, sd)) + blk->offset);
+}
+
+/**
+ * @fn fill_calc_max_mask
+ * @brief lanes of a block where the max score is reached
+ */
+static _force_inline
+uint32_t fill_calc_max_mask(
+	struct gaba_dp_context_s const *this,
+	struct gaba_block_s const *blk,
+	int64_t max)
+{
+	v32i16_t md = _load_v32i16(_last_block(&this->tail)->md);
+	v32i16_t sd = _cvt_v32i8_v32i16(_load(&blk->sd.max));
+	return(((vec_masku_t){
+		.mask = _mask_v32i16(_eq_v32i16(_set_v32i16(max - blk->offset), _add_v32i16(md, sd)))
+	}).all);
+}
+
+/**
+ * @fn fill_update_max_block
+ * @brief record the block if the max score is updated in it, called once per block
+ */
+static _force_inline
+void fill_update_max_block(
+	struct gaba_dp_context_s *this,
+	struct gaba_block_s const *blk)
+{
+	int64_t max = fill_calc_max(this, blk);
+	if(max > this->w.r.max) {
+		this->w.r.max = max;
+		this->w.r.mblk = blk;
+	}
+	return;
+}
+
+/**
+ * @fn tail_calc_pos
+ * @brief convert reverse indices on the sections of tail to positions, walking back to
+ * the previous sections if the indices exceed the current ones
+ */
+struct tail_pos_s {
+	uint32_t aid, bid;
+	uint32_t apos, bpos;
+};
+static _force_inline
+struct tail_pos_s tail_calc_pos(
+	struct gaba_joint_tail_s const *tail,
+	int32_t aridx,
+	int32_t bridx)
+{
+	struct gaba_joint_tail_s const *atail = tail, *btail = tail;
+	int32_t alen = atail->alen, blen = btail->blen;
+	int32_t aidx = alen - aridx, bidx = blen - bridx;
+
+	while(aidx <= 0) {
+		for(atail = atail->tail; (atail->stat & GABA_STATUS_UPDATE_A) == 0; atail = atail->tail) {}
+		aidx += (alen = atail->alen);
+	}
+	while(bidx <= 0) {
+		for(btail = btail->tail; (btail->stat & GABA_STATUS_UPDATE_B) == 0; btail = btail->tail) {}
+		bidx += (blen = btail->blen);
+	}
+	return((struct tail_pos_s){
+		.aid = atail->aid,
+		.bid = btail->bid,
+		.apos = aidx - 1,
+		.bpos = bidx - 1
+	});
+}
+
 /**
  * @fn fill_create_phantom_block
  * @brief create joint_head on the stack to start block extension
@@ -1075,9 +1329,15 @@ struct gaba_joint_block_s fill_create_phantom_block(
 	// _store(&blk->sd.max, _zero());
 	// _store(&blk->sd.max, _set(-128));
 
-	/* copy remaining */
+	/* copy remaining, shifting the band if requested */
 	blk->dir = pblk->dir;
+	blk->dir.dynamic.acc = MAX2(MIN2(blk->dir.dynamic.acc + this->bias, INT8_MAX), INT8_MIN);
 	blk->offset = pblk->offset;
+	this->bias = 0;
+
+	/* init max block tracker with the max carried over from the previous fragment */
+	this->w.r.max = fill_calc_max(this, pblk);
+	this->w.r.mblk = NULL;
 
 	/* calc ridx */
 	v2i32_t ridx = _sub_v2i32(
@@ -1085,6 +1345,12 @@ struct gaba_joint_block_s fill_create_phantom_block(
 		_load_v2i32(&prev_tail->apos));
 	_print_v2i32(ridx);
 
+	/* init fragment max tracker, carried over the intermediate tails (CONT) that split the fragment */
+	int64_t cont = prev_tail->tail != NULL && prev_tail->stat == CONT;
+	this->fmax = cont ? prev_tail->fmax : INT64_MIN;
+	this->fblk = cont ? prev_tail->fblk : NULL;
+	_store_v2i32(&this->abnd, _add_v2i32(ridx, _load_v2i32(&prev_tail->aroot)));
+
 	/* check if init fetch is needed */
 	if(prev_tail->psum >= 0) {
 		/* store index on the current section */
@@ -1103,9 +1369,9 @@ struct gaba_joint_block_s fill_create_phantom_block(
 		// return(fill_init_fetch(this, prev_tail, blk, ridx));
 		struct gaba_joint_block_s stat = fill_init_fetch(this, prev_tail, blk, ridx);
 
-		/* check if initial vector is filled */
+		/* check if initial vector is filled, terminate here if rejected by the ungapped prefilter */
 		if(prev_tail->psum + stat.p >= 0) {
-			stat.stat = fill_gapless_filter(this, stat.blk - 1, stat.stat);
+			stat.stat = (this->ur != 0) ? TERM : fill_gapless_filter(this, stat.blk - 1, stat.stat);
 		}
 		return(stat);
 	}
@@ -1142,7 +1408,8 @@ struct gaba_joint_tail_s *fill_create_tail(
 		p, prev_tail->psum, prev_tail->p, tail->psum, tail->p);
 	tail->ssum = prev_tail->ssum + 1;
 	tail->tail = prev_tail;					/* to treat tail chain as linked list */
-	tail->rem_len = 0;
+	tail->mblk = (this->w.r.mblk == NULL) ? 0 : blk - this->w.r.mblk;
+	tail->inner = 0;
 
 	/* search max section */
 	v32i16_t sd = _cvt_v32i8_v32i16(_load(&(blk - 1)->sd.max));
@@ -1155,6 +1422,10 @@ struct gaba_joint_tail_s *fill_create_tail(
 	int16_t max = _hmax_v32i16(md);
 	_print_v32i16(md);
 
+	/* lanes at the edges of the band where the max updated in this fragment sits */
+	tail->emask = (this->w.r.mblk == NULL) ? 0
+		: fill_calc_max_mask(this, this->w.r.mblk, this->w.r.max) & (0x01 | (0x01<<(BW - 1)));
+
 	/* store */
 	// tail->mask_max.mask = mask_max;
 	tail->max = max + (blk - 1)->offset;
@@ -1180,8 +1451,22 @@ struct gaba_joint_tail_s *fill_create_tail(
 	v2i32_t id = _load_v2i32(&this->w.r.aid);
 	_store_v2i32(&tail->aid, id);
 
-	/* store status */
-	tail->stat = stat | _mask_v2i32(_eq_v2i32(ridx, z));
+	/* store sequence pointers */
+	_store_v2i64(&tail->aend, _load_v2i64(&this->w.r.atail));
+
+	/* store status, intermediate tails (CONT) keep the edge only in emask */
+	stat |= _mask_v2i32(_eq_v2i32(ridx, z));
+	tail->stat = stat | ((stat != CONT && tail->emask != 0) ? GABA_STATUS_EDGE : 0);
+
+	/* max in this fragment, the position is resolved on the last tail of the fragment */
+	tail->fmax = this->fmax;
+	tail->fblk = this->fblk;
+	tail->faid = tail->aid; tail->fbid = tail->bid;
+	tail->fapos = tail->fbpos = 0;
+
+	/* lengths from the root, not capped on the intermediate tails to keep the bounds of the fragment */
+	v2i32_t root = _sub_v2i32(_load_v2i32(&this->abnd), ridx);
+	_store_v2i32(&tail->aroot, (tail->stat == CONT) ? root : _min_v2i32(root, _set_v2i32(BW)));
 	return(tail);
 }
 
@@ -1437,6 +1722,17 @@ int64_t fill_test_xdrop(
 	return(this->tx - blk->sd.max[BW/2]);
 }
 
+/**
+ * @fn fill_test_score_stop
+ * @brief returns negative if the max reached the target score
+ */
+static _force_inline
+int64_t fill_test_score_stop(
+	struct gaba_dp_context_s const *this)
+{
+	return(this->tc - this->w.r.max - 1);
+}
+
 /**
  * @fn fill_bulk_test_seq_bound
  * @brief returns negative if ij-bound (for the bulk fill) is invaded
@@ -1465,6 +1761,100 @@ int64_t fill_bulk_test_seq_bound(
 	((int64_t)aptr - (int64_t)alim) | ((int64_t)blim - (int64_t)bptr) \
 )
 
+/**
+ * @fn fill_search_block_max
+ * @brief refill the first len anti-diagonals of a block and find the first cell of the max,
+ * lanes outside the matrix (at or beyond the reverse indices abnd and bbnd) are skipped.
+ * max is INT64_MIN if no cell is on the matrix.
+ */
+struct fill_max_pos_s {
+	int64_t max;
+	int32_t aridx, bridx;
+};
+static _force_inline
+struct fill_max_pos_s fill_search_block_max(
+	struct gaba_dp_context_s *this,
+	struct gaba_block_s *blk,
+	int64_t len)
+{
+	static int16_t const lane[BW] __attribute__(( aligned(BW * sizeof(int16_t)) )) = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+	};
+	v32i16_t const q = _load_v32i16(lane);
+	v32i16_t const md = _load_v32i16(_last_block(&this->tail)->md);
+	int64_t const aofs = (int64_t)this->abnd - (blk - 1)->aridx, bofs = (int64_t)this->bbnd - (blk - 1)->bridx;
+
+	/* fetch from existing blocks */
+	fill_restore_fetch(this, blk);
+
+	struct fill_max_pos_s r = { .max = INT64_MIN };
+	int64_t acnt = 0, bcnt = 0;
+
+	/* vectors on registers inside this block */ {
+		_fill_load_context(blk);
+		(void)max;				/* to avoid warning */
+
+		for(int64_t i = 0; i < len; i++) {
+			_dir_fetch(dir);
+			if(_dir_is_right(dir)) {
+				_fill_right_update_ptr();
+				_fill_right();
+				acnt++;
+			} else {
+				_fill_down_update_ptr();
+				_fill_down();
+				bcnt++;
+			}
+
+			/* lane q is at (aridx + q - acnt, bridx + BW - 1 - q - bcnt), q < aofs + acnt and BW - 1 - q < bofs + bcnt */
+			v32i16_t valid = _and_v32i16(
+				_gt_v32i16(_set_v32i16(MIN2(aofs + acnt, BW)), q),
+				_gt_v32i16(q, _set_v32i16(MAX2(BW - 1 - (bofs + bcnt), -1))));
+			uint32_t vmask = ((vec_masku_t){ .mask = _mask_v32i16(valid) }).all;
+			if(vmask == 0) { continue; }
+
+			v32i16_t s = _add_v32i16(md, _cvt_v32i8_v32i16(delta));
+			s = _or_v32i16(_and_v32i16(valid, s), _andn_v32i16(valid, _set_v32i16(INT16_MIN)));
+			int16_t smax = _hmax_v32i16(s);
+			if(smax + offset <= r.max) { continue; }
+
+			uint32_t l = tzcnt(vmask & ((vec_masku_t){ .mask = _mask_v32i16(_eq_v32i16(_set_v32i16(smax), s)) }).all);
+			r = (struct fill_max_pos_s){
+				.max = smax + offset,
+				.aridx = (blk - 1)->aridx + l - acnt,
+				.bridx = (blk - 1)->bridx + (BW - 1 - l) - bcnt
+			};
+		}
+	}
+	return(r);
+}
+
+/**
+ * @fn fill_update_fragment_max
+ * @brief record the block if the fragment max is updated in it, called once per block with the
+ * lane maxes of the len anti-diagonals filled in it. blocks near the root, where the band may
+ * hold cells outside the matrix, are refilled to skip them.
+ */
+static _force_inline
+void fill_update_fragment_max(
+	struct gaba_dp_context_s *this,
+	struct gaba_block_s *blk,
+	vec_t bmax,
+	int64_t len)
+{
+	int64_t max = ((blk - 1)->aridx + BW > this->abnd || (blk - 1)->bridx + BW > this->bbnd)
+		? fill_search_block_max(this, blk, len).max
+		: _hmax_v32i16(_add_v32i16(
+			_load_v32i16(_last_block(&this->tail)->md),
+			_cvt_v32i8_v32i16(bmax))) + (blk - 1)->offset;
+	if(max > this->fmax) {
+		this->fmax = max;
+		this->fblk = blk;
+	}
+	return;
+}
+
 /**
  * @fn fill_bulk_block
  * @brief fill a block
@@ -1477,9 +1867,10 @@ void fill_bulk_block(
 	/* fetch sequence */
 	fill_bulk_fetch(this, blk);
 
-	/* load vectors onto registers */
+	/* load vectors onto registers, the max vector is reset to take the maxes in this block */
 	debug("blk(%p)", blk);
 	_fill_load_context(blk);
+	max = _set(INT8_MIN);
 	/**
 	 * @macro _fill_block
 	 * @brief an element of unrolled fill-in loop
@@ -1504,8 +1895,13 @@ void fill_bulk_block(
 		_fill_block(right, r2, d1);
 	}
 
+	/* merge the maxes in this block into the running max */
+	vec_t bmax = max;
+	max = _max(max, _load(&(blk - 1)->sd.max));
+
 	/* update seq offset */
 	_fill_update_offset();
+	_dir_recenter(dir, delta);
 
 	/* store vectors */
 	v2i32_t cnt = _fill_store_vectors(blk);
@@ -1513,6 +1909,10 @@ void fill_bulk_block(
 	/* update section */
 	fill_update_section(this, blk, cnt);
 
+	/* update max block and fragment max */
+	fill_update_max_block(this, blk);
+	fill_update_fragment_max(this, blk, bmax, BLK);
+
 	return;
 }
 
@@ -1529,10 +1929,13 @@ struct gaba_joint_block_s fill_bulk_predetd_blocks(
 	int32_t stat = CONT;
 	uint64_t bc = 0;
 	for(bc = 0; bc < blk_cnt; bc++) {
-		/* check xdrop termination */
+		/* check xdrop termination and the target score */
 		if(fill_test_xdrop(this, blk - 1) < 0) {
 			stat = TERM; break;
 		}
+		if(fill_test_score_stop(this) < 0) {
+			stat = STOP; break;
+		}
 
 		/* bulk fill */
 		debug("blk(%p)", blk);
@@ -1563,6 +1966,7 @@ struct gaba_joint_block_s fill_bulk_seq_bounded(
 	while(1) {
 		/* check termination */
 		if((fill_test_xdrop(this, blk - 1)
+		  | fill_test_score_stop(this)
 		  | fill_bulk_test_seq_bound(this, blk - 1)) < 0) {
 			break;
 		}
@@ -1575,6 +1979,7 @@ struct gaba_joint_block_s fill_bulk_seq_bounded(
 		p += BLK;
 	}
 	if(fill_test_xdrop(this, blk - 1) < 0) { stat = TERM; }
+	else if(fill_test_score_stop(this) < 0) { stat = STOP; }
 	return((struct gaba_joint_block_s){
 		.blk = blk,
 		.p = p,
@@ -1599,12 +2004,16 @@ struct gaba_joint_block_s fill_cap_seq_bounded(
 		if(fill_test_xdrop(this, blk - 1) < 0) {
 			stat = TERM; goto _fill_cap_seq_bounded_finish;
 		}
+		if(fill_test_score_stop(this) < 0) {
+			stat = STOP; goto _fill_cap_seq_bounded_finish;
+		}
 		/* fetch sequence */
 		fill_cap_fetch(this, blk);
 
 		/* vectors on registers inside this block */ {
 			_fill_cap_test_seq_bound_init(blk);
 			_fill_load_context(blk);
+			max = _set(INT8_MIN);	/* maxes in this block */
 
 			/* update diff vectors */
 			uint64_t i = 0;
@@ -1641,8 +2050,13 @@ struct gaba_joint_block_s fill_cap_seq_bounded(
 			/* adjust dir remainder */
 			_dir_adjust_remainder(dir, i);
 
+			/* merge the maxes in this block into the running max */
+			vec_t bmax = max;
+			max = _max(max, _load(&(blk - 1)->sd.max));
+
 			/* update seq offset */
 			_fill_update_offset();
+			_dir_recenter(dir, delta);
 			
 			/* store mask and vectors */
 			v2i32_t cnt = _fill_store_vectors(blk);
@@ -1650,6 +2064,10 @@ struct gaba_joint_block_s fill_cap_seq_bounded(
 			/* update section */
 			fill_update_section(this, blk, cnt);
 
+			/* update max block (not updated if no cell is filled) and fragment max */
+			fill_update_max_block(this, blk);
+			if(i != 0) { fill_update_fragment_max(this, blk, bmax, i); }
+
 			/* update block pointer and p-coordinate */
 			blk += (i != 0); p += i;
 
@@ -1731,6 +2149,32 @@ uint64_t calc_min_expected_blocks_tail(
 	return((p + p/2) / BLK);
 }
 
+/**
+ * @fn fill_locate_fragment_max
+ * @brief resolve the cell of the fragment max on the last tail of the fragment, refilling
+ * the block where it was first reached. the intermediate tails (CONT) only carry the block.
+ */
+static _force_inline
+struct gaba_joint_tail_s *fill_locate_fragment_max(
+	struct gaba_dp_context_s *this,
+	struct gaba_joint_tail_s *tail)
+{
+	if(tail->stat == CONT || tail->fblk == NULL) {
+		return(tail);
+	}
+
+	/* the last block may be filled partially, the blocks before the intermediate tails are not */
+	struct gaba_block_s *blk = (struct gaba_block_s *)tail->fblk;
+	int64_t len = (blk == _last_block(tail)) ? tail->p - (((tail->p - 1)>>BLK_BASE)<<BLK_BASE) : BLK;
+	struct fill_max_pos_s m = fill_search_block_max(this, blk, len);
+	debug("fmax(%lld), found(%lld), aridx(%d), bridx(%d)", tail->fmax, m.max, m.aridx, m.bridx);
+
+	struct tail_pos_s pos = tail_calc_pos(tail, m.aridx, m.bridx);
+	tail->faid = pos.aid; tail->fbid = pos.bid;
+	tail->fapos = pos.apos; tail->fbpos = pos.bpos;
+	return(tail);
+}
+
 /**
  * @fn fill_mem_bounded
  * @brief fill <blk_cnt> contiguous blocks without seq bound tests, adding head and tail
@@ -1743,11 +2187,13 @@ struct gaba_joint_tail_s *fill_mem_bounded(
 {
 	struct gaba_joint_block_s h = fill_create_phantom_block(this, prev_tail);
 	if(h.stat != CONT) {
-		return(fill_create_tail(this, prev_tail, h.blk, h.p, h.stat));
+		return(fill_locate_fragment_max(this,
+			fill_create_tail(this, prev_tail, h.blk, h.p, h.stat)));
 	}
 
 	struct gaba_joint_block_s b = fill_bulk_predetd_blocks(this, h.blk, blk_cnt);
-	return(fill_create_tail(this, prev_tail, b.blk, h.p + b.p, b.stat));
+	return(fill_locate_fragment_max(this,
+		fill_create_tail(this, prev_tail, b.blk, h.p + b.p, b.stat)));
 }
 
 /**
@@ -1789,7 +2235,8 @@ struct gaba_joint_tail_s *fill_seq_bounded(
 	psum += (stat = fill_cap_seq_bounded(this, stat.blk)).p;
 
 _fill_seq_bounded_finish:;
-	return(fill_create_tail(this, prev_tail, stat.blk, psum, stat.stat));
+	return(fill_locate_fragment_max(this,
+		fill_create_tail(this, prev_tail, stat.blk, psum, stat.stat)));
 }
 
 /**
@@ -1804,7 +2251,10 @@ struct gaba_joint_tail_s *fill_section_seq_bounded(
 	struct gaba_section_s const *b)
 {
 	/* init section and restore sequence reader buffer */
-	fill_load_section(this, a, b, INT64_MAX);
+	fill_load_section(this, a, b);
+
+	/* stop only when the target score is crossed in this fill, so that a stopped fill is resumable */
+	this->tc = (prev_tail->max < this->ts) ? this->ts : INT64_MAX;
 
 	/* init tail pointer */
 	struct gaba_joint_tail_s *tail = _tail(prev_tail);
@@ -1841,6 +2291,19 @@ struct gaba_joint_tail_s *fill_section_seq_bounded(
 		debug("mem_bulk_blocks(%llu), seq_bulk_blocks(%llu)", mem_bulk_blocks, seq_bulk_blocks);
 	}
 
+	/* checkpoints for the recentering refill, which restarts at the segment where the band hit an edge */
+	while(this->rc != 0 && calc_min_expected_blocks_tail(this, tail) > RECENTER_SEGMENT) {
+		/* a checkpoint costs a head block and a tail on top of the blocks */
+		while(calc_max_bulk_blocks_mem(this) < calc_max_expected_blocks_tail(this, tail) + 2) {
+			if(gaba_dp_add_stack(this, 0) != GABA_SUCCESS) {
+				return(NULL);
+			}
+		}
+		if((tail = fill_mem_bounded(this, tail, RECENTER_SEGMENT))->stat != CONT) {
+			return(tail);
+		}
+	}
+
 	debug("v(%p), psum(%lld), p(%d)", _last_block(tail)->md, tail->psum, tail->p);
 
 	/* bulk fill with seq bound check */
@@ -1848,89 +2311,437 @@ struct gaba_joint_tail_s *fill_section_seq_bounded(
 }
 
 /**
- * @fn gaba_dp_fill_root
- *
- * @brief build_root API
+ * @fn fill_section_recenter
+ * @brief refill from the head of the last segment where the max hit an edge of the band,
+ * with the band shifted toward that edge, returns the tail with the better max.
  */
-struct gaba_fill_s *suffix(gaba_dp_fill_root)(
+static _force_inline
+struct gaba_joint_tail_s *fill_section_recenter(
 	struct gaba_dp_context_s *this,
+	struct gaba_joint_tail_s const *prev_tail,
 	struct gaba_section_s const *a,
-	uint32_t apos,
 	struct gaba_section_s const *b,
-	uint32_t bpos)
+	struct gaba_joint_tail_s *tail)
 {
-	/* store section info */
-	this->tail.apos = apos;
-	this->tail.bpos = bpos;
-	return(_fill(fill_section_seq_bounded(this, &this->tail, a, b)));
+	if(this->rc == 0 || this->ur != 0 || tail == NULL) {
+		return(tail);
+	}
+
+	/* segments are delimited by the checkpoint tails, lane 0 is on the right (a-forward) side */
+	struct gaba_joint_tail_s const *seg = tail;
+	while(seg != prev_tail && seg->emask == 0) { seg = seg->tail; }
+	if(seg == prev_tail) {
+		return(tail);
+	}
+	debug("edge detected, emask(%x), head(%p)", seg->emask, seg->tail);
+
+	/* save stack pointers to discard the refill */
+	struct gaba_mem_block_s *mem = this->curr_mem;
+	uint8_t *stack_top = this->stack_top, *stack_end = this->stack_end;
+
+	this->bias = ((seg->emask & 0x01) != 0) ? this->rc : -this->rc;
+	struct gaba_joint_tail_s *retry = fill_section_seq_bounded(this, seg->tail, a, b);
+	if(retry != NULL && retry->max > tail->max) {
+		return(retry);
+	}
+	this->curr_mem = mem;
+	this->stack_top = stack_top;
+	this->stack_end = stack_end;
+	return(tail);
 }
 
 /**
- * @fn gaba_dp_fill
- *
- * @brief fill API
+ * @fn watchdog_timestamp
+ * @brief returns the current time in usec, zero if the watchdog is disabled
  */
-struct gaba_fill_s *suffix(gaba_dp_fill)(
-	struct gaba_dp_context_s *this,
-	struct gaba_fill_s const *prev_sec,
-	struct gaba_section_s const *a,
-	struct gaba_section_s const *b)
+static _force_inline
+uint64_t watchdog_timestamp(
+	struct gaba_dp_context_s const *this)
 {
-	struct gaba_joint_tail_s const *tail = _tail(prev_sec);
-	return(_fill(fill_section_seq_bounded(this, tail, a, b)));
-}
+	if(_likely(this->wd.path == NULL)) {
+		return(0);
+	}
 
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return((uint64_t)tv.tv_sec * 1000000 + tv.tv_usec);
+}
 
-/* trace leaf search functions */
 /**
- * @struct gaba_leaf_s
+ * @fn watchdog_dump_section
+ * @brief dump a section in a hex string (one base per char), mirrored sections
+ * are reverse-complemented back to the order that the fill functions read. a section
+ * identical to the one on the previous line of the same tag is dumped as "=".
  */
-struct gaba_leaf_s {
-	struct gaba_joint_tail_s const *tail;
-	struct gaba_block_s const *blk;
-	uint32_t aridx, bridx;
-	int32_t p, q;
-};
+static
+void watchdog_dump_section(
+	FILE *fp,
+	char tag,
+	uint32_t id,
+	uint8_t const *end,
+	uint32_t len,
+	uint32_t pos,
+	uint64_t same,
+	uint8_t const *lim)
+{
+	char const *hex = "0123456789abcdef";
+
+	fprintf(fp, "%c\t%u\t%u\t%u\t", tag, id, len, pos);
+	if(same) {
+		fputc('=', fp);
+	} else {
+		for(uint8_t const *p = end - len; p < end; p++) {
+			fputc(hex[fetch_char(p, lim) & 0x0f], fp);
+		}
+	}
+	fputc('\n', fp);
+	return;
+}
 
 /**
- * @fn leaf_load_max_mask
+ * @fn watchdog_dump_chain
+ * @brief dump the section pairs of the fill calls from the tail back to the root,
+ * internal tails (CONT) and those of gaba_dp_fill_end are skipped, the latter flagged
+ * on the chain line instead. the root positions go on the last pair.
  */
-struct leaf_max_mask_s {
-	vec_t max;
-	int64_t offset;
-	uint32_t mask_max;
-};
-static _force_inline
-struct leaf_max_mask_s leaf_load_max_mask(
-	struct gaba_dp_context_s *this,
+static
+void watchdog_dump_chain(
+	FILE *fp,
+	struct gaba_dp_context_s const *this,
 	struct gaba_joint_tail_s const *tail)
 {
-	struct gaba_block_s *blk = _last_block(tail);
+	uint64_t cnt = 0;
+	uint32_t apos = 0, bpos = 0;
+	for(struct gaba_joint_tail_s const *t = tail; t->tail != NULL; t = t->tail) {
+		cnt += t->stat != CONT && t->inner == 0;
+		if(t->tail->tail == NULL) { apos = t->rapos; bpos = t->rbpos; }
+	}
+	fprintf(fp, "chain\t%llu\t%u\n", (unsigned long long)cnt, (tail->tail != NULL) ? tail->inner : 0);
+
+	struct gaba_joint_tail_s const *prev = NULL;
+	for(struct gaba_joint_tail_s const *t = tail; t->tail != NULL; t = t->tail) {
+		if(t->stat == CONT || t->inner != 0) { continue; }
+		uint64_t root = --cnt == 0;
+		watchdog_dump_section(fp, 'a', t->aid, t->aend, t->alen, root ? apos : 0,
+			prev != NULL && prev->aid == t->aid && prev->aend == t->aend && prev->alen == t->alen,
+			this->w.r.alim);
+		watchdog_dump_section(fp, 'b', t->bid, t->bend, t->blen, root ? bpos : 0,
+			prev != NULL && prev->bid == t->bid && prev->bend == t->bend && prev->blen == t->blen,
+			this->w.r.blim);
+		prev = t;
+	}
+	return;
+}
 
-	debug("p(%d), psum(%lld), ssum(%d), offset(%lld)",
-		tail->p, tail->psum, tail->ssum, blk->offset);
+/**
+ * @fn watchdog_check
+ * @brief test the size and the elapsed time of a call against the thresholds,
+ * append a record of the call to the dump file if either exceeded.
+ *
+ * @detail
+ * record format (tab-separated, terminated with an empty line):
+ *   call <fill|fill_end|trace> <size> <usec>
+ *   params <m> <x> <gi> <ge> <xdrop> <filter_thresh> <mode> <ebonus> <recenter> <steer> <ungapped> <score_stop>
+ *   chain <cnt> <end>
+ *   a <id> <len> <pos> <hex string or "=">
+ *   b <id> <len> <pos> <hex string or "=">
+ *   ... (cnt pairs)
+ * size is the number of cells filled for a fill record and the path length for a
+ * trace record. a fill record holds the chain of the returned tail, whose first pair
+ * is the sections given to the call, a trace record holds the forward and then the
+ * reverse chain. end is nonzero if the chain is closed by gaba_dp_fill_end, whose fills
+ * on the margins are not listed. bench -r rebuilds the chains with fill_root, fill, and
+ * fill_end, and times the last of them or the trace.
+ */
+static
+void watchdog_check(
+	struct gaba_dp_context_s const *this,
+	char const *call,
+	uint64_t start,
+	uint64_t size,
+	struct gaba_joint_tail_s const *fw_tail,
+	struct gaba_joint_tail_s const *rv_tail)
+{
+	uint64_t usec = watchdog_timestamp(this) - start;
+	if((this->wd.cell_thresh == 0 || size <= this->wd.cell_thresh)
+	&& (this->wd.usec_thresh == 0 || usec <= this->wd.usec_thresh)) {
+		return;
+	}
 
-	/* load max vector, create mask */
-	vec_t max = _load(&blk->sd.max);
-	int64_t offset = blk->offset;
-	uint32_t mask_max = ((vec_masku_t){
-		.mask = _mask_v32i16(_eq_v32i16(
-			_set_v32i16(tail->max - offset),
-			_add_v32i16(_load_v32i16(_last_block(tail)->md), _cvt_v32i8_v32i16(max))))
-	}).all;
-	debug("mask_max(%x)", mask_max);
-	_print_v32i16(_set_v32i16(tail->max - offset));
-	_print_v32i16(_add_v32i16(_load_v32i16(_last_block(tail)->md), _cvt_v32i8_v32i16(max)));
+	FILE *fp = fopen(this->wd.path, "a");
+	if(fp == NULL) {
+		debug("failed to open watchdog dump file(%s)", this->wd.path);
+		return;
+	}
 
-	return((struct leaf_max_mask_s){
-		.max = max,
-		.offset = offset,
-		.mask_max = mask_max
-	});
+	/* scores are stored in negated form, linear gap penalty is in ge */
+	fprintf(fp, "call\t%s\t%llu\t%llu\n",
+		call, (unsigned long long)size, (unsigned long long)usec);
+	fprintf(fp, "params\t%d\t%d\t%d\t%d\t%d\t%u\t%u\t%d\t%d\t%d\t%u\t%lld\n",
+		this->m, -this->x, -this->gi, -this->ge, this->tx, this->tf,
+		this->mode, this->eb, this->rc, STEER, this->ut,
+		(long long)((this->ts == INT64_MAX) ? 0 : this->ts));
+	watchdog_dump_chain(fp, this, fw_tail);
+	if(rv_tail != NULL) {
+		watchdog_dump_chain(fp, this, rv_tail);
+	}
+	fputc('\n', fp);
+	fclose(fp);
+	return;
+}
+
+/**
+ * @fn gaba_dp_set_watchdog
+ *
+ * @brief enable slow-call capture, disable if params is NULL
+ */
+void suffix(gaba_dp_set_watchdog)(
+	struct gaba_dp_context_s *this,
+	struct gaba_watchdog_params_s const *params)
+{
+	this->wd = (struct gaba_watchdog_s){
+		.cell_thresh = (params == NULL) ? 0 : params->cell_thresh,
+		.usec_thresh = (params == NULL) ? 0 : params->usec_thresh,
+		.path = (params == NULL) ? NULL : params->path
+	};
+	return;
+}
+
+/* ungapped prefilter */
+/**
+ * @fn ungapped_load
+ * @brief load BW bases from ptr, reversed and complemented if ptr is in the mirrored space
+ */
+static _force_inline
+vec_t ungapped_load(
+	uint8_t const *ptr,
+	uint8_t const *lim)
+{
+	if(ptr < lim) {
+		return(_loadu(ptr));
+	}
+
+	static uint8_t const comp[16] __attribute__(( aligned(16) )) = {
+		0x00, 0x08, 0x04, 0x0c, 0x02, 0x0a, 0x06, 0x0e,
+		0x01, 0x09, 0x05, 0x0d, 0x03, 0x0b, 0x07, 0x0f
+	};
+	vec_t const cv = _from_v16i8(_load_v16i8(comp));
+	return(_shuf(cv, _swap(_loadu(_rev(ptr, lim) - (BW - 1)))));
+}
+
+/**
+ * @fn ungapped_extend
+ * @brief ungapped X-drop extension on a diagonal, BW bases at a time. runs of matches
+ * between mismatches are scored at once, and an all-match vector costs a single step.
+ */
+static _force_inline
+struct gaba_ungapped_s ungapped_extend(
+	struct gaba_dp_context_s const *this,
+	uint8_t const *ap,
+	uint8_t const *bp,
+	int64_t len,
+	int32_t diag)
+{
+	int64_t const m = this->m, x = this->x, tx = this->tx;
+	int64_t score = 0, max = 0, mlen = 0;
+
+	for(int64_t i = 0; i < len; i += BW) {
+		vec_t a = ungapped_load(ap + i, this->w.r.alim);
+		vec_t b = ungapped_load(bp + i, this->w.r.blim);
+
+		/* mismatches, and the lanes out of the sections */
+		int64_t rem = MIN2(len - i, BW);
+		uint64_t mask = ((vec_masku_t){ .mask = _mask(_eq(_and(a, b), _zero())) }).all;
+		mask |= 0xffffffffffffffffULL<<rem;
+
+		int64_t p = 0, q;
+		while((q = tzcnt(mask)) < rem) {
+			score += m * (q - p);
+			if(score > max) { max = score; mlen = i + q; }
+
+			score += x;
+			if(score < max - tx) {
+				return((struct gaba_ungapped_s){ .score = max, .len = mlen, .diag = diag });
+			}
+			p = q + 1;
+			mask &= mask - 1;
+		}
+		score += m * (rem - p);
+		if(score > max) { max = score; mlen = i + rem; }
+	}
+	return((struct gaba_ungapped_s){ .score = max, .len = mlen, .diag = diag });
+}
+
+/**
+ * @fn gaba_dp_ungapped
+ * @brief ungapped X-drop extension of a[apos..] and b[bpos..] on the seed diagonal and
+ * the two next to it (the diagonals the popcnt filter counts), returns the best.
+ */
+struct gaba_ungapped_s suffix(gaba_dp_ungapped)(
+	struct gaba_dp_context_s *this,
+	struct gaba_section_s const *a,
+	uint32_t apos,
+	struct gaba_section_s const *b,
+	uint32_t bpos)
+{
+	int64_t const m = a->len - MIN2(apos, a->len), n = b->len - MIN2(bpos, b->len);
+	uint8_t const *ap = a->base + apos, *bp = b->base + bpos;
+
+	struct gaba_ungapped_s r = ungapped_extend(this, ap, bp, MIN2(m, n), 0);
+	if(m > 0) {
+		struct gaba_ungapped_s s = ungapped_extend(this, ap + 1, bp, MIN2(m - 1, n), 1);
+		r = (s.score > r.score) ? s : r;
+	}
+	if(n > 0) {
+		struct gaba_ungapped_s s = ungapped_extend(this, ap, bp + 1, MIN2(m, n - 1), -1);
+		r = (s.score > r.score) ? s : r;
+	}
+	debug("score(%lld), len(%u), diag(%d)", r.score, r.len, r.diag);
+	return(r);
+}
+
+/**
+ * @fn gaba_dp_fill_root
+ *
+ * @brief build_root API
+ */
+struct gaba_fill_s *suffix(gaba_dp_fill_root)(
+	struct gaba_dp_context_s *this,
+	struct gaba_section_s const *a,
+	uint32_t apos,
+	struct gaba_section_s const *b,
+	uint32_t bpos)
+{
+	/* store section info */
+	this->tail.apos = apos;
+	this->tail.bpos = bpos;
+
+	uint64_t start = watchdog_timestamp(this);
+	if(this->ut != 0) {
+		this->ur = suffix(gaba_dp_ungapped)(this, a, apos, b, bpos).score < this->ut;
+	}
+	struct gaba_joint_tail_s *tail = fill_section_recenter(this, &this->tail, a, b,
+		fill_section_seq_bounded(this, &this->tail, a, b));
+	this->ur = 0;
+	if(_unlikely(this->wd.path != NULL) && tail != NULL) {
+		/* keep the root positions on the first tail of the extension */
+		struct gaba_joint_tail_s *t = tail;
+		while(t->tail != &this->tail) { t = _tail(t->tail); }
+		t->rapos = apos; t->rbpos = bpos;
+		watchdog_check(this, "fill", start,
+			(tail->psum - this->tail.psum) * BW, tail, NULL);
+	}
+	return(_fill(tail));
+}
+
+/**
+ * @fn gaba_dp_fill
+ *
+ * @brief fill API
+ */
+struct gaba_fill_s *suffix(gaba_dp_fill)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *prev_sec,
+	struct gaba_section_s const *a,
+	struct gaba_section_s const *b)
+{
+	struct gaba_joint_tail_s const *prev_tail = _tail(prev_sec);
+
+	uint64_t start = watchdog_timestamp(this);
+	struct gaba_joint_tail_s *tail = fill_section_recenter(this, prev_tail, a, b,
+		fill_section_seq_bounded(this, prev_tail, a, b));
+	if(_unlikely(this->wd.path != NULL) && tail != NULL) {
+		watchdog_check(this, "fill", start,
+			(tail->psum - prev_tail->psum) * BW, tail, NULL);
+	}
+	return(_fill(tail));
+}
+
+
+/* banded edit distance */
+#define EDIT_MAX_DIST				( 31 )		/* the band (2k+1 diagonals) is held in a 64bit word */
+
+/**
+ * @macro _edit_push
+ * @brief shift the match vectors one row down, putting a base (4bit encoded) on the bottom lane
+ */
+#define _edit_push(_pm, _c, _bottom) { \
+	(_pm)[0] = ((_pm)[0]>>1) | ((0ULL - (((_c)>>0) & 0x01)) & (_bottom)); \
+	(_pm)[1] = ((_pm)[1]>>1) | ((0ULL - (((_c)>>1) & 0x01)) & (_bottom)); \
+	(_pm)[2] = ((_pm)[2]>>1) | ((0ULL - (((_c)>>2) & 0x01)) & (_bottom)); \
+	(_pm)[3] = ((_pm)[3]>>1) | ((0ULL - (((_c)>>3) & 0x01)) & (_bottom)); \
+}
+
+/**
+ * @fn gaba_dp_edit_dist
+ * @brief unit-cost (Levenshtein) distance between a[apos..] and b[bpos..], bit-parallel
+ * diagonal band of the max_dist (<= 31) diagonals on each side. the band is shifted one row
+ * down per column of b, so lane r of column j holds row j - k + r. the cell on the diagonal
+ * of the two ends is traced along, and the fill stops as soon as it exceeds max_dist since
+ * the scores never decrease along a diagonal. returns max_dist + 1 if the distance exceeds
+ * max_dist.
+ */
+int64_t suffix(gaba_dp_edit_dist)(
+	struct gaba_dp_context_s *this,
+	struct gaba_section_s const *a,
+	uint32_t apos,
+	struct gaba_section_s const *b,
+	uint32_t bpos,
+	uint32_t max_dist)
+{
+	int64_t const k = MIN2(max_dist, EDIT_MAX_DIST);
+	int64_t const m = a->len - MIN2(apos, a->len), n = b->len - MIN2(bpos, b->len);
+	if(m - n > k || n - m > k) { return(k + 1); }
+
+	uint8_t const *ap = a->base + apos - 1, *bp = b->base + bpos - 1;	/* 1-origin */
+	uint8_t const *alim = this->w.r.alim, *blim = this->w.r.blim;
+	uint64_t const bottom = 0x01ULL<<(2 * k);
+
+	/* column 0: rows -k..k, virtual rows above the matrix keep D[i][j] = j - i */
+	uint64_t pm[4] = { 0 };
+	for(int64_t i = -k; i <= k; i++) {
+		uint8_t c = (i >= 1 && i <= m) ? fetch_char(ap + i, alim) : 0;
+		_edit_push(pm, c, bottom);
+	}
+	uint64_t vn = (0x02ULL<<k) - 1;				/* -1 on rows <= 0 */
+	uint64_t vp = ((bottom<<1) - 1) & ~vn;		/* +1 on rows >= 1 */
+
+	/* the diagonal of the two ends, starting at D[m - n][0] */
+	uint64_t const dmask = 0x01ULL<<(m - n + k);
+	int64_t score = (m > n) ? m - n : n - m;
+
+	for(int64_t j = 1; j <= n; j++) {
+		uint8_t ca = (j + k <= m) ? fetch_char(ap + j + k, alim) : 0;
+		_edit_push(pm, ca, bottom);
+
+		uint8_t cb = fetch_char(bp + j, blim);
+		uint64_t eq = (pm[0] & (0ULL - ((cb>>0) & 0x01)))
+			| (pm[1] & (0ULL - ((cb>>1) & 0x01)))
+			| (pm[2] & (0ULL - ((cb>>2) & 0x01)))
+			| (pm[3] & (0ULL - ((cb>>3) & 0x01)));
+
+		/* align the previous column to the rows of this column, +1 below the band */
+		uint64_t pv = (vp>>1) | bottom, mv = (vn>>1) & (bottom - 1);
+
+		uint64_t d0 = (((eq & pv) + pv) ^ pv) | eq | mv;
+		uint64_t hp = mv | ~(d0 | pv), hn = pv & d0;
+		hp = (hp<<1) | 0x01;					/* +1 above the band */
+		hn = hn<<1;
+		vp = hn | ~(d0 | hp);
+		vn = d0 & hp;
+
+		score += (d0 & dmask) == 0;
+		if(score > k) { return(k + 1); }
+	}
+	return(score);
 }
 
+
+/* trace leaf search functions */
 /**
- * @fn leaf_detect_max_block
+ * @fn leaf_load_max_block
+ * @brief load the block where the max was first reached (recorded in the fill),
+ * p is -1 if the max is in the phantom block.
  */
 struct leaf_max_block_s {
 	vec_t max;
@@ -1939,61 +2750,45 @@ struct leaf_max_block_s {
 	uint32_t mask_max;
 };
 static _force_inline
-struct leaf_max_block_s leaf_detect_max_block(
+struct leaf_max_block_s leaf_load_max_block(
 	struct gaba_dp_context_s *this,
-	struct gaba_joint_tail_s const *tail,
-	int64_t offset,
-	uint32_t mask_max,
-	vec_t max)
+	struct gaba_joint_tail_s const *tail)
 {
-	/* scan blocks backward */
-	struct gaba_block_s *blk = _last_block(tail);
-	int32_t p = -1;
-
-	/* b must be sined integer, in order to detect negative index. */
-	for(int32_t b = (tail->p - 1)>>BLK_BASE; b >= 0; b--, blk--) {
+	/* b must be signed integer, in order to detect the phantom block */
+	int32_t bcnt = (tail->p + BLK - 1)>>BLK_BASE;
+	int32_t b = (tail->mblk == 0) ? -1 : bcnt - (int32_t)tail->mblk;
+	struct gaba_block_s *blk = _last_block(tail) - (bcnt - 1 - b);
 
-		/* load the previous max vector and offset */
-		vec_t prev_max = _load(&(blk - 1)->sd.max);
-		int64_t prev_offset = (blk - 1)->offset;
+	debug("p(%d), psum(%lld), ssum(%d), mblk(%u), b(%d), blk(%p)",
+		tail->p, tail->psum, tail->ssum, tail->mblk, b, blk);
 
-		/* adjust offset */
-		max = _add(max, _set(offset - prev_offset));
-
-		/* take mask */
-		uint32_t prev_mask_max = mask_max & ((vec_masku_t){
-			.mask = _mask(_eq(prev_max, max))
-		}).all;
-
-		debug("scan block: b(%d), offset(%lld), mask_max(%u), prev_mask_max(%u)",
-			b, offset, mask_max, prev_mask_max);
-
-		if(prev_mask_max == 0) {
-			debug("block found: blk(%p), p(%d), mask_max(%u)", blk, b * BLK, mask_max);
-			p = b * BLK;
-			break;
-		}
+	/* load max vector, create mask */
+	vec_t max = _load(&blk->sd.max);
+	uint32_t mask_max = ((vec_masku_t){
+		.mask = _mask_v32i16(_eq_v32i16(
+			_set_v32i16(tail->max - blk->offset),
+			_add_v32i16(_load_v32i16(_last_block(tail)->md), _cvt_v32i8_v32i16(max))))
+	}).all;
+	debug("mask_max(%x)", mask_max);
 
-		/* windback a block */
-		max = prev_max;
-		offset = prev_offset;
-		mask_max = prev_mask_max;
+	/* adjust offset to the previous block, where refill starts from */
+	if(b >= 0) {
+		max = _add(max, _set(blk->offset - (blk - 1)->offset));
 	}
-
-	debug("loop break: blk(%p), p(%d), mask_max(%u)", blk, p, mask_max);
 	return((struct leaf_max_block_s){
 		.max = max,
 		.blk = blk,
-		.p = p,
+		.p = (b >= 0) ? b * BLK : -1,
 		.mask_max = mask_max
 	});
 }
 
 /**
  * @fn leaf_refill_block
+ * @brief refill a block recording positions where delta reaches max, returns the max vector
  */
 static _force_inline
-void leaf_refill_block(
+vec_t leaf_refill_block(
 	struct gaba_dp_context_s *this,
 	vec_masku_t *mask_max_ptr,
 	int64_t len,
@@ -2025,8 +2820,8 @@ void leaf_refill_block(
 		for(int64_t i = 0; i < len; i++) {
 			_fill_block_leaf(mask_max_ptr);
 		}
+		return(max);
 	}
-	return;
 }
 
 /**
@@ -2075,6 +2870,7 @@ void leaf_save_coordinates(
 {
 	leaf->tail = tail;
 	leaf->blk = blk;
+	leaf->score = tail->max;
 
 	/* calc ridx */
 	int64_t mask_idx = p & (BLK - 1);
@@ -2107,6 +2903,7 @@ void leaf_save_phantom_coordinates(
 {
 	leaf->tail = tail;
 	leaf->blk = blk;
+	leaf->score = tail->max;
 	_store_v2i32(&leaf->aridx, _zero_v2i32());
 	leaf->p = -1;
 	leaf->q = tzcnt(mask_max);
@@ -2122,12 +2919,13 @@ void leaf_search(
 	struct gaba_joint_tail_s const *tail,
 	struct gaba_leaf_s *leaf)
 {
-	/* load max vector and create mask */
-	struct leaf_max_mask_s m = leaf_load_max_mask(this, tail);
+	/* the max was not raised in this fragment, e.g. on the margins of gaba_dp_fill_end */
+	while(tail->mblk == 0 && tail->tail != NULL && tail->tail->tail != NULL && tail->tail->max == tail->max) {
+		tail = tail->tail;
+	}
 
-	/* search block */
-	struct leaf_max_block_s b = leaf_detect_max_block(
-		this, tail, m.offset, m.mask_max, m.max);
+	/* load block where the max was reached */
+	struct leaf_max_block_s b = leaf_load_max_block(this, tail);
 	debug("check p(%d)", b.p);
 	if(b.p == -1) {
 		leaf_save_phantom_coordinates(this, tail, leaf, b.blk, b.mask_max);
@@ -2149,113 +2947,559 @@ void leaf_search(
 }
 
 /**
- * @fn gaba_dp_search_max
+ * @fn leaf_refill_delta
+ * @brief refill the first len anti-diagonals of a block, returns the delta vector
  */
-struct gaba_pos_pair_s suffix(gaba_dp_search_max)(
+static _force_inline
+vec_t leaf_refill_delta(
 	struct gaba_dp_context_s *this,
-	struct gaba_fill_s const *tail)
+	int64_t len,
+	struct gaba_block_s *blk)
 {
-	struct gaba_leaf_s leaf;
-	leaf_search(this, _tail(tail), &leaf);
+	/* fetch from existing blocks */
+	fill_restore_fetch(this, blk);
 
-	struct gaba_joint_tail_s const *atail = _tail(tail), *btail = _tail(tail);
-	int32_t alen = atail->alen, blen = btail->blen;
-	int32_t aidx = alen - leaf.aridx, bidx = blen - leaf.bridx;
+	/* vectors on registers inside this block */ {
+		_fill_load_context(blk);
+		(void)max; (void)offset;	/* to avoid warning */
 
-	while(aidx <= 0) {
-		for(atail = atail->tail; (atail->stat & GABA_STATUS_UPDATE_A) == 0; atail = atail->tail) {}
-		aidx += (alen = atail->alen);
-	}
-	while(bidx <= 0) {
-		for(btail = btail->tail; (btail->stat & GABA_STATUS_UPDATE_B) == 0; btail = btail->tail) {}
-		bidx += (blen = btail->blen);
+		for(int64_t i = 0; i < len; i++) {
+			_dir_fetch(dir);
+			if(_dir_is_right(dir)) {
+				_fill_right_update_ptr();
+				_fill_right();
+			} else {
+				_fill_down_update_ptr();
+				_fill_down();
+			}
+		}
+		return(delta);
 	}
-	return((struct gaba_pos_pair_s){
-		.apos = aidx - 1,
-		.bpos = bidx - 1
-	});
 }
 
-/* path trace functions */
 /**
- * @fn trace_load_section_a, trace_load_section_b
+ * @fn leaf_search_cell
+ * @brief search the cell at reverse indices (aridx, bridx) on the sections of the fragment,
+ * returns 1 if found, 0 if the band has not reached the cell yet, and -1 if the band passed
+ * the cell without covering it.
  */
 static _force_inline
-void trace_load_section_a(
-	struct gaba_dp_context_s *this)
+int64_t leaf_search_cell(
+	struct gaba_dp_context_s *this,
+	struct gaba_joint_tail_s const *tail,
+	int32_t aridx,
+	int32_t bridx,
+	struct gaba_leaf_s *leaf)
 {
-	debug("load section a, idx(%d), len(%d)", this->w.l.aidx, this->w.l.atail->alen);
+	int32_t bcnt = (tail->p + BLK - 1)>>BLK_BASE;
+	for(int32_t b = bcnt - 1; b >= 0; b--) {
+		struct gaba_block_s *blk = _last_block(tail) - (bcnt - 1 - b);
+		int64_t len = MIN2(tail->p - b * BLK, BLK);
+
+		/* the anti-diagonal is determined by the sum of the indices */
+		int64_t i = (int64_t)(blk - 1)->aridx + (blk - 1)->bridx + BLK - 2 - aridx - bridx;
+		if(i >= len) { return(b == bcnt - 1 ? 0 : -1); }
+		if(i < 0) { continue; }
+
+		/* then the lane by the count of right moves */
+		int64_t acnt = i + 1 - _dir_bcnt(_dir_load(blk, i));
+		int64_t q = aridx - (blk - 1)->aridx + acnt;
+		debug("b(%d), i(%lld), q(%lld)", b, i, q);
+		if((uint64_t)q >= BW) { return(-1); }	/* out of the band */
+
+		leaf_save_coordinates(this, tail, leaf, blk, b * BLK + i, q);
+
+		/* score of the cell */
+		int8_t delta[BW];
+		_storeu(delta, leaf_refill_delta(this, i + 1, blk));
+		leaf->score = _last_block(tail)->md->delta[q] + delta[q] + (blk - 1)->offset;
+		return(1);
+	}
+	return(-1);
+}
 
-	/* load tail pointer (must be inited with leaf tail) */
-	struct gaba_joint_tail_s const *tail = this->w.l.atail;
-	int32_t len = tail->alen;
-	int32_t sum = len;
-	int32_t idx = this->w.l.aidx + len;
+/**
+ * @fn leaf_search_edge
+ * @brief search the best cell on the column at aridx and on the row at bridx, updates
+ * leaf if the cell scores better than leaf->score.
+ */
+static _force_inline
+void leaf_search_edge(
+	struct gaba_dp_context_s *this,
+	struct gaba_joint_tail_s const *tail,
+	int32_t aridx,
+	int32_t bridx,
+	struct gaba_leaf_s *leaf)
+{
+	int32_t bcnt = (tail->p + BLK - 1)>>BLK_BASE;
+	for(int32_t b = 0; b < bcnt; b++) {
+		struct gaba_block_s *blk = _last_block(tail) - (bcnt - 1 - b);
+		int64_t len = MIN2(tail->p - b * BLK, BLK);
+
+		/* skip blocks whose band does not cross the edges */
+		int32_t pa = (blk - 1)->aridx, pb = (blk - 1)->bridx;
+		int32_t bend = _dir_bcnt(_dir_load(blk, len - 1)), aend = len - bend;
+		if(aridx - pa >= BW || aridx - pa + aend < 0) {
+			if(pb + BLK - 1 - bridx < 0 || pb + BLK - 1 - bend - bridx >= BW) { continue; }
+		}
 
-	while(idx <= 0) {
-		for(tail = tail->tail; (tail->stat & GABA_STATUS_UPDATE_A) == 0; tail = tail->tail) {}
-		len = tail->alen; sum += len; idx += len;
-	}
+		/* refill the block, checking the lanes on the edges at each anti-diagonal */
+		fill_restore_fetch(this, blk);
+		_fill_load_context(blk);
+		(void)max;	/* to avoid warning */
 
-	/* reload finished, store section info */
-	// this->w.l.atail = tail->tail;
-	this->w.l.atail = tail;		/* fixme: is this correct?? */
-	this->w.l.alen = len;
-	this->w.l.aid = tail->aid;
-	this->w.l.asum = sum;
+		int8_t delta_arr[BW];
+		int32_t ac = 0, bc = 0;
+		for(int64_t i = 0; i < len; i++) {
+			_dir_fetch(dir);
+			if(_dir_is_right(dir)) {
+				_fill_right_update_ptr();
+				_fill_right();
+				ac++;
+			} else {
+				_fill_down_update_ptr();
+				_fill_down();
+				bc++;
+			}
 
-	this->w.l.aidx = idx;
-	this->w.l.asidx = idx;
+			/* lanes of the column and the row, out of the band if not in [0, BW) */
+			int64_t qa = aridx - pa + ac, qb = pb + BLK - 1 - bc - bridx;
+			int64_t q[2] = {
+				((uint64_t)qa < BW && pb + BLK - 1 - qa - bc >= bridx) ? qa : -1,
+				((uint64_t)qb < BW && pa + qb - ac >= aridx) ? qb : -1
+			};
+			if(q[0] < 0 && q[1] < 0) { continue; }
+
+			_storeu(delta_arr, delta);
+			for(int64_t j = 0; j < 2; j++) {
+				if(q[j] < 0) { continue; }
+				int64_t score = _last_block(tail)->md->delta[q[j]] + delta_arr[q[j]] + offset;
+				if(score <= leaf->score) { continue; }
+
+				leaf_save_coordinates(this, tail, leaf, blk, b * BLK + i, q[j]);
+				leaf->score = score;
+			}
+		}
+	}
 	return;
 }
-static _force_inline
-void trace_load_section_b(
-	struct gaba_dp_context_s *this)
+
+/**
+ * @fn gaba_dp_fill_end
+ * @brief fill the tail triangle, replacing exhausted sections with margins until the
+ * band passes the cell at the ends of the terminal sections. the best cell on the edges
+ * is taken as the end cell instead if it wins over the max with the end bonus.
+ */
+struct gaba_fill_s *suffix(gaba_dp_fill_end)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *prev_sec)
 {
-	debug("load section b, idx(%d), len(%d)", this->w.l.bidx, this->w.l.btail->blen);
+	/* all-mismatch margin, read with vector loads from both sides */
+	static uint8_t const margin[3 * BW] __attribute__(( aligned(BW) )) = { 0 };
+	uint32_t const upd[2] = { GABA_STATUS_UPDATE_A, GABA_STATUS_UPDATE_B };
+
+	struct gaba_joint_tail_s const *prev_tail = _tail(prev_sec);
+	uint64_t start = watchdog_timestamp(this);
+	struct gaba_section_s const m[2] = {
+		gaba_build_section(GABA_MARGIN_AID, margin + BW, BW),
+		gaba_build_section(GABA_MARGIN_BID, margin + BW, BW)
+	};
 
-	/* load tail pointer (must be inited with leaf tail) */
-	struct gaba_joint_tail_s const *tail = this->w.l.btail;
-	int32_t len = tail->blen;
-	int32_t sum = len;
-	int32_t idx = this->w.l.bidx + len;
+	/* the margins are read in the forward space, and their ids must not collide with the sections */
+	if(_unlikely(margin + 3 * BW > this->w.r.alim || margin + 3 * BW > this->w.r.blim)) {
+		debug("margin(%p) is not below lim(%p, %p)", margin, this->w.r.alim, this->w.r.blim);
+		return(NULL);
+	}
+	if(_unlikely(prev_tail->aid == GABA_MARGIN_AID || prev_tail->bid == GABA_MARGIN_BID)) {
+		debug("reserved section ids, aid(%u), bid(%u)", prev_tail->aid, prev_tail->bid);
+		return(NULL);
+	}
+	struct gaba_section_s s[2] = {
+		gaba_build_section(prev_tail->aid, prev_tail->aend - prev_tail->alen, prev_tail->alen),
+		gaba_build_section(prev_tail->bid, prev_tail->bend - prev_tail->blen, prev_tail->blen)
+	};
 
-	while(idx <= 0) {
-		for(tail = tail->tail; (tail->stat & GABA_STATUS_UPDATE_B) == 0; tail = tail->tail) {}
-		len = tail->blen; sum += len; idx += len;
+	/* the end cell may already be in the previous fragment */
+	struct gaba_leaf_s leaf, edge = { .score = INT64_MIN };
+	int32_t ridx[2] = { 0, 0 };		/* reverse indices of the end cell on the current sections */
+	int64_t found = leaf_search_cell(this, prev_tail, 0, 0, &leaf);
+	if(this->eb > 0) { leaf_search_edge(this, prev_tail, 0, 0, &edge); }
+
+	struct gaba_joint_tail_s *tail = NULL;
+	int64_t last = 0;
+	do {
+		last = 1;
+		for(int64_t i = 0; i < 2; i++) {
+			if((prev_tail->stat & upd[i]) != 0) { ridx[i] += BW; s[i] = m[i]; }
+			last &= s[i].id == m[i].id;
+		}
+
+		/* fill the next fragment, the new tail is not published yet */
+		tail = fill_section_recenter(this, prev_tail, &s[0], &s[1],
+			fill_section_seq_bounded(this, prev_tail, &s[0], &s[1]));
+		if(tail == NULL) { return(NULL); }
+		tail->inner = 1;
+		if(found == 0) { found = leaf_search_cell(this, tail, ridx[0], ridx[1], &leaf); }
+		if(this->eb > 0) { leaf_search_edge(this, tail, ridx[0], ridx[1], &edge); }
+		prev_tail = tail;
+
+		/* a fragment on both margins passes the triangle */
+	} while(found == 0 && last == 0 && (tail->stat & GABA_STATUS_TERM) == 0);
+
+	/* the end cell is fixed in the global mode, the bonus selects one on the edges otherwise */
+	if(this->mode != GABA_MODE_GLOBAL) {
+		found = edge.score != INT64_MIN && edge.score + this->eb >= tail->max;
+		leaf = edge;
 	}
 
-	/* reload finished, store section info */
-	// this->w.l.btail = tail->tail;
-	this->w.l.btail = tail;		/* fixme: is this correct?? */
-	this->w.l.blen = len;
-	this->w.l.bid = tail->bid;
-	this->w.l.bsum = sum;
+	/* record the end cell */
+	tail->stat |= GABA_STATUS_TERM | (found > 0 ? GABA_STATUS_END : 0);
+	tail->end = leaf;
+	if(_unlikely(this->wd.path != NULL)) {
+		watchdog_check(this, "fill_end", start,
+			(tail->psum - _tail(prev_sec)->psum) * BW, tail, NULL);
+	}
+	return(_fill(tail));
+}
 
-	this->w.l.bidx = idx;
-	this->w.l.bsidx = idx;
+/**
+ * @fn leaf_load
+ * @brief load the leaf where the traceback starts, the end cell on the fills by
+ * gaba_dp_fill_end or the max otherwise
+ */
+static _force_inline
+void leaf_load(
+	struct gaba_dp_context_s *this,
+	struct gaba_joint_tail_s const *tail,
+	struct gaba_leaf_s *leaf)
+{
+	if((tail->stat & GABA_STATUS_END) != 0) {
+		*leaf = tail->end;
+		return;
+	}
+	leaf_search(this, tail, leaf);
 	return;
 }
 
 /**
- * @macro _trace_*_load_context
- * @brief load context onto registers
+ * @fn leaf_calc_pos
+ * @brief convert leaf coordinates to positions on the sections
  */
-#define _trace_load_context(t) \
-	v2i32_t idx = _load_v2i32(&(t)->w.l.aidx), gc = _zero_v2i32(); \
-	v2i32_t const hterm = _seta_v2i32(-1, 0); \
-	v2i32_t const dterm = _seta_v2i32(0, 0); \
-	v2i32_t const vterm = _seta_v2i32(0, -1); \
-	_print_v2i32(hterm); \
-	_print_v2i32(dterm); \
-	_print_v2i32(vterm); \
-	struct gaba_block_s const *blk = (t)->w.l.blk; \
-	int64_t p = (t)->w.l.p, q = (t)->w.l.q; \
-	union gaba_dir_u dir = _dir_load(blk, p & (BLK - 1)); \
-	union gaba_mask_pair_u const *ptr = &blk->mask[p & (BLK - 1)]; \
-	_print_v2i32(idx); \
-	debug("p(%lld), q(%lld), mask_h(%x), mask_v(%x), path_array(%llx)", \
-		p, q, ptr->mask.h.all, ptr->mask.v.all, path_array);
+static _force_inline
+struct gaba_pos_pair_s leaf_calc_pos(
+	struct gaba_dp_context_s *this,
+	struct gaba_leaf_s const *leaf)
+{
+	struct tail_pos_s pos = tail_calc_pos(leaf->tail, leaf->aridx, leaf->bridx);
+	return((struct gaba_pos_pair_s){
+		.apos = pos.apos,
+		.bpos = pos.bpos
+	});
+}
+
+/**
+ * @fn gaba_dp_search_max
+ */
+struct gaba_pos_pair_s suffix(gaba_dp_search_max)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *tail)
+{
+	struct gaba_leaf_s leaf;
+	leaf_search(this, _tail(tail), &leaf);
+	return(leaf_calc_pos(this, &leaf));
+}
+
+/**
+ * @fn leaf_calc_snapshot
+ * @brief max score on the last anti-diagonal of the block
+ */
+static _force_inline
+int64_t leaf_calc_snapshot(
+	struct gaba_dp_context_s *this,
+	struct gaba_block_s const *blk)
+{
+	v32i16_t md = _load_v32i16(_last_block(&this->tail)->md);
+	v32i16_t sd = _cvt_v32i8_v32i16(_load(&blk->sd.delta));
+	return(_hmax_v32i16(_add_v32i16(md, sd)) + blk->offset);
+}
+
+/**
+ * @fn leaf_refine_block
+ * @brief detect the max cell inside the b-th block of the fragment, returns its score
+ */
+static _force_inline
+int64_t leaf_refine_block(
+	struct gaba_dp_context_s *this,
+	struct gaba_joint_tail_s const *tail,
+	int32_t b,
+	struct gaba_leaf_s *leaf)
+{
+	int32_t bcnt = (tail->p + BLK - 1)>>BLK_BASE;
+	struct gaba_block_s *blk = _last_block(tail) - (bcnt - 1 - b);
+	int64_t len = MIN2(tail->p - b * BLK, BLK);
+
+	/* first pass: max vector inside the block, in the offset of the previous block */
+	vec_masku_t mask_max_arr[BLK];
+	vec_t max = leaf_refill_block(this, mask_max_arr, len, blk, _set(-128));
+	v32i16_t smax = _add_v32i16(
+		_load_v32i16(_last_block(tail)->md),
+		_cvt_v32i8_v32i16(max));
+	int16_t hmax = _hmax_v32i16(smax);
+	uint32_t mask_max = ((vec_masku_t){
+		.mask = _mask_v32i16(_eq_v32i16(_set_v32i16(hmax), smax))
+	}).all;
+
+	/* second pass: detect pos */
+	leaf_refill_block(this, mask_max_arr, len, blk, max);
+	struct leaf_max_pos_s l = leaf_detect_max_pos(
+		this, mask_max_arr, len, mask_max);
+	leaf_save_coordinates(this, tail, leaf, blk, b * BLK + l.p, l.q);
+	leaf->score = hmax + (blk - 1)->offset;
+	debug("refined, b(%d), p(%d), q(%d), score(%lld)", b, leaf->p, leaf->q, leaf->score);
+	return(leaf->score);
+}
+
+/**
+ * @fn leaf_test_separation
+ * @brief returns nonzero if the leaf is at least min_dist away from all the leaves in the array
+ */
+static _force_inline
+int64_t leaf_test_separation(
+	struct gaba_leaf_s const *leaf,
+	struct gaba_max_s const *arr,
+	uint32_t cnt,
+	uint32_t min_dist)
+{
+	#define _gp(_l)		( (_l)->tail->psum - (_l)->tail->p + (_l)->p )
+	int64_t const dist = MAX2(min_dist, 1);
+	for(uint32_t i = 0; i < cnt; i++) {
+		struct gaba_leaf_s const *l = _leaf(&arr[i]);
+		int64_t dp = _gp(leaf) - _gp(l), dq = leaf->q - l->q;
+		if(MAX2(dp, -dp) < dist && MAX2(dq, -dq) < dist) {
+			return(0);
+		}
+	}
+	return(1);
+	#undef _gp
+}
+
+/**
+ * @struct leaf_cand_s
+ * @brief (internal) block whose score snapshot at the last anti-diagonal is a local maximum
+ */
+struct leaf_cand_s {
+	int64_t score;
+	struct gaba_joint_tail_s const *tail;
+	int32_t b, dead;
+};
+
+/**
+ * @fn leaf_search_topk
+ * @brief collect at most k well-separated maxima, the global max comes first.
+ */
+static _force_inline
+uint32_t leaf_search_topk(
+	struct gaba_dp_context_s *this,
+	struct gaba_joint_tail_s const *tail,
+	uint32_t k,
+	uint32_t min_dist,
+	struct gaba_max_s *arr)
+{
+	if(k == 0) { return(0); }
+
+	/* global max, searched on the fragment where it was reached */
+	struct gaba_joint_tail_s const *mtail = tail;
+	while(mtail->mblk == 0 && mtail->tail->tail != NULL && mtail->tail->max == mtail->max) {
+		mtail = mtail->tail;
+	}
+	leaf_search(this, mtail, _leaf(&arr[0]));
+	uint32_t cnt = 1;
+
+	/* malloc candidate array on the stack, rolled back on return */
+	uint64_t bsum = 0;
+	for(struct gaba_joint_tail_s const *t = tail; t->tail != NULL; t = t->tail) {
+		bsum += (t->p + BLK - 1)>>BLK_BASE;
+	}
+	struct gaba_mem_block_s *mem = this->curr_mem;
+	uint8_t *stack_top = this->stack_top, *stack_end = this->stack_end;
+	struct leaf_cand_s *cand = (struct leaf_cand_s *)gaba_dp_malloc(this,
+		sizeof(struct leaf_cand_s) * (bsum + 1));
+	if(cand == NULL) { return(cnt); }
+
+	/* collect local maxima of the snapshots, scanning blocks from the tail to the root */
+	uint64_t ccnt = 0;
+	struct leaf_cand_s c = { .score = INT64_MIN }, n = { .score = INT64_MIN };
+	for(struct gaba_joint_tail_s const *t = tail; t->tail != NULL; t = t->tail) {
+		int32_t bcnt = (t->p + BLK - 1)>>BLK_BASE;
+		struct gaba_block_s const *blk = _last_block(t);
+		for(int32_t b = bcnt - 1; b >= 0; b--, blk--) {
+			struct leaf_cand_s x = {
+				.score = leaf_calc_snapshot(this, blk),
+				.tail = t,
+				.b = b,
+				.dead = 0
+			};
+			if(c.score > n.score && c.score >= x.score) { cand[ccnt++] = c; }
+			n = c; c = x;
+		}
+	}
+	if(c.score > n.score) { cand[ccnt++] = c; }
+	debug("bsum(%llu), ccnt(%llu)", bsum, ccnt);
+
+	/* greedy selection */
+	while(cnt < k) {
+		struct leaf_cand_s *best = NULL;
+		for(uint64_t i = 0; i < ccnt; i++) {
+			if(cand[i].dead == 0 && (best == NULL || cand[i].score > best->score)) {
+				best = &cand[i];
+			}
+		}
+		if(best == NULL) { break; }
+		best->dead = 1;
+
+		/* the max cell is either in the block or in the next one */
+		struct gaba_leaf_s leaf, next;
+		leaf_refine_block(this, best->tail, best->b, &leaf);
+		if(best->b + 1 < (best->tail->p + BLK - 1)>>BLK_BASE
+		&& leaf_refine_block(this, best->tail, best->b + 1, &next) > leaf.score) {
+			leaf = next;
+		}
+
+		if(leaf_test_separation(&leaf, arr, cnt, min_dist)) {
+			*_leaf(&arr[cnt++]) = leaf;
+		}
+	}
+
+	/* roll back stack */
+	this->curr_mem = mem;
+	this->stack_top = stack_top;
+	this->stack_end = stack_end;
+
+	/* sort by score (insertion sort) */
+	for(uint32_t i = 1; i < cnt; i++) {
+		struct gaba_leaf_s t = *_leaf(&arr[i]);
+		uint32_t j = i;
+		for(; j > 0 && _leaf(&arr[j - 1])->score < t.score; j--) {
+			*_leaf(&arr[j]) = *_leaf(&arr[j - 1]);
+		}
+		*_leaf(&arr[j]) = t;
+	}
+	return(cnt);
+}
+
+/**
+ * @fn gaba_dp_search_topk
+ */
+uint32_t suffix(gaba_dp_search_topk)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *tail,
+	uint32_t k,
+	uint32_t min_dist,
+	struct gaba_max_s *max)
+{
+	uint32_t cnt = leaf_search_topk(this, _tail(tail), k, min_dist, max);
+	for(uint32_t i = 0; i < cnt; i++) {
+		struct gaba_pos_pair_s pos = leaf_calc_pos(this, _leaf(&max[i]));
+		max[i].apos = pos.apos;
+		max[i].bpos = pos.bpos;
+	}
+	return(cnt);
+}
+
+/* path trace functions */
+/**
+ * @fn trace_load_section_a, trace_load_section_b
+ */
+static _force_inline
+void trace_load_section_a(
+	struct gaba_dp_context_s *this)
+{
+	debug("load section a, idx(%d), len(%d)", this->w.l.aidx, this->w.l.atail->alen);
+
+	/* load tail pointer (must be inited with leaf tail) */
+	struct gaba_joint_tail_s const *tail = this->w.l.atail;
+	int32_t len = tail->alen;
+	int32_t sum = len;
+
+	/* on reload, step back to the previous section, keeping the lengths of the current one */
+	if(this->w.l.aid != (uint32_t)-1) {
+		for(tail = tail->tail; (tail->stat & GABA_STATUS_UPDATE_A) == 0; tail = tail->tail) {}
+		len = tail->alen;
+		sum = this->w.l.asum + len;
+	}
+	int32_t idx = this->w.l.aidx + len;
+
+	while(idx <= 0) {
+		for(tail = tail->tail; (tail->stat & GABA_STATUS_UPDATE_A) == 0; tail = tail->tail) {}
+		len = tail->alen; sum += len; idx += len;
+	}
+
+	/* reload finished, store section info */
+	// this->w.l.atail = tail->tail;
+	this->w.l.atail = tail;
+	this->w.l.alen = len;
+	this->w.l.aid = tail->aid;
+	this->w.l.asum = sum;
+
+	this->w.l.aidx = idx;
+	this->w.l.asidx = idx;
+	return;
+}
+static _force_inline
+void trace_load_section_b(
+	struct gaba_dp_context_s *this)
+{
+	debug("load section b, idx(%d), len(%d)", this->w.l.bidx, this->w.l.btail->blen);
+
+	/* load tail pointer (must be inited with leaf tail) */
+	struct gaba_joint_tail_s const *tail = this->w.l.btail;
+	int32_t len = tail->blen;
+	int32_t sum = len;
+
+	/* on reload, step back to the previous section, keeping the lengths of the current one */
+	if(this->w.l.bid != (uint32_t)-1) {
+		for(tail = tail->tail; (tail->stat & GABA_STATUS_UPDATE_B) == 0; tail = tail->tail) {}
+		len = tail->blen;
+		sum = this->w.l.bsum + len;
+	}
+	int32_t idx = this->w.l.bidx + len;
+
+	while(idx <= 0) {
+		for(tail = tail->tail; (tail->stat & GABA_STATUS_UPDATE_B) == 0; tail = tail->tail) {}
+		len = tail->blen; sum += len; idx += len;
+	}
+
+	/* reload finished, store section info */
+	// this->w.l.btail = tail->tail;
+	this->w.l.btail = tail;
+	this->w.l.blen = len;
+	this->w.l.bid = tail->bid;
+	this->w.l.bsum = sum;
+
+	this->w.l.bidx = idx;
+	this->w.l.bsidx = idx;
+	return;
+}
+
+/**
+ * @macro _trace_*_load_context
+ * @brief load context onto registers
+ */
+#define _trace_load_context(t) \
+	v2i32_t idx = _load_v2i32(&(t)->w.l.aidx), gc = _zero_v2i32(); \
+	v2i32_t const hterm = _seta_v2i32(-1, 0); \
+	v2i32_t const dterm = _seta_v2i32(0, 0); \
+	v2i32_t const vterm = _seta_v2i32(0, -1); \
+	_print_v2i32(hterm); \
+	_print_v2i32(dterm); \
+	_print_v2i32(vterm); \
+	struct gaba_block_s const *blk = (t)->w.l.blk; \
+	int64_t p = (t)->w.l.p, q = (t)->w.l.q; \
+	union gaba_dir_u dir = _dir_load(blk, p & (BLK - 1)); \
+	union gaba_mask_pair_u const *ptr = &blk->mask[p & (BLK - 1)]; \
+	_print_v2i32(idx); \
+	debug("p(%lld), q(%lld), mask_h(%x), mask_v(%x), path_array(%llx)", \
+		p, q, ptr->mask.h.all, ptr->mask.v.all, path_array);
 
 #define _trace_forward_load_context(t) \
 	uint32_t *path = (t)->w.l.path.phead; \
@@ -2270,12 +3514,26 @@ void trace_load_section_b(
 	_trace_load_context(t);
 
 
+/**
+ * @macro _trace_prefetch_block
+ * @brief prefetch the masks and the direction array of a block. the traceback walks the
+ * blocks backward, which the hardware prefetcher follows poorly on short sections.
+ */
+#define _trace_prefetch_block(_blk) { \
+	uint8_t const *_b = (uint8_t const *)(_blk); \
+	for(uint64_t _i = 0; _i < sizeof(((struct gaba_block_s *)0)->mask); _i += 64) { \
+		_prefetch(_b + _i); \
+	} \
+	_prefetch(&(_blk)->dir); \
+}
+
 /**
  * @macro _trace_reload_ptr
  */
 #define _trace_reload_ptr(_idx) { \
 	ptr = &(--blk)->mask[(_idx)]; \
 	dir = _dir_load(blk, (_idx)); \
+	_trace_prefetch_block(blk - 1); \
 }
 
 /**
@@ -2929,6 +4187,7 @@ void trace_init_work(
 
 	this->w.l.psum = tail->psum - tail->p + leaf->p;
 	this->w.l.pspos = 0;
+	this->w.l._pad1 = 0;				/* compared as a part of the walk state in gaba_dp_trace_tree */
 
 	/* save section info */
 	// this->w.l.path = *sec;
@@ -2948,14 +4207,243 @@ void trace_clean_work(
 	return;
 }
 
+/**
+ * @struct trace_join_s
+ * @brief (internal) walk state of a leaf before a fragment trace, with its path at the state
+ * and at the end of the trace. the walk from a state depends on nothing but the state, so
+ * another leaf reaching the same one follows the same path to the root.
+ */
+#define TRACE_JOIN_KEY_SIZE			( offsetof(struct gaba_writer_work_s, _pad4) - offsetof(struct gaba_writer_work_s, blk) )
+#define _trace_join_key(_w)			( (uint8_t const *)&(_w)->blk )
+#define _trace_join_hash(_w) ( \
+	(uint32_t)((((uint64_t)(uintptr_t)(_w)->blk + ((uint64_t)(_w)->p<<8) + (_w)->q) * 0x9e3779b97f4a7c15ULL)>>32) \
+)
+struct trace_join_s {
+	uint8_t key[TRACE_JOIN_KEY_SIZE];	/** (104) blk to btail of the work */
+	uint32_t leaf, hash;
+	struct gaba_path_intl_s s, e;		/** (96) path at the state, and at the end, on the kept copy */
+};
+
+/**
+ * @struct trace_join_table_s
+ * @brief (internal) states of the leaves traced so far, those of the current leaf from base.
+ * the states and the buckets (index + 1, open addressing) are on the dp stack.
+ */
+struct trace_join_table_s {
+	uint32_t cnt, base, size, mask;		/** states, capacity, and bucket mask */
+	struct trace_join_s *j;
+	uint32_t *bucket;
+	uint32_t leaf, ref;					/** current leaf, and the leaf it joined (leaf if none) */
+	uint64_t rv_done;					/** reverse path kept in rv, on the dp stack */
+	struct gaba_path_intl_s rv;
+};
+
+/**
+ * @fn trace_join_search
+ * @brief find the state of the work among those of the other leaves, -1 if not found
+ */
+static _force_inline
+int64_t trace_join_search(
+	struct gaba_dp_context_s const *this,
+	struct trace_join_table_s const *jt)
+{
+	if(jt->base == 0) { return(-1); }
+	for(uint32_t h = _trace_join_hash(&this->w.l) & jt->mask; jt->bucket[h] != 0; h = (h + 1) & jt->mask) {
+		struct trace_join_s const *j = &jt->j[jt->bucket[h] - 1];
+		if(memcmp(j->key, _trace_join_key(&this->w.l), TRACE_JOIN_KEY_SIZE) == 0) {
+			return(jt->bucket[h] - 1);
+		}
+	}
+	return(-1);
+}
+
+/**
+ * @fn trace_join_insert
+ */
+static _force_inline
+void trace_join_insert(
+	struct trace_join_table_s *jt,
+	uint32_t i)
+{
+	uint32_t h = jt->j[i].hash & jt->mask;
+	while(jt->bucket[h] != 0) { h = (h + 1) & jt->mask; }
+	jt->bucket[h] = i + 1;
+	return;
+}
+
+/**
+ * @fn trace_join_record
+ * @brief record the state of the work, dropped if the table failed to grow
+ */
+static _force_inline
+void trace_join_record(
+	struct gaba_dp_context_s *this,
+	struct trace_join_table_s *jt)
+{
+	if(jt->cnt >= jt->size) {
+		/* double the capacity, the old arrays are left on the stack until flush */
+		uint32_t size = MAX2(2 * jt->size, TRACE_JOIN_INIT);
+		struct trace_join_s *j = (struct trace_join_s *)gaba_dp_malloc(this,
+			sizeof(struct trace_join_s) * size + sizeof(uint32_t) * 2 * size);
+		if(j == NULL) { return; }
+		if(jt->cnt != 0) { memcpy(j, jt->j, sizeof(struct trace_join_s) * jt->cnt); }
+		jt->j = j;
+		jt->bucket = (uint32_t *)(j + size);
+		jt->size = size;
+		jt->mask = 2 * size - 1;
+		memset(jt->bucket, 0, sizeof(uint32_t) * 2 * size);
+		for(uint32_t i = 0; i < jt->base; i++) { trace_join_insert(jt, i); }
+	}
+	struct trace_join_s *j = &jt->j[jt->cnt++];
+	memcpy(j->key, _trace_join_key(&this->w.l), TRACE_JOIN_KEY_SIZE);
+	j->leaf = jt->leaf;
+	j->hash = _trace_join_hash(&this->w.l);
+	j->s = this->w.l.path;
+	return;
+}
+
+/**
+ * @fn trace_join_copy
+ * @brief prepend the rest of the forward path and sections of the joined leaf, walked from
+ * the state to the root, to those of the work. the forward path grows toward lower bits.
+ */
+static _force_inline
+void trace_join_copy(
+	struct gaba_dp_context_s *this,
+	struct trace_join_s const *j)
+{
+	struct gaba_path_intl_s *d = &this->w.l.path;
+
+	/* bits [spos, spos + len) of the joined path, placed at [dpos, dpos + len) relative to the head words */
+	int64_t spos = 32 * (j->e.phead - j->s.phead) + (32 - j->e.phofs);
+	int64_t len = (32 - j->s.phofs) - spos;
+	int64_t dpos = (32 - d->phofs) - len;
+	uint32_t const *src = j->s.phead;
+	uint32_t *dst = d->phead;
+	for(int64_t i = 0; i < len; i += 32) {
+		int64_t sp = spos + i, dp = dpos + i, n = MIN2(len - i, 32);
+		uint32_t const *sw = &src[sp>>5];
+		uint32_t *dw = &dst[dp>>5];
+		uint64_t v = (((uint64_t)sw[1]<<32) | sw[0])>>(sp & 31);
+		uint64_t mask = ((0x01ULL<<n) - 1)<<(dp & 31);
+		uint64_t w = ((uint64_t)dw[1]<<32) | dw[0];
+		w = (w & ~mask) | ((v<<(dp & 31)) & mask);
+		dw[0] = w; dw[1] = w>>32;
+	}
+	d->phead += ((dpos + 31)>>5) - 1;
+	d->phofs = (32 - (dpos & 31)) & 31;
+
+	/* sections, pushed toward lower addresses as well */
+	int64_t slen = j->s.shead - j->e.shead;
+	d->shead -= slen;
+	memcpy(d->shead, j->e.shead, sizeof(struct gaba_path_section_s) * slen);
+
+	/* gap counts of the rest */
+	d->gic += j->e.gic - j->s.gic;
+	d->gec += j->e.gec - j->s.gec;
+	debug("joined leaf(%u), len(%lld), slen(%lld)", j->leaf, len, slen);
+	return;
+}
+
+/**
+ * @fn trace_join_commit
+ * @brief make the states of the leaf searchable on success, or drop them on failure. the
+ * forward path and sections are copied to the dp stack, as those of the alignment are moved
+ * when the paths are concatenated.
+ */
+static _force_inline
+void trace_join_commit(
+	struct gaba_dp_context_s *this,
+	struct trace_join_table_s *jt,
+	struct gaba_path_intl_s const *fw,
+	int64_t failed)
+{
+	if(failed || jt->cnt == jt->base) {
+		jt->cnt = jt->base;
+		return;
+	}
+
+	/* the first state is at the head of the leaf, the bits are read in words [phead, phead + 2) */
+	struct gaba_path_intl_s const *s = &jt->j[jt->base].s;
+	int64_t plen = s->phead + 2 - fw->phead, slen = s->shead - fw->shead;
+	struct gaba_path_section_s *sec = (struct gaba_path_section_s *)gaba_dp_malloc(this,
+		sizeof(struct gaba_path_section_s) * slen + sizeof(uint32_t) * plen);
+	if(sec == NULL) {
+		jt->cnt = jt->base;
+		return;
+	}
+	uint32_t *path = (uint32_t *)(sec + slen);
+	memcpy(sec, fw->shead, sizeof(struct gaba_path_section_s) * slen);
+	memcpy(path, fw->phead, sizeof(uint32_t) * plen);
+
+	for(uint32_t i = jt->base; i < jt->cnt; i++) {
+		struct trace_join_s *j = &jt->j[i];
+		j->s.phead = path + (j->s.phead - fw->phead);
+		j->s.shead = sec + (j->s.shead - fw->shead);
+		j->e = *fw;
+		j->e.phead = path;
+		j->e.shead = sec;
+		trace_join_insert(jt, i);
+	}
+	jt->base = jt->cnt;
+	return;
+}
+
+/**
+ * @fn trace_copy_reverse
+ * @brief copy a reverse path into the arrays of another alignment
+ */
+static _force_inline
+void trace_copy_reverse(
+	struct gaba_path_intl_s *dst,
+	struct gaba_path_intl_s const *src)
+{
+	int64_t plen = src->ptail - src->phead, slen = src->stail - src->shead;
+	memcpy(dst->phead, src->phead, sizeof(uint32_t) * (plen + 2));
+	memcpy(dst->shead, src->shead, sizeof(struct gaba_path_section_s) * slen);
+	dst->ptail = dst->phead + plen;
+	dst->ptofs = src->ptofs;
+	dst->stail = dst->shead + slen;
+	dst->gic = src->gic;
+	dst->gec = src->gec;
+	return;
+}
+
+/**
+ * @fn trace_keep_reverse
+ * @brief keep a copy of the reverse path on the dp stack, as the arrays of the alignment are
+ * modified when the paths are concatenated. the reverse path is traced again on failure.
+ */
+static _force_inline
+void trace_keep_reverse(
+	struct gaba_dp_context_s *this,
+	struct trace_join_table_s *jt,
+	struct gaba_path_intl_s const *rv)
+{
+	int64_t plen = rv->ptail - rv->phead, slen = rv->stail - rv->shead;
+	struct gaba_path_section_s *sec = (struct gaba_path_section_s *)gaba_dp_malloc(this,
+		sizeof(struct gaba_path_section_s) * slen + sizeof(uint32_t) * (plen + 2));
+	if(sec == NULL) { return; }
+
+	jt->rv = (struct gaba_path_intl_s){
+		.phead = (uint32_t *)(sec + slen),
+		.shead = sec
+	};
+	trace_copy_reverse(&jt->rv, rv);
+	jt->rv_done = 1;
+	return;
+}
+
 /**
  * @fn trace_forward_generate_alignment, trace_reverse_generate_alignment
+ * @brief the forward trace joins the path of another leaf on the same state if jt is not NULL
  */
 static _force_inline
 int64_t trace_forward_generate_alignment(
 	struct gaba_dp_context_s *this,
 	struct gaba_leaf_s const *leaf,
-	struct gaba_path_intl_s *path)
+	struct gaba_path_intl_s *path,
+	struct trace_join_table_s *jt)
 {
 	trace_init_work(this, leaf, path);
 
@@ -2968,7 +4456,18 @@ int64_t trace_forward_generate_alignment(
 			trace_load_section_b(this);
 		}
 
-		/* fragment trace */
+		/* the rest is the same as that of the leaf found */
+		if(jt != NULL) {
+			int64_t k = trace_join_search(this, jt);
+			if(k >= 0) {
+				trace_join_copy(this, &jt->j[k]);
+				jt->ref = jt->j[k].leaf;
+				break;
+			}
+			trace_join_record(this, jt);
+		}
+
+		/* fragment trace */
 		trace_forward_body(this);
 		debug("p(%d), psum(%lld), q(%d)", this->w.l.p, this->w.l.psum, this->w.l.q);
 
@@ -3178,6 +4677,20 @@ struct trace_boundary_s trace_cat_section(
 	return(b);
 }
 
+/**
+ * @struct trace_origin_s
+ * @brief (internal) pairs of forward and reverse tails the sections of the alignment were
+ * traced on, placed right after the alignment object to locate the sequences afterward.
+ */
+struct trace_origin_s {
+	uint64_t cnt, _pad;
+	struct gaba_joint_tail_s const *tail[];
+};
+_static_assert(sizeof(struct trace_origin_s) == 16);
+#define _origin(_aln)				( (struct trace_origin_s *)((struct gaba_alignment_s *)(_aln) + 1) )
+#define _origin_size(_cnt)			( _roundup(sizeof(struct trace_origin_s) + 2 * (_cnt) * sizeof(struct gaba_joint_tail_s const *), 64) )
+#define _origin_end(_org)			( (void *)((uint8_t *)(_org) + _origin_size((_org)->cnt)) )
+
 /**
  * @struct gaba_result_s
  */
@@ -3187,16 +4700,21 @@ struct gaba_result_s {
 };
 
 /**
- * @fn trace_init_alignment
+ * @fn trace_calc_size
+ * @brief lengths of the section and path arrays, and the size of the result in bytes. the
+ * leaves are on the tails or their ancestors, so the size on the tails bounds the result.
+ * with GABA_TRACE_RLE in mode, the size includes the encoded path, placed after the path.
  */
+struct trace_size_s {
+	uint64_t sec_len, path_len, size;
+};
 static _force_inline
-struct gaba_result_s trace_init_alignment(
-	struct gaba_dp_context_s *this,
+struct trace_size_s trace_calc_size(
+	struct gaba_dp_context_s const *this,
 	struct gaba_joint_tail_s const *fw_tail,
 	struct gaba_joint_tail_s const *rv_tail,
-	struct gaba_trace_params_s const *params)
+	uint64_t mode)
 {
-	/* calculate array lengths */
 	uint64_t ssum = fw_tail->ssum + rv_tail->ssum;
 	uint64_t psum = _roundup(MAX2(fw_tail->psum, 1), 32)
 				  + _roundup(MAX2(rv_tail->psum, 1), 32);
@@ -3209,24 +4727,66 @@ struct gaba_result_s trace_init_alignment(
 	/* malloc pointer */
 	uint64_t sec_size = sizeof(struct gaba_path_section_s) * (sec_len + 1);
 	uint64_t path_size = sizeof(uint32_t) * (path_len + 4);
-	uint64_t size = sizeof(struct gaba_alignment_s) + path_size + sec_size
-			+ this->head_margin + this->tail_margin;
 
+	/* an operation takes a bit or more, and M at least two; D, I, and M in four bits at most */
+	uint64_t rle_size = (mode & GABA_TRACE_RLE)
+		? sizeof(struct gaba_path_rle_s) + sizeof(uint32_t) * (3 * psum / 4 + 2) + 8
+		: 0;
+	return((struct trace_size_s){
+		.sec_len = sec_len,
+		.path_len = path_len,
+		.size = sizeof(struct gaba_alignment_s) + _origin_size(1)
+			+ path_size + sec_size + rle_size + this->head_margin + this->tail_margin
+	});
+}
+
+/**
+ * @fn trace_init_alignment
+ */
+static _force_inline
+struct gaba_result_s trace_init_alignment(
+	struct gaba_dp_context_s *this,
+	struct gaba_leaf_s const *fw_leaf,
+	struct gaba_leaf_s const *rv_leaf,
+	struct gaba_trace_params_s const *params)
+{
+	struct gaba_joint_tail_s const *fw_tail = fw_leaf->tail;
+	struct gaba_joint_tail_s const *rv_tail = rv_leaf->tail;
+
+	/* calculate array lengths */
+	struct trace_size_s sz = trace_calc_size(this, fw_tail, rv_tail, 0);
+	uint64_t sec_len = sz.sec_len, path_len = sz.path_len, size = sz.size;
+
+	/* the caller's buffer, lmm, or the dp stack in this order */
 	lmm_t *lmm = (lmm_t *)params->lmm;
-	struct gaba_alignment_s *aln = (struct gaba_alignment_s *)(this->head_margin
-		+ (uintptr_t)((lmm == NULL) ? gaba_dp_malloc(this, size) : lmm_malloc(lmm, size)));
+	uint8_t *base;
+	if(params->buf != NULL) {
+		if(params->buf_size < size) {
+			return((struct gaba_result_s){ .aln = NULL });
+		}
+		base = (uint8_t *)params->buf;
+		lmm = NULL;
+	} else {
+		base = (uint8_t *)((lmm == NULL) ? gaba_dp_malloc(this, size) : lmm_malloc(lmm, size));
+	}
+	struct gaba_alignment_s *aln = (struct gaba_alignment_s *)(base + this->head_margin);
 	// struct gaba_alignment_s *aln = (struct gaba_alignment_s *)(this->head_margin + lmm_malloc(lmm, size));
 
 	debug("malloc trace mem(%p), lmm(%p), lim(%p)", aln, lmm, (lmm != NULL) ? lmm->lim : NULL);
 
 	aln->lmm = (void *)lmm;
-	aln->score = fw_tail->max + rv_tail->max + this->m * params->k;
+	aln->score = fw_leaf->score + rv_leaf->score + this->m * params->k;
 	// aln->reserved1 = sec_size;
 	// aln->reserved2 = path_size;
 	aln->reserved3 = this->head_margin;
+	aln->rle = NULL;
+	struct trace_origin_s *org = _origin(aln);
+	org->cnt = 1;
+	org->tail[0] = fw_tail;
+	org->tail[1] = rv_tail;
 
 	/* set pointers */
-	struct gaba_path_section_s *msec = (struct gaba_path_section_s *)(aln + 1);
+	struct gaba_path_section_s *msec = (struct gaba_path_section_s *)_origin_end(org);
 	struct gaba_path_intl_s rv = {
 		/* path arrays */
 		.phead = (uint32_t *)(msec + sec_len + 1) + 2,
@@ -3272,6 +4832,379 @@ struct gaba_result_s trace_init_alignment(
 	});
 }
 
+/**
+ * @fn parse_load_uint64
+ */
+static inline
+uint64_t parse_load_uint64(
+	uint64_t const *ptr,
+	int64_t pos)
+{
+	int64_t rem = pos & 63;
+	uint64_t a = (ptr[pos>>6]>>rem) | ((ptr[(pos>>6) + 1]<<(63 - rem))<<1);
+	debug("load arr(%llx)", a);
+	return(a);
+}
+
+/**
+ * @macro _parse_count_match_forward, _parse_count_gap_forward
+ */
+#define _parse_count_match_forward(_arr) ({ \
+	tzcnt((_arr) ^ 0x5555555555555555); \
+})
+#define _parse_count_gap_forward(_arr) ({ \
+	uint64_t _a = (_arr); \
+	uint64_t mask = 0ULL - (_a & 0x01); \
+	uint64_t gc = tzcnt(_a ^ mask) + (uint64_t)mask; \
+	debug("arr(%llx), mask(%llx), gc(%lld)", _a, mask, gc); \
+	gc; \
+})
+
+/**
+ * @fn parse_count_match_forward, parse_count_gap_forward
+ * @brief count a run from pos, clipped at rem. a run filling the whole window is followed
+ * on aligned words, against the diagonal pattern of the same phase or the gap bit.
+ */
+static _force_inline
+uint64_t parse_count_match_forward(
+	uint64_t const *p,
+	int64_t pos,
+	uint64_t rem,
+	uint64_t arr)
+{
+	uint64_t m = _parse_count_match_forward(arr);
+	if(m == 64 && rem >= 64) {
+		uint64_t const pat = 0x5555555555555555ULL<<(pos & 0x01);
+		uint64_t x, k = (pos + 64)>>6, kend = (pos + rem)>>6;
+		while((x = p[k] ^ pat) == 0 && k < kend) { k++; }
+		m = 64 * k + tzcnt(x) - pos;
+	}
+	return(MIN2(m, rem) & ~0x01);
+}
+static _force_inline
+uint64_t parse_count_gap_forward(
+	uint64_t const *p,
+	int64_t pos,
+	uint64_t rem,
+	uint64_t arr)
+{
+	uint64_t mask = 0ULL - (arr & 0x01);
+	uint64_t r = tzcnt(arr ^ mask);
+	if(r == 64 && rem >= 64) {
+		/* up to the bit next to the tail, which tells if the last one is a head of a diagonal */
+		uint64_t x, k = (pos + 64)>>6, kend = (pos + rem)>>6;
+		while((x = p[k] ^ mask) == 0 && k < kend) { k++; }
+		r = 64 * k + tzcnt(x) - pos;
+	}
+	/* the last bit of a run of ones is the head of the next diagonal */
+	return(MIN2(r + mask, rem));
+}
+
+/**
+ * @fn parse_decode_forward
+ * @brief decode the short runs in the lowest eight bits of arr, loaded at an operation
+ * boundary. the lowest byte is the number of operations, the next one the number of bits
+ * they span, and up to five operations follow from the third byte as len<<4 | op, where op
+ * is 0 (M), 1 (I), or 2 (D). operations whose end depends on the bits past the window are
+ * left out, so it is zero if the first run crosses the window.
+ */
+#define _parse_op_cnt(_t)			( (_t) & 0xff )
+#define _parse_op_len(_t)			( ((_t)>>8) & 0xff )
+#define _parse_op(_t, _k)			( ((_t)>>(8 * (_k) + 16)) & 0xff )
+#define _parse_op_char(_op)			( "MID"[(_op) & 0x03] )
+static _force_inline
+uint64_t parse_decode_forward(
+	uint64_t arr)
+{
+	/*
+	 * each byte decoded with the rules of parse_count_match_forward and parse_count_gap_forward
+	 * under all the continuations of the following bits, keeping the common operations
+	 */
+	static uint64_t const table[256] = {
+		0x0000000000000000ULL, 0x0000000000100201ULL, 0x0000000010120302ULL, 0x0000000010110302ULL,
+		0x0000000010220402ULL, 0x0000000000200401ULL, 0x0000001011120403ULL, 0x0000000010210402ULL,
+		0x0000000010320502ULL, 0x0000001012100503ULL, 0x0000000020120502ULL, 0x0000000020110502ULL,
+		0x0000001011220503ULL, 0x0000001011100503ULL, 0x0000001021120503ULL, 0x0000000010310502ULL,
+		0x0000000010420602ULL, 0x0000001022100603ULL, 0x0000101210120604ULL, 0x0000101210110604ULL,
+		0x0000000020220602ULL, 0x0000000000300601ULL, 0x0000002011120603ULL, 0x0000000020210602ULL,
+		0x0000001011320603ULL, 0x0000101112100604ULL, 0x0000101110120604ULL, 0x0000101110110604ULL,
+		0x0000001021220603ULL, 0x0000001021100603ULL, 0x0000001031120603ULL, 0x0000000010410602ULL,
+		0x0000000010520702ULL, 0x0000001032100703ULL, 0x0000102210120704ULL, 0x0000102210110704ULL,
+		0x0000101210220704ULL, 0x0000001012200703ULL, 0x0010121011120705ULL, 0x0000101210210704ULL,
+		0x0000000020320702ULL, 0x0000002012100703ULL, 0x0000000030120702ULL, 0x0000000030110702ULL,
+		0x0000002011220703ULL, 0x0000002011100703ULL, 0x0000002021120703ULL, 0x0000000020310702ULL,
+		0x0000001011420703ULL, 0x0000101122100704ULL, 0x0010111210120705ULL, 0x0010111210110705ULL,
+		0x0000101110220704ULL, 0x0000001011200703ULL, 0x0010111011120705ULL, 0x0000101110210704ULL,
+		0x0000001021320703ULL, 0x0000102112100704ULL, 0x0000102110120704ULL, 0x0000102110110704ULL,
+		0x0000001031220703ULL, 0x0000001031100703ULL, 0x0000001041120703ULL, 0x0000000010510702ULL,
+		0x0000000000620601ULL, 0x0000000042100602ULL, 0x0000003210120603ULL, 0x0000003210110603ULL,
+		0x0000002210220603ULL, 0x0000000022200602ULL, 0x0000221011120604ULL, 0x0000002210210603ULL,
+		0x0000001210320603ULL, 0x0000121012100604ULL, 0x0000001220120603ULL, 0x0000001220110603ULL,
+		0x0000121011220604ULL, 0x0000121011100604ULL, 0x0000121021120604ULL, 0x0000001210310603ULL,
+		0x0000000000420401ULL, 0x0000000022100402ULL, 0x0000001210120403ULL, 0x0000001210110403ULL,
+		0x0000000000220201ULL, 0x0000000000000000ULL, 0x0000000011120202ULL, 0x0000000000210201ULL,
+		0x0000000011320402ULL, 0x0000001112100403ULL, 0x0000001110120403ULL, 0x0000001110110403ULL,
+		0x0000000021220402ULL, 0x0000000021100402ULL, 0x0000000031120402ULL, 0x0000000000410401ULL,
+		0x0000000011520602ULL, 0x0000001132100603ULL, 0x0000112210120604ULL, 0x0000112210110604ULL,
+		0x0000111210220604ULL, 0x0000001112200603ULL, 0x0011121011120605ULL, 0x0000111210210604ULL,
+		0x0000001110320603ULL, 0x0000111012100604ULL, 0x0000001120120603ULL, 0x0000001120110603ULL,
+		0x0000111011220604ULL, 0x0000111011100604ULL, 0x0000111021120604ULL, 0x0000001110310603ULL,
+		0x0000000021420602ULL, 0x0000002122100603ULL, 0x0000211210120604ULL, 0x0000211210110604ULL,
+		0x0000002110220603ULL, 0x0000000021200602ULL, 0x0000211011120604ULL, 0x0000002110210603ULL,
+		0x0000000031320602ULL, 0x0000003112100603ULL, 0x0000003110120603ULL, 0x0000003110110603ULL,
+		0x0000000041220602ULL, 0x0000000041100602ULL, 0x0000000051120602ULL, 0x0000000000610601ULL,
+		0x0000000000720701ULL, 0x0000000052100702ULL, 0x0000004210120703ULL, 0x0000004210110703ULL,
+		0x0000003210220703ULL, 0x0000000032200702ULL, 0x0000321011120704ULL, 0x0000003210210703ULL,
+		0x0000002210320703ULL, 0x0000221012100704ULL, 0x0000002220120703ULL, 0x0000002220110703ULL,
+		0x0000221011220704ULL, 0x0000221011100704ULL, 0x0000221021120704ULL, 0x0000002210310703ULL,
+		0x0000001210420703ULL, 0x0000121022100704ULL, 0x0012101210120705ULL, 0x0012101210110705ULL,
+		0x0000001220220703ULL, 0x0000000012300702ULL, 0x0000122011120704ULL, 0x0000001220210703ULL,
+		0x0000121011320704ULL, 0x0012101112100705ULL, 0x0012101110120705ULL, 0x0012101110110705ULL,
+		0x0000121021220704ULL, 0x0000121021100704ULL, 0x0000121031120704ULL, 0x0000001210410703ULL,
+		0x0000000000520501ULL, 0x0000000032100502ULL, 0x0000002210120503ULL, 0x0000002210110503ULL,
+		0x0000001210220503ULL, 0x0000000012200502ULL, 0x0000121011120504ULL, 0x0000001210210503ULL,
+		0x0000000000320301ULL, 0x0000000012100302ULL, 0x0000000000120101ULL, 0x0000000000110101ULL,
+		0x0000000011220302ULL, 0x0000000011100302ULL, 0x0000000021120302ULL, 0x0000000000310301ULL,
+		0x0000000011420502ULL, 0x0000001122100503ULL, 0x0000111210120504ULL, 0x0000111210110504ULL,
+		0x0000001110220503ULL, 0x0000000011200502ULL, 0x0000111011120504ULL, 0x0000001110210503ULL,
+		0x0000000021320502ULL, 0x0000002112100503ULL, 0x0000002110120503ULL, 0x0000002110110503ULL,
+		0x0000000031220502ULL, 0x0000000031100502ULL, 0x0000000041120502ULL, 0x0000000000510501ULL,
+		0x0000000000620601ULL, 0x0000000042100602ULL, 0x0000003210120603ULL, 0x0000003210110603ULL,
+		0x0000002210220603ULL, 0x0000000022200602ULL, 0x0000221011120604ULL, 0x0000002210210603ULL,
+		0x0000001210320603ULL, 0x0000121012100604ULL, 0x0000001220120603ULL, 0x0000001220110603ULL,
+		0x0000121011220604ULL, 0x0000121011100604ULL, 0x0000121021120604ULL, 0x0000001210310603ULL,
+		0x0000000010420602ULL, 0x0000001022100603ULL, 0x0000101210120604ULL, 0x0000101210110604ULL,
+		0x0000000020220602ULL, 0x0000000000300601ULL, 0x0000002011120603ULL, 0x0000000020210602ULL,
+		0x0000001011320603ULL, 0x0000101112100604ULL, 0x0000101110120604ULL, 0x0000101110110604ULL,
+		0x0000001021220603ULL, 0x0000001021100603ULL, 0x0000001031120603ULL, 0x0000000010410602ULL,
+		0x0000000000520501ULL, 0x0000000032100502ULL, 0x0000002210120503ULL, 0x0000002210110503ULL,
+		0x0000001210220503ULL, 0x0000000012200502ULL, 0x0000121011120504ULL, 0x0000001210210503ULL,
+		0x0000000010320502ULL, 0x0000001012100503ULL, 0x0000000020120502ULL, 0x0000000020110502ULL,
+		0x0000001011220503ULL, 0x0000001011100503ULL, 0x0000001021120503ULL, 0x0000000010310502ULL,
+		0x0000000000420401ULL, 0x0000000022100402ULL, 0x0000001210120403ULL, 0x0000001210110403ULL,
+		0x0000000010220402ULL, 0x0000000000200401ULL, 0x0000001011120403ULL, 0x0000000010210402ULL,
+		0x0000000000320301ULL, 0x0000000012100302ULL, 0x0000000010120302ULL, 0x0000000010110302ULL,
+		0x0000000000220201ULL, 0x0000000000100201ULL, 0x0000000000120101ULL, 0x0000000000000000ULL
+	};
+	return(table[arr & 0xff]);
+}
+
+/**
+ * @macro BAM_CIGAR_*
+ * @brief operation codes of the BAM binary cigar, op_len<<4 | op
+ */
+#define BAM_CIGAR_M				( 0 )
+#define BAM_CIGAR_I				( 1 )
+#define BAM_CIGAR_D				( 2 )
+#define BAM_CIGAR_SHIFT			( 4 )
+
+/**
+ * @fn parse_dump_bam_forward
+ * @brief store BAM cigar to [*pb, blim), returns the length of the path left unparsed
+ * (zero when the whole path is stored)
+ */
+static _force_inline
+uint64_t parse_dump_bam_forward(
+	uint32_t **pb,
+	uint32_t const *blim,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	uint32_t *b = *pb;
+
+	/* convert path to uint64_t pointer */
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	uint64_t lim = offset + (((uint64_t)path & sizeof(uint32_t)) ? 32 : 0) + len;
+	uint64_t ridx = len, rem = 0, tbl = 1;
+
+	while(1) {
+		uint64_t arr = parse_load_uint64(p, lim - ridx), t;
+
+		/* short mixed runs, a byte of the path at a time; the table never leaves ridx <= 1 */
+		if(tbl && ridx > 8 && blim - b >= 5 && (t = parse_decode_forward(arr)) != 0) {
+			for(uint64_t k = 0; k < _parse_op_cnt(t); k++) { *b++ = _parse_op(t, k); }
+			ridx -= _parse_op_len(t);
+			continue;
+		}
+
+		uint64_t rsidx = ridx;
+		ridx -= parse_count_match_forward(p, lim - ridx, ridx, arr);
+		uint64_t m = (rsidx - ridx)>>1;
+		tbl = m < 4;					/* skip the table while the matches are longer than the window */
+		if(m > 0) {
+			if(b >= blim) { rem = rsidx; break; }
+			*b++ = (m<<BAM_CIGAR_SHIFT) | BAM_CIGAR_M;
+		}
+		if(ridx == 0) { break; }
+
+		arr = parse_load_uint64(p, lim - ridx);
+		uint64_t g = parse_count_gap_forward(p, lim - ridx, ridx, arr);
+		if(g > 0) {
+			if(b >= blim) { rem = ridx; break; }
+			*b++ = (g<<BAM_CIGAR_SHIFT) | (BAM_CIGAR_D - (arr & 0x01));
+		}
+		if((ridx -= g) <= 1) { break; }
+	}
+	*pb = b;
+	return(rem);
+}
+
+/**
+ * @struct rescore_acc_s
+ */
+struct rescore_acc_s {
+	int64_t mcnt, xcnt;
+	int64_t gicnt, gecnt[2];			/* gap bases on a (right) and on b (down) */
+	int64_t acnt, ucnt;					/* columns with an ambiguous base, and those not located */
+	int64_t prev;						/* 0 after a diagonal, 1 + direction after a gap */
+	int64_t pend;						/* the down half of a diagonal split at the end of the last section */
+	uint8_t const *pb;					/* its b base, NULL if not located */
+};
+
+/**
+ * @fn rescore_locate_seq
+ * @brief head of the section in the forward coordinate, the reverse-complemented one is
+ * located with the id flipped
+ */
+static _force_inline
+uint8_t const *rescore_locate_seq(
+	struct gaba_section_s const *sec,
+	uint32_t slen,
+	uint32_t id,
+	uint8_t const *lim)
+{
+	struct gaba_section_s const *rev = NULL;
+	for(uint32_t i = 0; i < slen; i++) {
+		if(sec[i].id == id) { return(sec[i].base); }
+		rev = (sec[i].id == (id ^ 0x01)) ? &sec[i] : rev;
+	}
+	return((rev == NULL) ? NULL : (uint8_t const *)_rev(rev->base + rev->len - 1, lim));
+}
+
+/**
+ * @fn rescore_count_column
+ * @brief count matches, mismatches, and ambiguous matches between a[0..len) and b[0..len),
+ * BW bases at a time. a column is ambiguous if either base is not a single one of ACGT.
+ */
+static _force_inline
+void rescore_count_column(
+	struct gaba_dp_context_s const *this,
+	uint8_t const *ap,
+	uint8_t const *bp,
+	int64_t len,
+	struct rescore_acc_s *acc)
+{
+	static uint8_t const amb[16] __attribute__(( aligned(16) )) = {
+		0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x01, 0x01,
+		0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01
+	};
+	vec_t const av = _from_v16i8(_load_v16i8(amb));
+	for(int64_t i = 0; i < len; i += BW) {
+		vec_t a = ungapped_load(ap + i, this->w.r.alim);
+		vec_t b = ungapped_load(bp + i, this->w.r.blim);
+		uint64_t valid = 0xffffffffffffffffULL>>(64 - MIN2(len - i, BW));
+		uint64_t xmask = ((vec_masku_t){ .mask = _mask(_eq(_match(a, b), _zero())) }).all;
+		uint64_t nmask = ((vec_masku_t){ .mask = _mask(_eq(_or(_shuf(av, a), _shuf(av, b)), _zero())) }).all;
+		int64_t x = popcnt(xmask & valid), n = popcnt(~(xmask | nmask) & valid);
+		acc->mcnt += popcnt(valid) - x - n;
+		acc->xcnt += x;
+		acc->acnt += n;
+	}
+	return;
+}
+
+/**
+ * @fn rescore_walk_diag
+ * @brief count len diagonal columns, not compared if either sequence is not located
+ */
+static _force_inline
+void rescore_walk_diag(
+	struct gaba_dp_context_s const *this,
+	uint8_t const *ap,
+	uint8_t const *bp,
+	int64_t len,
+	struct rescore_acc_s *acc)
+{
+	if(ap == NULL || bp == NULL) {
+		acc->ucnt += len;
+	} else {
+		rescore_count_column(this, ap, bp, len, acc);
+	}
+	acc->prev = 0;
+	return;
+}
+
+/**
+ * @fn rescore_close_pend
+ * @brief count the pending down half as a gap if no right half follows
+ */
+static _force_inline
+void rescore_close_pend(
+	struct rescore_acc_s *acc)
+{
+	acc->gicnt += acc->prev != 2;
+	acc->gecnt[1]++;
+	acc->prev = 2;
+	return;
+}
+
+/**
+ * @fn rescore_walk_section
+ * @brief count matches, mismatches, and gaps on [spos, epos) of the path, where a section of
+ * the alignment lies. runs of diagonals are compared at once. a diagonal split at the end of
+ * the section is left pending in acc and closed with the head of the next section.
+ */
+static _force_inline
+void rescore_walk_section(
+	struct gaba_dp_context_s const *this,
+	uint64_t const *p,
+	int64_t spos,
+	int64_t epos,
+	uint8_t const *ap,
+	uint8_t const *bp,
+	struct rescore_acc_s *acc)
+{
+	int64_t idx[2] = { 0, 0 };
+	int64_t i = spos;
+
+	/* the right half of the diagonal split at the end of the last section */
+	if(acc->pend != 0 && i < epos && (parse_load_uint64(p, i) & 0x01) == 0) {
+		rescore_walk_diag(this, (acc->pb == NULL) ? NULL : ap, acc->pb, 1, acc);
+		idx[0]++; i++;
+	} else if(acc->pend != 0) {
+		rescore_close_pend(acc);
+	}
+	acc->pend = 0;
+
+	for(; i < epos;) {
+		uint64_t arr = parse_load_uint64(p, i);
+		int64_t d = MIN2((int64_t)_parse_count_match_forward(arr), epos - i) & ~0x01;
+		if(d > 0) {
+			rescore_walk_diag(this,
+				(ap == NULL) ? NULL : ap + idx[0], (bp == NULL) ? NULL : bp + idx[1], d>>1, acc);
+			idx[0] += d>>1; idx[1] += d>>1;
+			i += d;
+			continue;
+		}
+
+		/* gap, down (1) consumes b, right (0) consumes a */
+		int64_t g = MIN2((int64_t)_parse_count_gap_forward(arr), epos - i), dir = arr & 0x01;
+		if(g <= 0) {
+			/* down of a diagonal split at the end of the section */
+			acc->pend = 1;
+			acc->pb = (bp == NULL) ? NULL : bp + idx[1];
+			idx[1]++; i++;
+			continue;
+		}
+		acc->gicnt += acc->prev != dir + 1;
+		acc->gecnt[dir] += g;
+		idx[dir] += g;
+		acc->prev = dir + 1; i += g;
+	}
+	return;
+}
+
 /**
  * @fn trace_refine_alignment
  */
@@ -3335,1527 +5268,3927 @@ struct gaba_alignment_s *trace_refine_alignment(
 	aln->sec = rv.shead;
 	aln->path = trace_finalize_path(rv);
 
-	/* calc mismatche count */
-	int64_t m = this->m, x = this->x, gi = this->gi, ge = this->ge;
-	int64_t gic = fw.gic + rv.gic;
-	int64_t gec = fw.gec + rv.gec;
-	aln->xcnt =
-		(m * ((aln->path->len - gec)>>1) + gi * gic + ge * gec - aln->score)
-		/ (m - x);
-	aln->gicnt = gic;
-	aln->gecnt = gec;
-	debug("plen(%lld), gic(%lld), gec(%lld), dcnt(%lld), xcnt(%lld)",
-		aln->path->len, gic, gec, (aln->path->len - gec)>>1, aln->xcnt);
-
+	/* mismatch and gap counts are filled by trace_calc_stats */
 	return(aln);
 }
 
 /**
- * @fn gaba_dp_trace
+ * @fn trace_locate_seq
+ * @brief locate the head of the sequence of a path section in the forward coordinate,
+ * returns NULL for sections not on the tail chains (seeds). sections filled in the
+ * reverse direction are found with their ids flipped.
  */
-struct gaba_alignment_s *suffix(gaba_dp_trace)(
-	struct gaba_dp_context_s *this,
-	struct gaba_fill_s const *fw_tail,
-	struct gaba_fill_s const *rv_tail,
-	struct gaba_trace_params_s const *params)
+static _force_inline
+uint8_t const *trace_locate_seq(
+	struct gaba_joint_tail_s const *fw_tail,
+	struct gaba_joint_tail_s const *rv_tail,
+	uint32_t id,
+	uint64_t b,							/* 0 for a, 1 for b */
+	uint8_t const *lim)
 {
-	/* substitute tail if NULL */
-	fw_tail = (fw_tail == NULL) ? _fill(&this->tail) : fw_tail;
-	rv_tail = (rv_tail == NULL) ? _fill(&this->tail) : rv_tail;
-
-	/* restore default params if NULL */
-	struct gaba_trace_params_s const default_params = {
-		.lmm = NULL,
-		.sec = NULL,
-		.slen = 0,
-		.k = 0
-	};
-	params = (params == NULL) ? &default_params : params;
-
-	/* search */
-	struct gaba_leaf_s fw_leaf, rv_leaf;
-	leaf_search(this, _tail(fw_tail), &fw_leaf);
-	leaf_search(this, _tail(rv_tail), &rv_leaf);
-
-	/* create alignment object */
-	struct gaba_result_s res = trace_init_alignment(this,
-		_tail(fw_tail), _tail(rv_tail), params);
-
-	/* generate paths, may fail when path got lost out of the band */
-	if(trace_forward_generate_alignment(this, &fw_leaf, &res.fw) < 0
-	|| trace_reverse_generate_alignment(this, &rv_leaf, &res.rv) < 0) {
-		lmm_t *lmm = (lmm_t *)params->lmm;
-		lmm_free(lmm, (void *)((uint8_t *)res.aln - this->head_margin));
-		return(NULL);
+	for(struct gaba_joint_tail_s const *t = fw_tail; t->tail != NULL; t = t->tail) {
+		if((&t->aid)[b] == id) { return((&t->aend)[b] - (&t->alen)[b]); }
 	}
-
-	/* concatenate paths */
-	return(trace_refine_alignment(this, res.aln, res.rv, res.fw, params));
+	for(struct gaba_joint_tail_s const *t = rv_tail; t->tail != NULL; t = t->tail) {
+		if((&t->aid)[b] == (id ^ 0x01)) { return((uint8_t const *)_rev((&t->aend)[b] - 1, lim)); }
+	}
+	return(NULL);
 }
 
 /**
- * @fn gaba_dp_recombine
+ * @fn trace_origin_locate
+ * @brief locate the head of the sequence of a path section on the tails of the origin
  */
-struct gaba_alignment_s *suffix(gaba_dp_recombine)(
-	struct gaba_dp_context_s *this,
-	struct gaba_alignment_s *x,
-	uint32_t xsid,
-	struct gaba_alignment_s *y,
-	uint32_t ysid)
+static _force_inline
+uint8_t const *trace_origin_locate(
+	struct trace_origin_s const *org,
+	uint32_t id,
+	uint64_t b,
+	uint8_t const *lim)
 {
-	debug("recombine called, x(%p, %lld), a(%u, %u), b(%u, %u), y(%p, %lld), a(%u, %u), b(%u, %u)",
-		x, x->score, x->sec[0].apos, x->sec[0].alen, x->sec[0].bpos, x->sec[0].blen,
-		y, y->score, y->sec[0].apos, y->sec[0].alen, y->sec[0].bpos, y->sec[0].blen);
+	for(uint64_t i = 0; i < org->cnt; i++) {
+		uint8_t const *p = trace_locate_seq(org->tail[2 * i], org->tail[2 * i + 1], id, b, lim);
+		if(p != NULL) { return(p); }
+	}
+	return(NULL);
+}
 
-	gaba_dp_res_free(y);
-	return(x);
+/**
+ * @fn rescore_locate_aln_seq
+ * @brief head of the sequence of id on side b (0 for a, 1 for b), located on sec if not
+ * NULL, or on the tails the alignment was traced on otherwise
+ */
+static _force_inline
+uint8_t const *rescore_locate_aln_seq(
+	struct gaba_dp_context_s const *this,
+	struct gaba_alignment_s const *aln,
+	struct gaba_section_s const *sec,
+	uint32_t slen,
+	uint32_t id,
+	uint32_t b)
+{
+	uint8_t const *lim = (b == 0) ? this->w.r.alim : this->w.r.blim;
+	return((sec == NULL)
+		? trace_origin_locate(_origin(aln), id, b, lim)
+		: rescore_locate_seq(sec, slen, id, lim));
 }
 
 /**
- * @fn gaba_dp_res_free
+ * @fn rescore_walk_alignment
+ * @brief count matches, mismatches, and gaps of the alignment on the sequences, located on
+ * sec if not NULL, or on the tails the alignment was traced on otherwise
  */
-void suffix(gaba_dp_res_free)(
-	struct gaba_alignment_s *aln)
+static _force_inline
+struct rescore_acc_s rescore_walk_alignment(
+	struct gaba_dp_context_s const *this,
+	struct gaba_alignment_s const *aln,
+	struct gaba_section_s const *sec,
+	uint32_t slen)
 {
-	if(aln->lmm != NULL) {
-		lmm_t *lmm = (lmm_t *)aln->lmm;
-		debug("free mem, ptr(%p), lmm(%p)", (void *)aln - aln->reserved3, lmm);
-		lmm_free(lmm, (void *)((uint8_t *)aln - aln->reserved3));
+	/* convert path to uint64_t pointer, as the cigar parsers do */
+	uint32_t const *path = aln->path->array;
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	int64_t ofs = ((uint64_t)path & sizeof(uint32_t)) ? 32 : 0;
+
+	struct rescore_acc_s acc = { 0 };
+	for(uint32_t i = 0; i < aln->slen; i++) {
+		struct gaba_path_section_s const *s = &aln->sec[i];
+		uint8_t const *ap = rescore_locate_aln_seq(this, aln, sec, slen, s->aid, 0);
+		uint8_t const *bp = rescore_locate_aln_seq(this, aln, sec, slen, s->bid, 1);
+		/* a section may start a few bases before the head of its sequence (apos or bpos is negative) */
+		rescore_walk_section(this, p, ofs + s->ppos, ofs + s->ppos + _plen(s),
+			(ap == NULL) ? NULL : ap + (int32_t)s->apos, (bp == NULL) ? NULL : bp + (int32_t)s->bpos, &acc);
 	}
-	return;
+	if(acc.pend != 0) { rescore_close_pend(&acc); }
+	debug("mcnt(%lld), xcnt(%lld), acnt(%lld), ucnt(%lld), gicnt(%lld), gecnt(%lld, %lld)",
+		acc.mcnt, acc.xcnt, acc.acnt, acc.ucnt, acc.gicnt, acc.gecnt[0], acc.gecnt[1]);
+	return(acc);
 }
 
 /**
- * @fn parse_load_uint64
+ * @fn trace_calc_stats
+ * @brief exact match, mismatch, and gap counts of the alignment, instead of estimating the
+ * mismatches from the score. returns the score under the scores of the context.
  */
-static inline
-uint64_t parse_load_uint64(
-	uint64_t const *ptr,
-	int64_t pos)
+static _force_inline
+int64_t trace_calc_stats(
+	struct gaba_dp_context_s const *this,
+	struct gaba_alignment_s *aln)
 {
-	int64_t rem = pos & 63;
-	uint64_t a = (ptr[pos>>6]>>rem) | ((ptr[(pos>>6) + 1]<<(63 - rem))<<1);
-	debug("load arr(%llx)", a);
-	return(a);
+	struct rescore_acc_s acc = rescore_walk_alignment(this, aln, NULL, 0);
+	aln->xcnt = acc.xcnt;
+	aln->gicnt = acc.gicnt;
+	aln->gecnt = acc.gecnt[0] + acc.gecnt[1];
+	aln->mcnt = acc.mcnt;
+	aln->icnt = acc.gecnt[1];		/* down, b only */
+	aln->dcnt = acc.gecnt[0];
+	aln->nm = acc.xcnt + acc.gecnt[0] + acc.gecnt[1];
+	aln->acnt = acc.acnt;
+	aln->ucnt = acc.ucnt;
+
+	/* ambiguous columns match under the fill; those not located are scored as matches like seeds */
+	return(this->m * (acc.mcnt + acc.acnt + acc.ucnt) + this->x * acc.xcnt
+		+ this->gi * acc.gicnt + this->ge * aln->gecnt);
+}
+
+/**
+ * @struct trace_cursor_s
+ * @brief walks the path of an alignment on the sequences, accumulating the score, the
+ * mismatch count, the gap open count, and the gap base count in acc.
+ */
+struct trace_cursor_s {
+	struct gaba_path_section_s const *sec;
+	struct trace_origin_s const *org;
+	uint32_t const *path;
+	uint8_t const *lim[2], *base[2];
+	int64_t slen, plen, ppos, prev;		/* prev: 0 after a diagonal, 1 + direction after a gap */
+	int64_t sidx[2], idx[2];			/* section cursors, a and b are advanced independently */
+	int64_t acc[4];
+};
+
+/**
+ * @fn trace_cursor_init
+ */
+static _force_inline
+struct trace_cursor_s trace_cursor_init(
+	struct gaba_dp_context_s const *this,
+	struct gaba_alignment_s const *aln)
+{
+	return((struct trace_cursor_s){
+		.sec = aln->sec,
+		.org = _origin(aln),
+		.path = aln->path->array,
+		.lim = { this->w.l.alim, this->w.l.blim },
+		.base = { NULL, NULL },
+		.slen = aln->slen,
+		.plen = aln->path->len,
+		.ppos = 0,
+		.prev = 0,
+		.sidx = { -1, -1 },
+		.idx = { 0, 0 },
+		.acc = { 0 }
+	});
 }
 
 /**
- * @fn parse_dump_match_string
+ * @fn trace_cursor_fetch
+ * @brief fetch the next base on a (b == 0) or b (b == 1), wildcard if not located
  */
 static _force_inline
-int64_t parse_dump_match_string(
-	char *buf,
-	int64_t len)
+uint8_t trace_cursor_fetch(
+	struct trace_cursor_s *c,
+	uint64_t b)
 {
-	if(len < 64) {
-		static uint8_t const conv[64] = {
-			0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
-			0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
-			0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
-			0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
-			0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
-			0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
-			0x60, 0x61, 0x62, 0x63
-		};
-		char *p = buf;
-		*p = (conv[len]>>4) + '0'; p += (conv[len] & 0xf0) != 0;
-		*p++ = (conv[len] & 0x0f) + '0';
-		*p++ = 'M';
-		return(p - buf);
-	} else {
-		int64_t adv;
-		uint8_t b[16] = { 'M', '0' }, *p = &b[1];
-		while(len != 0) { *p++ = (len % 10) + '0'; len /= 10; }
-		for(p -= (p != &b[1]), adv = (int64_t)((ptrdiff_t)(p - b)) + 1; p >= b; p--) { *buf++ = *p; }
-		return(adv);
+	while(c->sidx[b] < c->slen && (c->sidx[b] < 0 || c->idx[b] >= (&c->sec[c->sidx[b]].alen)[b])) {
+		if(++c->sidx[b] < c->slen) {
+			c->base[b] = trace_origin_locate(c->org, (&c->sec[c->sidx[b]].aid)[b], b, c->lim[b]);
+			c->idx[b] = 0;
+		}
 	}
+	uint8_t const *p = (c->sidx[b] < c->slen && c->base[b] != NULL)
+		? c->base[b] + (&c->sec[c->sidx[b]].apos)[b] + c->idx[b] : NULL;
+	c->idx[b]++;
+	return((p == NULL) ? 0x0f : fetch_char(p, c->lim[b]));
 }
 
 /**
- * @fn parse_dump_gap_string
+ * @fn trace_cursor_step
+ * @brief advance the cursor by a diagonal or a gap
  */
 static _force_inline
-int64_t parse_dump_gap_string(
-	char *buf,
-	int64_t len,
-	char ch)
+void trace_cursor_step(
+	struct gaba_dp_context_s const *this,
+	struct trace_cursor_s *c)
 {
-	if(len < 64) {
-		static uint8_t const conv[64] = {
-			0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
-			0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
-			0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
-			0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
-			0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
-			0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
-			0x60, 0x61, 0x62, 0x63
-		};
-		char *p = buf;
-		*p = (conv[len]>>4) + '0'; p += (conv[len] & 0xf0) != 0;
-		*p++ = (conv[len] & 0x0f) + '0';
-		*p++ = ch;
-		return(p - buf);
+	int64_t i = c->ppos;
+	uint32_t const *path = c->path;
+	if(i + 1 < c->plen && ((path[i>>5]>>(i & 31)) & 0x01) != 0 && ((path[(i + 1)>>5]>>((i + 1) & 31)) & 0x01) == 0) {
+		/* diagonal, b then a */
+		uint8_t cb = trace_cursor_fetch(c, 1), ca = trace_cursor_fetch(c, 0);
+		int64_t match = (ca & cb) != 0;
+		c->acc[0] += match ? this->m : this->x;
+		c->acc[1] += 1 - match;
+		c->prev = 0; c->ppos += 2;
 	} else {
-		int64_t adv;
-		uint8_t b[16] = { ch, '0' }, *p = &b[1];
-		while(len != 0) { *p++ = (len % 10) + '0'; len /= 10; }
-		for(p -= (p != &b[1]), adv = (int64_t)((ptrdiff_t)(p - b)) + 1; p >= b; p--) { *buf++ = *p; }
-		return(adv);
+		/* gap, down (1) consumes b, right (0) consumes a */
+		int64_t d = (path[i>>5]>>(i & 31)) & 0x01;
+		trace_cursor_fetch(c, d);
+		int64_t open = c->prev != d + 1;
+		c->acc[0] += this->ge + (open ? this->gi : 0);
+		c->acc[2] += open;
+		c->acc[3]++;
+		c->prev = d + 1; c->ppos++;
 	}
+	return;
 }
 
 /**
- * @macro _parse_count_match_forward, _parse_count_gap_forward
- */
-#define _parse_count_match_forward(_arr) ({ \
-	tzcnt((_arr) ^ 0x5555555555555555); \
-})
-#define _parse_count_gap_forward(_arr) ({ \
-	uint64_t _a = (_arr); \
-	uint64_t mask = 0ULL - (_a & 0x01); \
-	uint64_t gc = tzcnt(_a ^ mask) + (uint64_t)mask; \
-	debug("arr(%llx), mask(%llx), gc(%lld)", _a, mask, gc); \
-	gc; \
-})
-
-/**
- * @fn gaba_dp_print_cigar_forward
- * @brief parse path string and print cigar to file
+ * @fn trace_count_path
+ * @brief count down (b) and right (a) steps in [spos, epos) of the path
  */
-uint64_t suffix(gaba_dp_print_cigar_forward)(
-	gaba_dp_printer_t printer,
-	void *fp,
+static _force_inline
+v2i32_t trace_count_path(
 	uint32_t const *path,
-	uint32_t offset,
-	uint32_t len)
+	int64_t spos,
+	int64_t epos)
 {
-	uint64_t clen = 0;
-
-	/* convert path to uint64_t pointer */
-	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
-	uint64_t lim = offset + (((uint64_t)path & sizeof(uint32_t)) ? 32 : 0) + len;
-	uint64_t ridx = len;
-
-	debug("path(%p), lim(%lld), ridx(%lld), mod(%lld)", p, lim, ridx, ridx % 64);
-
-	while(1) {
-		uint64_t rsidx = ridx;
-		while(1) {
-			uint64_t m = _parse_count_match_forward(parse_load_uint64(p, lim - ridx));
-			uint64_t a = MIN2(m, ridx) & ~0x01;
-			ridx -= a;
-			volatile uint64_t c = a;
-			if(c < 64) { break; }
-
-			debug("bulk match, a(%llu)", a);
-		}
-		uint64_t m = (rsidx - ridx)>>1;
-		if(m > 0) {
-			clen += printer(fp, m, 'M');
-			debug("match m(%lld)", m);
-		}
-		if(ridx == 0) { break; }
-
-		uint64_t arr;
-		uint64_t g = MIN2(
-			_parse_count_gap_forward(arr = parse_load_uint64(p, lim - ridx)),
-			ridx);
-		if(g > 0) {
-			clen += printer(fp, g, 'D' + ((char)(0ULL - (arr & 0x01)) & ('I' - 'D')));
-			debug("gap g(%lld)", g);
-		}
-		if((ridx -= g) <= 1) { break; }
-	}
-	return(clen);
+	int32_t d = 0;
+	for(int64_t i = spos; i < epos; i++) { d += (path[i>>5]>>(i & 31)) & 0x01; }
+	return(_seta_v2i32(d, (epos - spos) - d));
 }
 
 /**
- * @fn gaba_dp_dump_cigar_forward
- * @brief parse path string and store cigar to buffer
+ * @fn trace_clip_path
+ * @brief cut out [spos, epos) of the path, updating sections and the root info
  */
-uint64_t suffix(gaba_dp_dump_cigar_forward)(
-	char *buf,
-	uint64_t buf_size,
-	uint32_t const *path,
-	uint32_t offset,
-	uint32_t len)
+static _force_inline
+void trace_clip_path(
+	struct gaba_alignment_s *aln,
+	int64_t spos,
+	int64_t epos)
 {
-	uint64_t const filled_len_margin = 5;
-	char *b = buf, *blim = buf + buf_size - filled_len_margin;
-
-	/* convert path to uint64_t pointer */
-	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
-	uint64_t lim = offset + (((uint64_t)path & sizeof(uint32_t)) ? 32 : 0) + len;
-	uint64_t ridx = len;
-
-	debug("path(%p), lim(%lld), ridx(%lld)", p, lim, ridx);
-
-	while(1) {
-		uint64_t rsidx = ridx;
-		while(1) {
-			uint64_t m = _parse_count_match_forward(parse_load_uint64(p, lim - ridx));
-			uint64_t a = MIN2(m, ridx) & ~0x01;
-			debug("a(%lld), ridx(%lld), ridx&~0x01(%lld)", a, ridx, ridx & ~0x01);
-			ridx -= a;
-			volatile uint64_t c = a;
-			if(c < 64) { break; }
-
-			debug("bulk match");
-		}
-		uint64_t m = (rsidx - ridx)>>1;
-		if(m > 0) {
-			b += parse_dump_match_string(b, m);
-			debug("match m(%lld)", m);
+	struct gaba_path_section_s *sec = (struct gaba_path_section_s *)aln->sec;
+	struct gaba_path_s *path = (struct gaba_path_s *)aln->path;
+	uint32_t *arr = path->array;
+	int64_t slen = aln->slen;
+
+	/* global path position of the root, clamped into the clipped range */
+	int64_t rpos = (aln->rsidx < slen) ? sec[aln->rsidx].ppos + aln->rppos : 0;
+	int64_t cpos = MIN2(MAX2(rpos, spos), epos);
+
+	/* drop sections out of the range */
+	int64_t h = 0, t;
+	while(h < slen && sec[h].ppos + _plen(&sec[h]) <= spos) { h++; }
+	for(t = h; t < slen && sec[t].ppos < epos; t++) {}
+	t = (spos == epos) ? h : t;
+
+	/* trim boundaries */
+	for(int64_t i = h; i < t; i++) {
+		int64_t ss = MAX2(sec[i].ppos, spos), se = MIN2(sec[i].ppos + _plen(&sec[i]), epos);
+		v2i32_t hc = trace_count_path(arr, sec[i].ppos, ss);
+		v2i32_t sc = trace_count_path(arr, ss, se);
+
+		/* root section */
+		if(cpos >= ss && (cpos < se || i == t - 1)) {
+			aln->rsidx = i - h;
+			aln->rppos = cpos - ss;
+			if(cpos != rpos) {
+				v2i32_t rc = _add_v2i32(_load_v2i32(&sec[i].apos),
+					_add_v2i32(hc, trace_count_path(arr, ss, cpos)));
+				_store_v2i32(&aln->rapos, rc);
+			}
 		}
-		if(ridx == 0 || b > blim) { break; }
+		_store_v2i32(&sec[i].apos, _add_v2i32(_load_v2i32(&sec[i].apos), hc));
+		_store_v2i32(&sec[i].alen, sc);
+		sec[i].ppos = ss - spos;
+	}
+	if(h == t) { aln->rsidx = 0; aln->rppos = 0; }
 
-		uint64_t arr;
-		uint64_t g = MIN2(
-			_parse_count_gap_forward(arr = parse_load_uint64(p, lim - ridx)),
-			ridx);
-		if(g > 0) {
-			b += parse_dump_gap_string(b, g, 'D' + ((char)(0ULL - (arr & 0x01)) & ('I' - 'D')));
-			debug("gap g(%lld)", g);
-		}
-		if((ridx -= g) <= 1 || b > blim) { break; }
+	/* shift path array */
+	int64_t len = epos - spos;
+	uint32_t const *src = arr + (spos>>5);
+	for(int64_t i = 0; i < (len + 31)>>5; i++) {
+		arr[i] = (uint32_t)((((uint64_t)src[i + 1]<<32) | src[i])>>(spos & 31));
 	}
-	*b = '\0';
-	return(b - buf);
+
+	/* add terminator */
+	uint32_t *tail = arr + (len>>5);
+	tail[0] = (tail[0] & ((0x01ULL<<(len & 31)) - 1)) | (0x55555555ULL<<(len & 31));
+	tail[1] = 0x55555555;
+
+	aln->sec = sec + h;
+	aln->slen = t - h;
+	path->len = len;
+	return;
 }
 
 /**
- * @macro _parse_count_match_reverse, _parse_count_gap_reverse
+ * @fn trace_copy_path
+ * @brief append [spos, epos) of src to dst at dpos, dst must be cleared beyond dpos
  */
-#define _parse_count_match_reverse(_arr) ({ \
-	lzcnt((_arr) ^ 0x5555555555555555); \
-})
-#define _parse_count_gap_reverse(_arr) ({ \
-	uint64_t _a = (_arr); \
-	uint64_t mask = (uint64_t)(((int64_t)_a)>>63); \
-	uint64_t gc = lzcnt(_a ^ mask) - ((int64_t)mask + 1); \
-	debug("arr(%llx), mask(%llx), gc(%lld)", _a, mask, gc); \
-	gc; \
-})
+static _force_inline
+void trace_copy_path(
+	uint32_t *dst,
+	int64_t dpos,
+	uint32_t const *src,
+	int64_t spos,
+	int64_t epos)
+{
+	for(int64_t i = spos; i < epos; i += 32) {
+		uint64_t w = (uint32_t)((((uint64_t)src[(i>>5) + 1]<<32) | src[i>>5])>>(i & 31));
+		w &= (0x01ULL<<MIN2(epos - i, 32)) - 1;
+
+		int64_t d = dpos + i - spos;
+		w <<= d & 31;
+		dst[d>>5] |= (uint32_t)w;
+		dst[(d>>5) + 1] |= (uint32_t)(w>>32);
+	}
+	return;
+}
 
 /**
- * @fn gaba_dp_print_cigar_reverse
- * @brief parse path string and print cigar to file
+ * @fn trace_clip_local
+ * @brief clip the path to its best-scoring segment. the zero-floored score of the local
+ * alignment is not representable in the difference dp, so the path is rescored on the
+ * sequences instead and cut at the min prefix score (start) and the following max (end).
  */
-uint64_t suffix(gaba_dp_print_cigar_reverse)(
-	gaba_dp_printer_t printer,
-	void *fp,
-	uint32_t const *path,
-	uint32_t offset,
-	uint32_t len)
+static _force_inline
+void trace_clip_local(
+	struct gaba_dp_context_s *this,
+	struct gaba_alignment_s *aln)
 {
-	int64_t clen = 0;
+	struct trace_cursor_s c = trace_cursor_init(this, aln);
+
+	/* score, xcnt, gicnt, gecnt at the min prefix and of the best segment */
+	int64_t min[4] = { 0 }, best[4] = { 0 };
+	int64_t mpos = 0, spos = 0, epos = 0, plen = c.plen;
+	while(c.ppos < plen) {
+		trace_cursor_step(this, &c);
+
+		/* keep the longest segment on ties */
+		if(c.acc[0] - min[0] >= best[0]) {
+			for(int64_t j = 0; j < 4; j++) { best[j] = c.acc[j] - min[j]; }
+			spos = mpos; epos = c.ppos;
+		}
+		if(c.acc[0] < min[0]) {
+			for(int64_t j = 0; j < 4; j++) { min[j] = c.acc[j]; }
+			mpos = c.ppos;
+		}
+	}
 
-	/* convert path to uint64_t pointer */
-	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
-	uint64_t ofs = (int64_t)offset + (((uint64_t)path & sizeof(uint32_t)) ? -32 : -64);
-	uint64_t idx = len;
+	debug("spos(%lld), epos(%lld), plen(%lld), score(%lld, %lld)", spos, epos, plen, best[0], aln->score);
+	if(spos == 0 && epos == plen) { return; }	/* nothing to clip */
 
-	debug("path(%p, %x), p(%p, %llx), idx(%lld), mod(%lld)",
-		path, *path, p, *p, idx, idx % 64);
+	/* no positive segment */
+	if(best[0] <= 0) { spos = epos = 0; memset(best, 0, sizeof(best)); }
 
-	while(1) {
-		uint64_t sidx = idx;
-		while(1) {
-			uint64_t m = _parse_count_match_reverse(parse_load_uint64(p, idx + ofs));
-			uint64_t a = MIN2(m, idx) & ~0x01;
-			idx -= a;
-			if(a < 64) { break; }
+	trace_clip_path(aln, spos, epos);
+	aln->score = best[0];
+	aln->xcnt = best[1];
+	aln->gicnt = best[2];
+	aln->gecnt = best[3];
+	return;
+}
 
-			debug("bulk match");
-		}
-		uint64_t m = (sidx - idx)>>1;
-		if(m > 0) {
-			clen += printer(fp, m, 'M');
-			debug("match m(%lld)", m);
-		}
-		if(idx == 0) { break; }
+/**
+ * @fn trace_build_rle
+ * @brief run-length encode the path of the alignment in a single pass. the array is placed
+ * after the path in the caller's buffer, returns -1 if it does not fit. otherwise it is
+ * allocated from the same pool as the alignment, sized from the gap-open count and doubled
+ * when short; the conversion is resumed where it stopped.
+ */
+static _force_inline
+int64_t trace_build_rle(
+	struct gaba_dp_context_s *this,
+	struct gaba_alignment_s *aln,
+	struct gaba_trace_params_s const *params)
+{
+	uint32_t const *path = aln->path->array;
+	uint32_t const len = aln->path->len;
+	struct gaba_path_rle_s *rle = NULL;
+	uint64_t cnt = 0, rem = len;
+
+	/* the forward half of the path area is left unused in the caller's buffer */
+	if(params->buf != NULL) {
+		rle = (struct gaba_path_rle_s *)_roundup((uintptr_t)(path + (len>>5) + 4), 8);
+		uint32_t *lim = (uint32_t *)(((uintptr_t)params->buf + params->buf_size - this->tail_margin) & ~(uintptr_t)3);
+		if(rle->op >= lim) { return(-1); }
+		uint32_t *b = rle->op;
+		if(parse_dump_bam_forward(&b, lim, path, 0, len) != 0) { return(-1); }
+		cnt = b - rle->op;
+		rem = 0;
+	}
 
-		uint64_t arr;
-		uint64_t g = MIN2(
-			_parse_count_gap_reverse(arr = parse_load_uint64(p, idx + ofs)),
-			idx);
-		if(g > 0) {
-			clen += printer(fp, g, 'D' + ((char)(((int64_t)arr)>>63) & ('I' - 'D')));
-			debug("gap g(%lld)", g);
+	/* M and gap operations alternate, so there are at most two per gap open */
+	lmm_t *lmm = (lmm_t *)aln->lmm;
+	for(uint64_t cap = 2 * aln->gicnt + 2; rem != 0; cap *= 2) {
+		uint64_t size = sizeof(struct gaba_path_rle_s) + sizeof(uint32_t) * cap;
+		if(lmm != NULL) {
+			rle = (struct gaba_path_rle_s *)lmm_realloc(lmm, (void *)rle, size);
+		} else {
+			struct gaba_path_rle_s *r = (struct gaba_path_rle_s *)gaba_dp_malloc(this, size);
+			if(cnt != 0) { memcpy(r->op, rle->op, sizeof(uint32_t) * cnt); }
+			rle = r;
 		}
-		if((idx -= g) <= 1) { break; }
+		uint32_t *b = rle->op + cnt;
+		rem = parse_dump_bam_forward(&b, rle->op + cap, path, len - rem, rem);
+		cnt = b - rle->op;
 	}
-	return(clen);
+	rle->len = cnt;
+	rle->reserved = 0;
+	aln->rle = rle;
+	debug("rle len(%llu), path len(%u)", cnt, len);
+	return(0);
 }
 
 /**
- * @fn gaba_dp_dump_cigar_reverse
- * @brief parse path string and store cigar to buffer
+ * @fn trace_generate_join
+ * @brief generate alignment from a pair of leaves, returns NULL on failure. with the join
+ * table, the forward path joins those of the leaves traced before, and the reverse leaf,
+ * common to all, is traced once.
  */
-uint64_t suffix(gaba_dp_dump_cigar_reverse)(
-	char *buf,
-	uint64_t buf_size,
-	uint32_t const *path,
-	uint32_t offset,
-	uint32_t len)
+static _force_inline
+struct gaba_alignment_s *trace_generate_join(
+	struct gaba_dp_context_s *this,
+	struct gaba_leaf_s const *fw_leaf,
+	struct gaba_leaf_s const *rv_leaf,
+	struct gaba_trace_params_s const *params,
+	struct trace_join_table_s *jt)
 {
-	uint64_t const filled_len_margin = 5;
-	char *b = buf, *blim = buf + buf_size - filled_len_margin;
-
-	/* convert path to uint64_t pointer */
-	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
-	uint64_t ofs = (int64_t)offset + (((uint64_t)path & sizeof(uint32_t)) ? -32 : -64);
-	uint64_t idx = len;
-
-	while(1) {
-		uint64_t sidx = idx;
-		while(1) {
-			uint64_t m = _parse_count_match_reverse(parse_load_uint64(p, idx + ofs));
-			uint64_t a = MIN2(m, idx) & ~0x01;
-			idx -= a;
-			if(a < 64) { break; }
+	/* create alignment object, fails if the caller's buffer is short */
+	struct gaba_result_s res = trace_init_alignment(this, fw_leaf, rv_leaf, params);
+	if(res.aln == NULL) { return(NULL); }
 
-			debug("bulk match");
-		}
-		uint64_t m = (sidx - idx)>>1;
-		if(m > 0) {
-			b += parse_dump_match_string(b, m);
-			debug("match m(%lld)", m);
+	/* generate paths, may fail when path got lost out of the band */
+	int64_t failed = trace_forward_generate_alignment(this, fw_leaf, &res.fw, jt) < 0;
+	if(!failed && jt != NULL && jt->rv_done) {
+		trace_copy_reverse(&res.rv, &jt->rv);
+	} else if(!failed) {
+		failed = trace_reverse_generate_alignment(this, rv_leaf, &res.rv) < 0;
+	}
+	if(jt != NULL) {
+		trace_join_commit(this, jt, &res.fw, failed);
+		if(!failed && !jt->rv_done) { trace_keep_reverse(this, jt, &res.rv); }
+	}
+	if(failed) {
+		/* allocated on the dp stack or in the caller's buffer if lmm is NULL */
+		if(res.aln->lmm != NULL) {
+			lmm_free((lmm_t *)res.aln->lmm, (void *)((uint8_t *)res.aln - this->head_margin));
 		}
-		if(idx == 0 || b > blim) { break; }
+		return(NULL);
+	}
 
-		uint64_t arr;
-		uint64_t g = MIN2(
-			_parse_count_gap_reverse(arr = parse_load_uint64(p, idx + ofs)),
-			idx);
-		if(g > 0) {
-			b += parse_dump_gap_string(b, g, 'D' + ((char)(((int64_t)arr)>>63) & ('I' - 'D')));
-			debug("gap g(%lld)", g);
-		}
-		if((idx -= g) <= 1 || b > blim) { break; }
+	/* concatenate paths */
+	struct gaba_alignment_s *aln = trace_refine_alignment(this, res.aln, res.rv, res.fw, params);
+	if(params->mode & GABA_TRACE_LOCAL) {
+		trace_clip_local(this, aln);
 	}
-	*b = '\0';
-	return(b - buf);
+	trace_calc_stats(this, aln);
+	if((params->mode & GABA_TRACE_RLE) && trace_build_rle(this, aln, params) < 0) {
+		return(NULL);				/* in the caller's buffer, nothing to free */
+	}
+	return(aln);
 }
 
 /**
- * @fn extract_max, extract_min
- * @brief extract max /min value from 8-bit 16-cell vector
+ * @fn trace_generate
+ * @brief generate alignment from a pair of leaves, returns NULL on failure
  */
 static _force_inline
-int8_t extract_max(int8_t const vector[][4])
-{
-	int8_t *v = (int8_t *)vector;
-	int8_t max = -128;
-	for(int i = 0; i < 16; i++) {
-		max = (v[i] > max) ? v[i] : max;
-	}
-	return(max);
-}
-static _force_inline
-int8_t extract_min(int8_t const vector[][4])
+struct gaba_alignment_s *trace_generate(
+	struct gaba_dp_context_s *this,
+	struct gaba_leaf_s const *fw_leaf,
+	struct gaba_leaf_s const *rv_leaf,
+	struct gaba_trace_params_s const *params)
 {
-	int8_t *v = (int8_t *)vector;
-	int8_t min = 127;
-	for(int i = 0; i < 16; i++) {
-		min = (v[i] < min) ? v[i] : min;
-	}
-	return(min);
+	return(trace_generate_join(this, fw_leaf, rv_leaf, params, NULL));
 }
 
 /**
- * @fn gaba_init_restore_default_params
+ * @fn gaba_dp_trace
  */
-static _force_inline
-void gaba_init_restore_default_params(
-	struct gaba_params_s *params)
+struct gaba_alignment_s *suffix(gaba_dp_trace)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *fw_tail,
+	struct gaba_fill_s const *rv_tail,
+	struct gaba_trace_params_s const *params)
 {
-	#define restore(_name, _default) { \
-		params->_name = ((uint64_t)(params->_name) == 0) ? (_default) : (params->_name); \
-	}
-	if(params->m == 0 && params->x == 0 && params->gi == 0 && params->ge == 0) {
-		params->m = 1;
-		params->x = 1;
-		params->gi = 1;
-		params->ge = 1;
+	/* substitute tail if NULL */
+	fw_tail = (fw_tail == NULL) ? _fill(&this->tail) : fw_tail;
+	rv_tail = (rv_tail == NULL) ? _fill(&this->tail) : rv_tail;
+
+	/* restore default params if NULL */
+	struct gaba_trace_params_s const default_params = {
+		.lmm = NULL,
+		.sec = NULL,
+		.slen = 0,
+		.k = 0
+	};
+	params = (params == NULL) ? &default_params : params;
+
+	uint64_t start = watchdog_timestamp(this);
+
+	/* search */
+	struct gaba_leaf_s fw_leaf, rv_leaf;
+	leaf_load(this, _tail(fw_tail), &fw_leaf);
+	leaf_load(this, _tail(rv_tail), &rv_leaf);
+
+	struct gaba_alignment_s *aln = trace_generate(this, &fw_leaf, &rv_leaf, params);
+	if(_unlikely(this->wd.path != NULL) && aln != NULL) {
+		watchdog_check(this, "trace", start, aln->path->len, _tail(fw_tail), _tail(rv_tail));
 	}
-	restore(xdrop, 				50);
-	restore(filter_thresh,		0);
-	restore(head_margin, 		0);
-	restore(tail_margin, 		0);
-	return;
+	return(aln);
 }
 
 /**
- * @fn gaba_init_check_score
- * @brief return non-zero if the score is not applicable
+ * @fn gaba_dp_trace_size
  */
-static _force_inline
-int gaba_init_check_score(
-	struct gaba_params_s const *params)
+uint64_t suffix(gaba_dp_trace_size)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *fw_tail,
+	struct gaba_fill_s const *rv_tail,
+	struct gaba_trace_params_s const *params)
 {
-	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
-
-	#if MODEL == LINEAR
-		if(m - 2 * (ge + gi) > 255) { return(-1); }
-		if((ge + gi) > 0) { return(-1); }
-	#else
-		if(m - 2 * (ge + gi) > 31) { return(-1); }
-		if(ge < gi) { return(-1); }
-		if((ge + gi) < -7) { return(-1); }
-	#endif
-	return(0);
+	fw_tail = (fw_tail == NULL) ? _fill(&this->tail) : fw_tail;
+	rv_tail = (rv_tail == NULL) ? _fill(&this->tail) : rv_tail;
+	uint64_t mode = (params == NULL) ? 0 : params->mode;
+	return(trace_calc_size(this, _tail(fw_tail), _tail(rv_tail), mode).size);
 }
 
 /**
- * @fn gaba_init_create_score_vector
+ * @fn gaba_dp_trace_batch
+ * @brief trace on arrays of tails. the tails of TRACE_BATCH pairs are prefetched and their
+ * leaves loaded at once, prefetching the first two blocks of each walk, so that those misses
+ * overlap; the tracebacks themselves run one after another. the caller's buffer is split
+ * into slots of gaba_dp_trace_size in the order of the pairs.
  */
-static _force_inline
-struct gaba_score_vec_s gaba_init_create_score_vector(
-	struct gaba_params_s const *params)
+uint64_t suffix(gaba_dp_trace_batch)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *const *fw_tail,
+	struct gaba_fill_s const *const *rv_tail,
+	uint64_t cnt,
+	struct gaba_trace_params_s const *params,
+	struct gaba_alignment_s **aln)
 {
-	int8_t m = params->m, x = -params->x, ge = -params->ge, gi = -params->gi;
-	int8_t sb[16] __attribute__(( aligned(16) ));
-	struct gaba_score_vec_s sc __attribute__(( aligned(BW) ));
+	/* restore default params if NULL */
+	struct gaba_trace_params_s const default_params = {
+		.lmm = NULL,
+		.sec = NULL,
+		.slen = 0,
+		.k = 0
+	};
+	params = (params == NULL) ? &default_params : params;
 
-	sb[0] = x - 2 * (ge + gi);
-	for(int i = 1; i < 16; i++) {
-		sb[i] = m - 2 * (ge + gi);
-	}
-	_store_sb(sc, _load_v16i8(sb));
+	/* params of each pair, the buffer is advanced by the size of the slot */
+	struct gaba_trace_params_s p = *params;
+	uint8_t *buf = (uint8_t *)params->buf;
+	uint64_t buf_rem = params->buf_size;
+
+	uint64_t found = 0;
+	for(uint64_t i = 0; i < cnt; i += TRACE_BATCH) {
+		uint64_t const n = MIN2(cnt - i, TRACE_BATCH);
+
+		/* substitute tail if NULL, then touch them all before the leaves are loaded */
+		struct gaba_joint_tail_s const *tail[TRACE_BATCH][2];
+		for(uint64_t j = 0; j < n; j++) {
+			struct gaba_fill_s const *fw = (fw_tail == NULL) ? NULL : fw_tail[i + j];
+			struct gaba_fill_s const *rv = (rv_tail == NULL) ? NULL : rv_tail[i + j];
+			tail[j][0] = _tail((fw == NULL) ? _fill(&this->tail) : fw);
+			tail[j][1] = _tail((rv == NULL) ? _fill(&this->tail) : rv);
+			_prefetch(tail[j][0]); _prefetch((uint8_t const *)tail[j][0] + 64);
+			_prefetch(tail[j][1]); _prefetch((uint8_t const *)tail[j][1] + 64);
+		}
 
-	#if MODEL == LINEAR
-		_store_adjh(sc, 0, 0, ge + gi, ge + gi);
-		_store_adjv(sc, 0, 0, ge + gi, ge + gi);
-		_store_ofsh(sc, 0, 0, ge + gi, ge + gi);
-		_store_ofsv(sc, 0, 0, ge + gi, ge + gi);
-	#else
-		_store_adjh(sc, -gi, -gi, -(ge + gi), ge + gi);
-		_store_adjv(sc, -gi, -gi, -(ge + gi), ge + gi);
-		_store_ofsh(sc, -gi, -gi, -(ge + gi), ge + gi);
-		_store_ofsv(sc, -gi, -gi, -(ge + gi), ge + gi);
-	#endif
-	return(sc);
+		/* search, and prefetch the two blocks where each walk starts */
+		struct gaba_leaf_s leaf[TRACE_BATCH][2];
+		for(uint64_t j = 0; j < n; j++) {
+			for(uint64_t k = 0; k < 2; k++) {
+				leaf_load(this, tail[j][k], &leaf[j][k]);
+				_trace_prefetch_block(leaf[j][k].blk);
+				_trace_prefetch_block(leaf[j][k].blk - 1);
+			}
+		}
+
+		for(uint64_t j = 0; j < n; j++) {
+			uint64_t start = watchdog_timestamp(this);
+			if(buf != NULL) {
+				uint64_t size = MIN2(buf_rem,
+					_roundup(trace_calc_size(this, tail[j][0], tail[j][1], p.mode).size, 16));
+				p.buf = buf; p.buf_size = size;
+				buf += size; buf_rem -= size;
+			}
+
+			struct gaba_alignment_s *a = aln[i + j] = trace_generate(this, &leaf[j][0], &leaf[j][1], &p);
+			if(_unlikely(this->wd.path != NULL) && a != NULL) {
+				watchdog_check(this, "trace", start, a->path->len, tail[j][0], tail[j][1]);
+			}
+			found += a != NULL;
+		}
+	}
+	return(found);
 }
 
 /**
- * @fn gaba_init_create_dir_dynamic
+ * @fn trace_calc_prefix
+ * @brief length of the common prefix of two paths
  */
 static _force_inline
-union gaba_dir_u gaba_init_create_dir_dynamic(
-	struct gaba_params_s const *params)
+uint32_t trace_calc_prefix(
+	struct gaba_path_s const *x,
+	struct gaba_path_s const *y)
 {
-	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
-
-	#if MODEL == LINEAR
-		int16_t coef = -m + 2 * (ge + gi);
-		int16_t ofs = 0;
-	#else
-		int16_t coef = -m + 2 * ge;
-		int16_t ofs = gi;
-	#endif
-
-	int64_t acc = (ofs + coef * BW/2) - (ofs + coef * (BW/2 - 1));
-	return((union gaba_dir_u) {
-		.dynamic = {
-			.acc = acc,
-			.array = 0x80000000	/* (0, 0) -> (0, 1) (down) */
-		}
-	});
+	int64_t len = MIN2(x->len, y->len);
+	for(int64_t i = 0; i < len; i += 32) {
+		uint32_t diff = x->array[i>>5] ^ y->array[i>>5];
+		if(diff != 0) { return(MIN2(i + (int64_t)tzcnt(diff), len)); }
+	}
+	return(len);
 }
 
 /**
- * @fn gaba_init_create_small_delta
+ * @fn gaba_dp_trace_tree
+ * @brief trace on the leaves of a fill tree. the forward walk of each leaf is compared with
+ * those of the leaves traced before at every section boundary, and the path and sections
+ * from the first equal state to the root are copied instead of walked. the reverse leaf is
+ * traced once.
  */
-static _force_inline
-struct gaba_small_delta_s gaba_init_create_small_delta(
-	struct gaba_params_s const *params)
+uint64_t suffix(gaba_dp_trace_tree)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *const *fw_tail,
+	uint64_t cnt,
+	struct gaba_fill_s const *rv_tail,
+	struct gaba_trace_params_s const *params,
+	struct gaba_alignment_s **aln,
+	struct gaba_path_prefix_s *prefix)
 {
-	int8_t relax = -128 / BW;
+	/* substitute tail if NULL */
+	rv_tail = (rv_tail == NULL) ? _fill(&this->tail) : rv_tail;
 
-	struct gaba_small_delta_s sd;
-	#if MODEL == LINEAR
-		for(int i = 0; i < BW/2; i++) {
-			sd.delta[i] = relax * (BW/2 - i);
-			sd.delta[BW/2 + i] = relax * i;
-			sd.max[i] = relax * (BW/2 - i);
-			sd.max[BW/2 + i] = relax * i;
-		}
-	#else
-		for(int i = 0; i < BW/2; i++) {
-			sd.delta[i] = relax * (BW/2 - i);
-			sd.delta[BW/2 + i] = relax * i;
-			sd.max[i] = relax * (BW/2 - i);
-			sd.max[BW/2 + i] = relax * i;
+	/* restore default params if NULL */
+	struct gaba_trace_params_s const default_params = {
+		.lmm = NULL,
+		.sec = NULL,
+		.slen = 0,
+		.k = 0
+	};
+	params = (params == NULL) ? &default_params : params;
+
+	/* params of each leaf, the buffer is advanced by the size of the slot */
+	struct gaba_trace_params_s p = *params;
+	uint8_t *buf = (uint8_t *)params->buf;
+	uint64_t buf_rem = params->buf_size;
+
+	struct gaba_leaf_s rv_leaf;
+	leaf_load(this, _tail(rv_tail), &rv_leaf);
+
+	struct trace_join_table_s jt = {
+		.cnt = 0, .base = 0, .size = 0, .mask = 0,
+		.j = NULL, .bucket = NULL,
+		.rv_done = 0
+	};
+
+	uint64_t found = 0;
+	for(uint64_t i = 0; i < cnt; i++) {
+		struct gaba_fill_s const *fw = (fw_tail == NULL) ? NULL : fw_tail[i];
+		struct gaba_joint_tail_s const *tail = _tail((fw == NULL) ? _fill(&this->tail) : fw);
+
+		uint64_t start = watchdog_timestamp(this);
+		struct gaba_leaf_s leaf;
+		leaf_load(this, tail, &leaf);
+		if(buf != NULL) {
+			uint64_t size = MIN2(buf_rem,
+				_roundup(trace_calc_size(this, tail, _tail(rv_tail), p.mode).size, 16));
+			p.buf = buf; p.buf_size = size;
+			buf += size; buf_rem -= size;
 		}
-	#endif
 
-	return(sd);
+		jt.leaf = jt.ref = i;
+		struct gaba_alignment_s *a = aln[i] = trace_generate_join(this, &leaf, &rv_leaf, &p, &jt);
+		if(_unlikely(this->wd.path != NULL) && a != NULL) {
+			watchdog_check(this, "trace", start, a->path->len, tail, _tail(rv_tail));
+		}
+		if(prefix != NULL) {
+			prefix[i] = (struct gaba_path_prefix_s){
+				.ref = jt.ref,
+				.len = (a == NULL || jt.ref == i) ? 0 : trace_calc_prefix(a->path, aln[jt.ref]->path)
+			};
+		}
+		found += a != NULL;
+	}
+	return(found);
 }
 
 /**
- * @fn gaba_init_create_middle_delta
+ * @fn gaba_dp_trace_max
  */
-static _force_inline
-struct gaba_middle_delta_s gaba_init_create_middle_delta(
-	struct gaba_params_s const *params)
+struct gaba_alignment_s *suffix(gaba_dp_trace_max)(
+	struct gaba_dp_context_s *this,
+	struct gaba_max_s const *fw_max,
+	struct gaba_max_s const *rv_max,
+	struct gaba_trace_params_s const *params)
 {
-	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
-	int8_t relax = 128 / BW;
-
-	#if MODEL == LINEAR
-		int16_t coef = -m + 2 * (ge + gi) + relax;
-		int16_t ofs = 0;
-	#else
-		int16_t coef = -m + 2*ge + relax;
-		int16_t ofs = gi;
-	#endif
+	/* restore default params if NULL */
+	struct gaba_trace_params_s const default_params = {
+		.lmm = NULL,
+		.sec = NULL,
+		.slen = 0,
+		.k = 0
+	};
+	params = (params == NULL) ? &default_params : params;
 
-	struct gaba_middle_delta_s md;
-	for(int i = 0; i < BW/2; i++) {
-		md.delta[i] = ofs + coef * (BW/2 - i);
-		md.delta[BW/2 + i] = ofs + coef * i;
+	/* substitute root if NULL */
+	struct gaba_leaf_s fw_leaf, rv_leaf;
+	if(fw_max == NULL) {
+		leaf_search(this, &this->tail, &fw_leaf);
+	} else {
+		fw_leaf = *_leaf(fw_max);
 	}
-	md.delta[BW/2] = 0;
-	return(md);
+	if(rv_max == NULL) {
+		leaf_search(this, &this->tail, &rv_leaf);
+	} else {
+		rv_leaf = *_leaf(rv_max);
+	}
+	return(trace_generate(this, &fw_leaf, &rv_leaf, params));
 }
 
 /**
- * @fn gaba_init_create_diff_vectors
- *
- * @detail
- * dH[i, j] = S[i, j] - S[i - 1, j]
- * dV[i, j] = S[i, j] - S[i, j - 1]
- * dE[i, j] = E[i, j] - S[i, j]
- * dF[i, j] = F[i, j] - S[i, j]
+ * @fn gaba_dp_trace_cell
+ * @brief traceback from the cell at (apos, bpos) on the current sections of the tails,
+ * instead of the max. the cell is located by refilling the block containing it; NULL
+ * if it is out of the band of the last fragment.
  */
-#if MODEL == LINEAR
-static _force_inline
-struct gaba_diff_vec_s gaba_init_create_diff_vectors(
-	struct gaba_params_s const *params)
+struct gaba_alignment_s *suffix(gaba_dp_trace_cell)(
+	struct gaba_dp_context_s *this,
+	struct gaba_fill_s const *fw_tail,
+	struct gaba_pos_pair_s const *fw_pos,
+	struct gaba_fill_s const *rv_tail,
+	struct gaba_pos_pair_s const *rv_pos,
+	struct gaba_trace_params_s const *params)
 {
-	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
-	int8_t drop = 0;
-	int8_t raise = m - 2 * (ge + gi);
+	/* substitute tail if NULL */
+	fw_tail = (fw_tail == NULL) ? _fill(&this->tail) : fw_tail;
+	rv_tail = (rv_tail == NULL) ? _fill(&this->tail) : rv_tail;
 
-	int8_t dh[BW] __attribute__(( aligned(BW) ));
-	int8_t dv[BW] __attribute__(( aligned(BW) ));
+	/* restore default params if NULL */
+	struct gaba_trace_params_s const default_params = {
+		.lmm = NULL,
+		.sec = NULL,
+		.slen = 0,
+		.k = 0
+	};
+	params = (params == NULL) ? &default_params : params;
 
-	struct gaba_diff_vec_s diff __attribute__(( aligned(BW) ));
-	/**
-	 * dh: dH[i, j] - gh
-	 * dv: dV[i, j] - gv
-	 */
-	/* calc dh and dv */
-	for(int i = 0; i < BW/2; i++) {
-		dh[i] = drop;
-		dh[BW/2 + i] = raise;
-		dv[i] = raise;
-		dv[BW/2 + i] = drop;
+	/* locate the cells, the max (or the end cell) if the position is NULL */
+	struct gaba_joint_tail_s const *tail[2] = { _tail(fw_tail), _tail(rv_tail) };
+	struct gaba_pos_pair_s const *pos[2] = { fw_pos, rv_pos };
+	struct gaba_leaf_s leaf[2];
+	for(int64_t i = 0; i < 2; i++) {
+		if(pos[i] == NULL) {
+			leaf_load(this, tail[i], &leaf[i]);
+			continue;
+		}
+		if(pos[i]->apos >= (uint32_t)tail[i]->alen || pos[i]->bpos >= (uint32_t)tail[i]->blen) {
+			debug("position out of the sections, i(%lld), apos(%u, %u), bpos(%u, %u)",
+				i, pos[i]->apos, tail[i]->alen, pos[i]->bpos, tail[i]->blen);
+			return(NULL);
+		}
+		int32_t aridx = tail[i]->alen - pos[i]->apos - 1, bridx = tail[i]->blen - pos[i]->bpos - 1;
+		if(leaf_search_cell(this, tail[i], aridx, bridx, &leaf[i]) <= 0) {
+			debug("cell out of the band, i(%lld), aridx(%d), bridx(%d)", i, aridx, bridx);
+			return(NULL);
+		}
 	}
- 	dh[BW/2] = raise;
- 	dv[BW/2] = raise;
-
-	_store(&diff.dh, _load(dh));
-	_store(&diff.dv, _load(dv));
-	return(diff);
+	return(trace_generate(this, &leaf[0], &leaf[1], params));
 }
-#else
-static _force_inline
-struct gaba_diff_vec_s gaba_init_create_diff_vectors(
-	struct gaba_params_s const *params)
-{
-	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
 
-	int8_t ofs_dh = -(ge + gi);
-	int8_t ofs_dv = -(ge + gi);
-	int8_t ofs_de = -gi;
-	int8_t ofs_df = -gi;
-	
-	int8_t drop_dh = ge + ofs_dh;
-	int8_t raise_dh = m - ge + ofs_dh;
-	int8_t drop_dv = ge + ofs_dv;
-	int8_t raise_dv = m - ge + ofs_dv;
-	int8_t drop_de = gi + ofs_de;
-	int8_t raise_de = ofs_de;
-	int8_t drop_df = gi + ofs_df;
-	int8_t raise_df = ofs_df;
-
-	int8_t dh[BW] __attribute__(( aligned(BW) ));
-	int8_t dv[BW] __attribute__(( aligned(BW) ));
-	int8_t de[BW] __attribute__(( aligned(BW) ));
-	int8_t df[BW] __attribute__(( aligned(BW) ));
+/**
+ * @fn gaba_dp_recombine
+ */
+struct gaba_alignment_s *suffix(gaba_dp_recombine)(
+	struct gaba_dp_context_s *this,
+	struct gaba_alignment_s *x,
+	uint32_t xsid,
+	struct gaba_alignment_s *y,
+	uint32_t ysid)
+{
+	debug("recombine called, x(%p, %lld), a(%u, %u), b(%u, %u), y(%p, %lld), a(%u, %u), b(%u, %u)",
+		x, x->score, x->sec[0].apos, x->sec[0].alen, x->sec[0].bpos, x->sec[0].blen,
+		y, y->score, y->sec[0].apos, y->sec[0].alen, y->sec[0].bpos, y->sec[0].blen);
 
-	struct gaba_diff_vec_s diff __attribute__(( aligned(BW) ));
-	/**
-	 * dh: dH[i, j] - ge
-	 * dv: dV[i, j] - gev
-	 * de: dE[i, j] + gi + dV[i, j] - gev
-	 * df: dF[i, j] + gi + dH[i, j] - ge
-	 */
-	/* calc dh and dv */
-	for(int i = 0; i < BW/2; i++) {
-		dh[i] = drop_dh;
-		dh[BW/2 + i] = raise_dh;
-		dv[i] = raise_dv;
-		dv[BW/2 + i] = drop_dv;
+	if(xsid >= x->slen || ysid >= y->slen) {
+		debug("section index out of range, xsid(%u, %u), ysid(%u, %u)", xsid, x->slen, ysid, y->slen);
+		gaba_dp_res_free(x);
+		gaba_dp_res_free(y);
+		return(NULL);
 	}
- 	dh[BW/2] = raise_dh - gi;
- 	dv[BW/2] = raise_dv - gi;
 
-	/* calc de and df */
- 	for(int i = 0; i < BW/2; i++) {
- 		de[i] = raise_de;
- 		de[BW/2 + i] = drop_de;
- 		df[i] = drop_df;
- 		df[BW/2 + i] = raise_df;
- 	}
- 	de[BW/2] = drop_de;
- 	df[BW/2] = drop_df;
+	/* x up to the tail of xsid, y from the head of ysid */
+	struct gaba_path_section_s const *xs = &x->sec[xsid], *ys = &y->sec[ysid];
+	int64_t xplen = xs->ppos + _plen(xs), yppos = ys->ppos;
+	int64_t slen = xsid + 1 + y->slen - ysid, plen = xplen + y->path->len - yppos;
 
- 	vec_t _dh = _load(dh);
- 	vec_t _dv = _load(dv);
- 	vec_t _de = _load(de);
- 	vec_t _df = _load(df);
+	/* malloc, laid out the same as trace_init_alignment */
+	uint64_t sec_size = sizeof(struct gaba_path_section_s) * slen;
+	uint64_t path_size = sizeof(struct gaba_path_s) + sizeof(uint32_t) * (_roundup(plen, 32) / 32 + 2);
+	struct trace_origin_s const *src[2] = { _origin(x), _origin(y) };
+	uint64_t size = sizeof(struct gaba_alignment_s) + _origin_size(src[0]->cnt + src[1]->cnt)
+			+ sec_size + path_size + this->head_margin + this->tail_margin;
 
- 	_print(_dh);
- 	_print(_dv);
- 	_print(_de);
- 	_print(_df);
+	lmm_t *lmm = (lmm_t *)x->lmm;
+	struct gaba_alignment_s *aln = (struct gaba_alignment_s *)(this->head_margin
+		+ (uintptr_t)((lmm == NULL) ? gaba_dp_malloc(this, size) : lmm_malloc(lmm, size)));
+	aln->lmm = (void *)lmm;
+	aln->reserved3 = this->head_margin;
+	aln->rle = NULL;
+
+	/* tails of both, duplicates removed; the sections follow the room reserved for all of them */
+	struct trace_origin_s *org = _origin(aln);
+	struct gaba_path_section_s *sec = (struct gaba_path_section_s *)((uint8_t *)org
+		+ _origin_size(src[0]->cnt + src[1]->cnt));
+	struct gaba_path_s *path = (struct gaba_path_s *)(sec + slen);
+	uint64_t ocnt = 0;
+	for(int64_t k = 0; k < 2; k++) {
+		for(uint64_t i = 0; i < src[k]->cnt; i++) {
+			uint64_t j = 0;
+			while(j < ocnt && (org->tail[2 * j] != src[k]->tail[2 * i] || org->tail[2 * j + 1] != src[k]->tail[2 * i + 1])) { j++; }
+			if(j < ocnt) { continue; }
+			org->tail[2 * ocnt] = src[k]->tail[2 * i];
+			org->tail[2 * ocnt++ + 1] = src[k]->tail[2 * i + 1];
+		}
+	}
+	org->cnt = ocnt;
 
-	_dh = _shl(_dh, 3);
-	_dv = _shl(_dv, 3);
-	_store(&diff.dh, _add(_dh, _de));
-	_store(&diff.dv, _add(_dv, _df));
-	_print(_add(_dh, _de));
-	_print(_add(_dv, _df));
+	/* concatenate sections, shifting the path positions of y */
+	memcpy(sec, x->sec, sizeof(struct gaba_path_section_s) * (xsid + 1));
+	for(int64_t i = xsid + 1; i < slen; i++) {
+		sec[i] = y->sec[i - xsid - 1 + ysid];
+		sec[i].ppos += xplen - yppos;
+	}
 
-	return(diff);
+	/* concatenate paths, then add terminator */
+	memset(path->array, 0, sizeof(uint32_t) * (_roundup(plen, 32) / 32 + 2));
+	trace_copy_path(path->array, 0, x->path->array, 0, xplen);
+	trace_copy_path(path->array, xplen, y->path->array, yppos, y->path->len);
+	path->array[plen>>5] |= 0x55555555ULL<<(plen & 31);
+	path->array[(plen>>5) + 1] = 0x55555555;
+	path->len = plen;
+
+	/* root, kept on x if not clipped off, then on y, or the junction otherwise */
+	if(x->rsidx <= xsid) {
+		memcpy(&aln->rapos, &x->rapos, 4 * sizeof(uint32_t));
+	} else if(y->rsidx >= ysid) {
+		memcpy(&aln->rapos, &y->rapos, 4 * sizeof(uint32_t));
+		aln->rsidx = y->rsidx - ysid + xsid + 1;
+	} else {
+		aln->rapos = ys->apos;
+		aln->rbpos = ys->bpos;
+		aln->rppos = 0;
+		aln->rsidx = xsid + 1;
+	}
+	aln->slen = slen;
+	aln->sec = sec;
+	aln->path = path;
+
+	/* rescore on the sequences */
+	aln->score = trace_calc_stats(this, aln);
+
+	gaba_dp_res_free(x);
+	gaba_dp_res_free(y);
+	return(aln);
 }
-#endif
 
 /**
- * @fn gaba_init_create_char_vector
+ * @fn gaba_dp_res_free
  */
-static _force_inline
-struct gaba_char_vec_s gaba_init_create_char_vector(
-	void)
+void suffix(gaba_dp_res_free)(
+	struct gaba_alignment_s *aln)
 {
-	struct gaba_char_vec_s ch;
-
-	for(int i = 0; i < BW; i++) {
-		ch.w[i] = 0;
+	if(aln->lmm != NULL) {
+		lmm_t *lmm = (lmm_t *)aln->lmm;
+		if(aln->rle != NULL) { lmm_free(lmm, (void *)aln->rle); }
+		debug("free mem, ptr(%p), lmm(%p)", (void *)aln - aln->reserved3, lmm);
+		lmm_free(lmm, (void *)((uint8_t *)aln - aln->reserved3));
 	}
-	return(ch);
+	return;
 }
 
 /**
- * @fn gaba_init
+ * @fn parse_dump_number
+ * @brief format n >= 64 in decimal, returns #digits. below 10^8 all the digits are split in
+ * the lanes of a 64-bit word at once (swar), two digits at a time from a table above.
  */
-gaba_t *suffix(gaba_init)(
-	struct gaba_params_s const *params)
+static inline
+int64_t parse_dump_number(
+	char *buf,
+	uint64_t n)
 {
-	if(params == NULL) {
-		debug("params must not be NULL");
-		return(NULL);
+	static char const conv[200] =
+		"00010203040506070809" "10111213141516171819" "20212223242526272829"
+		"30313233343536373839" "40414243444546474849" "50515253545556575859"
+		"60616263646566676869" "70717273747576777879" "80818283848586878889"
+		"90919293949596979899";
+
+	/* #digits without a loop; path and run lengths fit in 32 bits */
+	int64_t d = 2 + (n >= 100) + (n >= 1000) + (n >= 10000)
+		+ (n >= 100000) + (n >= 1000000) + (n >= 10000000) + (n >= 100000000)
+		+ (n >= 1000000000) + (n >= 10000000000ULL);
+
+	if(n < 100000000) {
+		/* 4 + 4 digits in 32-bit lanes, 2 + 2 in 16-bit lanes, then one per byte, the first at the lowest */
+		uint64_t v = n / 10000 + ((n % 10000)<<32);
+		uint64_t q = ((v * 10486)>>20) & 0x0000007f0000007fULL;
+		v = q + ((v - 100 * q)<<16);
+		q = ((v * 103)>>10) & 0x000f000f000f000fULL;
+		v = q + ((v - 10 * q)<<8) + 0x3030303030303030ULL;
+		memcpy(buf, (char const *)&v + 8 - d, d);		/* little endian, leading zeros skipped */
+		return(d);
 	}
 
-	/* copy params to local stack */
-	struct gaba_params_s params_intl = *params;
-
-	/* restore defaults */
-	gaba_init_restore_default_params(&params_intl);
-
-	/* check the scores are applicable */
-	if(gaba_init_check_score(&params_intl) != 0) {
-		return(NULL);
+	char *p = buf + d;
+	while(n >= 100) {
+		p -= 2; memcpy(p, &conv[2 * (n % 100)], 2);
+		n /= 100;
 	}
-
-	/* malloc gaba_context_s */
-	struct gaba_context_s *ctx = (struct gaba_context_s *)gaba_aligned_malloc(
-		sizeof(struct gaba_context_s),
-		MEM_ALIGN_SIZE);
-	if(ctx == NULL) {
-		return(NULL);
+	if(n >= 10) {
+		p -= 2; memcpy(p, &conv[2 * n], 2);
+	} else {
+		*--p = '0' + n;
 	}
-
-	/* fill context */
-	*ctx = (struct gaba_context_s) {
-		/* template */
-		.k = (struct gaba_dp_context_s) {
-			/* memory management */
-			.mem = { 0 },
-			.curr_mem = NULL,
-			.stack_top = NULL,						/* stored on init */
-			.stack_end = NULL,						/* stored on init */
-
-			/* score vectors */
-			.scv = gaba_init_create_score_vector(&params_intl),
-			.m = params_intl.m,
-			.x = -params_intl.x,
-			.gi = (MODEL == LINEAR)
-				? 0
-				: -params_intl.gi,
-			.ge = (MODEL == LINEAR)
-				? -(params_intl.gi + params_intl.ge)
-				: -params_intl.ge,
-			.tx = params_intl.xdrop,
-			.tf = params_intl.filter_thresh,
-
-			/* input and output options */
-			.head_margin = _roundup(params_intl.head_margin, MEM_ALIGN_SIZE),
-			.tail_margin = _roundup(params_intl.tail_margin, MEM_ALIGN_SIZE),
-
-			/* phantom block at root */
-			.blk = (struct gaba_phantom_block_s) {
-				/* direction array */
-				.dir = gaba_init_create_dir_dynamic(&params_intl),
-				
-				/* offset, diffs and deltas */
-				.offset = 0,
-				.diff = gaba_init_create_diff_vectors(&params_intl),
-				.sd = gaba_init_create_small_delta(&params_intl),
-				.md = &ctx->md,
-
-				/* char vectors */
-				.ch = gaba_init_create_char_vector(),
-
-				/* indices */
-				.aridx = 0,
-				.bridx = 0
-			},
-
-			/* tail of root section */
-			.tail = (struct gaba_joint_tail_s) {
-				/* coordinates */
-				.psum = PSUM_BASE - BW,
-				.p = 0,
-				.ssum = 0,
-
-				/* max */
-				.max = 0,
-
-				/* status */
-				.stat = CONT,
-
-				/* internals */
-				.rem_len = 0,
-				.tail = NULL,
-				.apos = 0,
-				.bpos = 0,
-				.alen = 0,
-				.blen = 0,
-				.aid = 0xfffc,
-				.bid = 0xfffd
-			},
-		},
-
-		/* default middle delta vector */
-		.md = gaba_init_create_middle_delta(&params_intl)
-	};
-
-	return((gaba_t *)ctx);
+	return(d);
 }
 
 /**
- * @fn gaba_clean
+ * @fn parse_dump_op_string
+ * @brief format a cigar operation; runs shorter than 64 are converted with a packed-bcd table
  */
-void suffix(gaba_clean)(
-	struct gaba_context_s *ctx)
+static _force_inline
+int64_t parse_dump_op_string(
+	char *buf,
+	int64_t len,
+	char ch)
 {
-	gaba_aligned_free(ctx);
-	return;
+	if(len < 64) {
+		static uint8_t const conv[64] = {
+			0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+			0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+			0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29,
+			0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+			0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+			0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+			0x60, 0x61, 0x62, 0x63
+		};
+		char *p = buf;
+		*p = (conv[len]>>4) + '0'; p += (conv[len] & 0xf0) != 0;
+		*p++ = (conv[len] & 0x0f) + '0';
+		*p++ = ch;
+		return(p - buf);
+	}
+	int64_t d = parse_dump_number(buf, len);
+	buf[d] = ch;
+	return(d + 1);
 }
+#define parse_dump_match_string(_buf, _len)			parse_dump_op_string(_buf, _len, 'M')
+#define parse_dump_gap_string(_buf, _len, _ch)		parse_dump_op_string(_buf, _len, _ch)
 
 /**
- * @fn gaba_dp_init
+ * @fn gaba_dp_print_cigar_forward
+ * @brief parse path string and print cigar to file
  */
-struct gaba_dp_context_s *suffix(gaba_dp_init)(
-	struct gaba_context_s const *ctx,
-	uint8_t const *alim,
-	uint8_t const *blim)
+uint64_t suffix(gaba_dp_print_cigar_forward)(
+	gaba_dp_printer_t printer,
+	void *fp,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
 {
-	/* malloc stack memory */
-	struct gaba_dp_context_s *this = (struct gaba_dp_context_s *)gaba_aligned_malloc(
-		MEM_INIT_SIZE, MEM_ALIGN_SIZE);
-	if(this == NULL) {
-		debug("failed to malloc memory");
-		return(NULL);
-	}
+	uint64_t clen = 0;
 
-	/* init stack pointers */
-	this->stack_top = (uint8_t *)(this + 1);
-	this->stack_end = (uint8_t *)this + MEM_INIT_SIZE - MEM_MARGIN_SIZE;
+	/* convert path to uint64_t pointer */
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	uint64_t lim = offset + (((uint64_t)path & sizeof(uint32_t)) ? 32 : 0) + len;
+	uint64_t ridx = len, tbl = 1;
 
-	/* init seq lims */
-	this->w.r.alim = alim;
-	this->w.r.blim = blim;
+	debug("path(%p), lim(%lld), ridx(%lld), mod(%lld)", p, lim, ridx, ridx % 64);
 
-	/* copy template */
-	_memcpy_blk_aa(
-		(uint8_t *)this + GABA_DP_CONTEXT_LOAD_OFFSET,
-		(uint8_t *)&ctx->k + GABA_DP_CONTEXT_LOAD_OFFSET,
-		GABA_DP_CONTEXT_LOAD_SIZE);
+	while(1) {
+		uint64_t arr = parse_load_uint64(p, lim - ridx), t;
 
-	/* init mem object */
-	this->curr_mem = &this->mem;
-	this->mem = (struct gaba_mem_block_s){
-		.next = NULL,
-		.prev = NULL,
-		.size = MEM_INIT_SIZE
-	};
-	return(this);
+		/* short mixed runs, a byte of the path at a time */
+		if(tbl && ridx > 8 && (t = parse_decode_forward(arr)) != 0) {
+			for(uint64_t k = 0; k < _parse_op_cnt(t); k++) {
+				clen += printer(fp, _parse_op(t, k)>>BAM_CIGAR_SHIFT, _parse_op_char(_parse_op(t, k)));
+			}
+			ridx -= _parse_op_len(t);
+			continue;
+		}
+
+		uint64_t rsidx = ridx;
+		ridx -= parse_count_match_forward(p, lim - ridx, ridx, arr);
+		uint64_t m = (rsidx - ridx)>>1;
+		tbl = m < 4;
+		if(m > 0) {
+			clen += printer(fp, m, 'M');
+			debug("match m(%lld)", m);
+		}
+		if(ridx == 0) { break; }
+
+		arr = parse_load_uint64(p, lim - ridx);
+		uint64_t g = parse_count_gap_forward(p, lim - ridx, ridx, arr);
+		if(g > 0) {
+			clen += printer(fp, g, 'D' + ((char)(0ULL - (arr & 0x01)) & ('I' - 'D')));
+			debug("gap g(%lld)", g);
+		}
+		if((ridx -= g) <= 1) { break; }
+	}
+	return(clen);
 }
 
 /**
- * @fn gaba_dp_add_stack
+ * @fn gaba_dp_dump_cigar_forward
+ * @brief parse path string and store cigar to buffer
+ */
+uint64_t suffix(gaba_dp_dump_cigar_forward)(
+	char *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	uint64_t const filled_len_margin = 5;
+	char *b = buf, *blim = buf + buf_size - filled_len_margin;
+
+	/* convert path to uint64_t pointer */
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	uint64_t lim = offset + (((uint64_t)path & sizeof(uint32_t)) ? 32 : 0) + len;
+	uint64_t ridx = len, tbl = 1;
+
+	debug("path(%p), lim(%lld), ridx(%lld)", p, lim, ridx);
+
+	while(1) {
+		uint64_t arr = parse_load_uint64(p, lim - ridx), t;
+
+		/* short mixed runs, a byte of the path at a time, up to five two-character operations */
+		if(tbl && ridx > 8 && b + 10 <= blim && (t = parse_decode_forward(arr)) != 0) {
+			for(uint64_t k = 0; k < _parse_op_cnt(t); k++) {
+				b += parse_dump_op_string(b, _parse_op(t, k)>>BAM_CIGAR_SHIFT, _parse_op_char(_parse_op(t, k)));
+			}
+			ridx -= _parse_op_len(t);
+			continue;
+		}
+
+		uint64_t rsidx = ridx;
+		ridx -= parse_count_match_forward(p, lim - ridx, ridx, arr);
+		uint64_t m = (rsidx - ridx)>>1;
+		tbl = m < 4;
+		if(m > 0) {
+			b += parse_dump_match_string(b, m);
+			debug("match m(%lld)", m);
+		}
+		if(ridx == 0 || b > blim) { break; }
+
+		arr = parse_load_uint64(p, lim - ridx);
+		uint64_t g = parse_count_gap_forward(p, lim - ridx, ridx, arr);
+		if(g > 0) {
+			b += parse_dump_gap_string(b, g, 'D' + ((char)(0ULL - (arr & 0x01)) & ('I' - 'D')));
+			debug("gap g(%lld)", g);
+		}
+		if((ridx -= g) <= 1 || b > blim) { break; }
+	}
+	*b = '\0';
+	return(b - buf);
+}
+
+/**
+ * @macro _parse_count_match_reverse, _parse_count_gap_reverse
+ */
+#define _parse_count_match_reverse(_arr) ({ \
+	lzcnt((_arr) ^ 0x5555555555555555); \
+})
+#define _parse_count_gap_reverse(_arr) ({ \
+	uint64_t _a = (_arr); \
+	uint64_t mask = (uint64_t)(((int64_t)_a)>>63); \
+	uint64_t gc = lzcnt(_a ^ mask) - ((int64_t)mask + 1); \
+	debug("arr(%llx), mask(%llx), gc(%lld)", _a, mask, gc); \
+	gc; \
+})
+
+/**
+ * @fn parse_count_match_reverse, parse_count_gap_reverse
+ * @brief reverse counterparts of parse_count_match_forward and parse_count_gap_forward,
+ * the window is [pos, pos + 64) and runs are followed downward.
  */
 static _force_inline
-int32_t gaba_dp_add_stack(
-	struct gaba_dp_context_s *this,
-	uint64_t size)
+uint64_t parse_count_match_reverse(
+	uint64_t const *p,
+	int64_t pos,
+	uint64_t rem)
 {
-	if(this->curr_mem->next == NULL) {
-		/* add new block */
-		uint64_t next_size = this->curr_mem->size * 2;
-		struct gaba_mem_block_s *mem = this->curr_mem->next =
-			(struct gaba_mem_block_s *)gaba_aligned_malloc(
-				next_size, MEM_ALIGN_SIZE);
-		if(mem == NULL) { return(GABA_ERROR_OUT_OF_MEM); }
+	uint64_t m = _parse_count_match_reverse(parse_load_uint64(p, pos));
+	if(m == 64 && rem > 64) {
+		uint64_t const pat = 0x5555555555555555ULL<<(pos & 0x01);
+		int64_t k = (pos - 1)>>6, kend = (pos + 64 - (int64_t)rem)>>6;
+		uint64_t x;
+		while((x = p[k] ^ pat) == 0 && k > kend) { k--; }
+		m = pos - 64 * k + lzcnt(x);
+	}
+	return(MIN2(m, rem) & ~0x01);
+}
+static _force_inline
+uint64_t parse_count_gap_reverse(
+	uint64_t const *p,
+	int64_t pos,
+	uint64_t rem,
+	uint64_t arr)
+{
+	uint64_t mask = (uint64_t)(((int64_t)arr)>>63);
+	uint64_t r = lzcnt(arr ^ mask);
+	if(r == 64 && rem > 64) {
+		int64_t k = (pos - 1)>>6, kend = (pos + 64 - (int64_t)rem)>>6;
+		uint64_t x;
+		while((x = p[k] ^ mask) == 0 && k > kend) { k--; }
+		r = pos - 64 * k + lzcnt(x);
+	}
+	/* the last bit of a run of zeros is the tail of the previous diagonal */
+	return(MIN2(r - (mask + 1), rem));
+}
+
+/**
+ * @fn gaba_dp_print_cigar_reverse
+ * @brief parse path string and print cigar to file
+ */
+uint64_t suffix(gaba_dp_print_cigar_reverse)(
+	gaba_dp_printer_t printer,
+	void *fp,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	int64_t clen = 0;
+
+	/* convert path to uint64_t pointer */
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	uint64_t ofs = (int64_t)offset + (((uint64_t)path & sizeof(uint32_t)) ? -32 : -64);
+	uint64_t idx = len;
+
+	debug("path(%p, %x), p(%p, %llx), idx(%lld), mod(%lld)",
+		path, *path, p, *p, idx, idx % 64);
+
+	while(1) {
+		uint64_t sidx = idx;
+		idx -= parse_count_match_reverse(p, idx + ofs, idx);
+		uint64_t m = (sidx - idx)>>1;
+		if(m > 0) {
+			clen += printer(fp, m, 'M');
+			debug("match m(%lld)", m);
+		}
+		if(idx == 0) { break; }
+
+		uint64_t arr = parse_load_uint64(p, idx + ofs);
+		uint64_t g = parse_count_gap_reverse(p, idx + ofs, idx, arr);
+		if(g > 0) {
+			clen += printer(fp, g, 'D' + ((char)(((int64_t)arr)>>63) & ('I' - 'D')));
+			debug("gap g(%lld)", g);
+		}
+		if((idx -= g) <= 1) { break; }
+	}
+	return(clen);
+}
+
+/**
+ * @fn gaba_dp_dump_cigar_reverse
+ * @brief parse path string and store cigar to buffer
+ */
+uint64_t suffix(gaba_dp_dump_cigar_reverse)(
+	char *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	uint64_t const filled_len_margin = 5;
+	char *b = buf, *blim = buf + buf_size - filled_len_margin;
+
+	/* convert path to uint64_t pointer */
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	uint64_t ofs = (int64_t)offset + (((uint64_t)path & sizeof(uint32_t)) ? -32 : -64);
+	uint64_t idx = len;
+
+	while(1) {
+		uint64_t sidx = idx;
+		idx -= parse_count_match_reverse(p, idx + ofs, idx);
+		uint64_t m = (sidx - idx)>>1;
+		if(m > 0) {
+			b += parse_dump_match_string(b, m);
+			debug("match m(%lld)", m);
+		}
+		if(idx == 0 || b > blim) { break; }
+
+		uint64_t arr = parse_load_uint64(p, idx + ofs);
+		uint64_t g = parse_count_gap_reverse(p, idx + ofs, idx, arr);
+		if(g > 0) {
+			b += parse_dump_gap_string(b, g, 'D' + ((char)(((int64_t)arr)>>63) & ('I' - 'D')));
+			debug("gap g(%lld)", g);
+		}
+		if((idx -= g) <= 1 || b > blim) { break; }
+	}
+	*b = '\0';
+	return(b - buf);
+}
+
+/**
+ * @fn gaba_dp_dump_bam_cigar_forward
+ * @brief parse path string and store BAM binary cigar to buffer, returns #operations stored
+ */
+uint64_t suffix(gaba_dp_dump_bam_cigar_forward)(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	uint32_t *b = buf;
+	parse_dump_bam_forward(&b, buf + buf_size, path, offset, len);
+	return(b - buf);
+}
+
+/**
+ * @fn gaba_dp_dump_bam_cigar_reverse
+ * @brief parse path string and store BAM binary cigar to buffer in reverse direction
+ */
+uint64_t suffix(gaba_dp_dump_bam_cigar_reverse)(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	uint32_t *b = buf, *blim = buf + buf_size;
+
+	/* convert path to uint64_t pointer */
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	uint64_t ofs = (int64_t)offset + (((uint64_t)path & sizeof(uint32_t)) ? -32 : -64);
+	uint64_t idx = len;
+
+	while(1) {
+		uint64_t sidx = idx;
+		idx -= parse_count_match_reverse(p, idx + ofs, idx);
+		uint64_t m = (sidx - idx)>>1;
+		if(m > 0) {
+			if(b >= blim) { break; }
+			*b++ = (m<<BAM_CIGAR_SHIFT) | BAM_CIGAR_M;
+		}
+		if(idx == 0) { break; }
+
+		uint64_t arr = parse_load_uint64(p, idx + ofs);
+		uint64_t g = parse_count_gap_reverse(p, idx + ofs, idx, arr);
+		if(g > 0) {
+			if(b >= blim) { break; }
+			*b++ = (g<<BAM_CIGAR_SHIFT) | (BAM_CIGAR_D - (arr>>63));
+		}
+		if((idx -= g) <= 1) { break; }
+	}
+	return(b - buf);
+}
+
+/**
+ * @fn gaba_dp_dump_bam_cigar_batch
+ * @brief store BAM cigars of cnt alignments contiguously to buf. the operations of aln[i]
+ * are placed in [ofs[i], ofs[i + 1]), and ofs must have room for cnt + 1 elements. returns
+ * the number of alignments stored, which is less than cnt when buf is exhausted.
+ */
+uint64_t suffix(gaba_dp_dump_bam_cigar_batch)(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint64_t *ofs,
+	struct gaba_alignment_s const *const *aln,
+	uint64_t cnt)
+{
+	uint32_t *b = buf, *blim = buf + buf_size;
+
+	ofs[0] = 0;
+	for(uint64_t i = 0; i < cnt; i++) {
+		struct gaba_path_rle_s const *rle = aln[i]->rle;
+		if(rle != NULL) {
+			/* already encoded by the trace */
+			if(rle->len > (uint64_t)(blim - b)) { return(i); }
+			memcpy(b, rle->op, sizeof(uint32_t) * rle->len);
+			b += rle->len;
+		} else if(parse_dump_bam_forward(&b, blim, aln[i]->path->array, 0, aln[i]->path->len) != 0) {
+			return(i);				/* the last one is left truncated, not counted */
+		}
+		ofs[i + 1] = b - buf;
+	}
+	return(cnt);
+}
+
+/**
+ * @fn gaba_dp_print_cigar_rle
+ * @brief print cigar from the run-length encoded path
+ */
+uint64_t suffix(gaba_dp_print_cigar_rle)(
+	gaba_dp_printer_t printer,
+	void *fp,
+	struct gaba_path_rle_s const *rle)
+{
+	static char const ch[4] = { 'M', 'I', 'D', 'N' };
+	uint64_t clen = 0;
+	for(uint64_t i = 0; i < rle->len; i++) {
+		clen += printer(fp, rle->op[i]>>BAM_CIGAR_SHIFT, ch[rle->op[i] & 0x03]);
+	}
+	return(clen);
+}
+
+/**
+ * @fn gaba_dp_dump_cigar_rle
+ * @brief store cigar from the run-length encoded path to buffer
+ */
+uint64_t suffix(gaba_dp_dump_cigar_rle)(
+	char *buf,
+	uint64_t buf_size,
+	struct gaba_path_rle_s const *rle)
+{
+	static char const ch[4] = { 'M', 'I', 'D', 'N' };
+	uint64_t const filled_len_margin = 5;
+	char *b = buf, *blim = buf + buf_size - filled_len_margin;
+	for(uint64_t i = 0; i < rle->len && b <= blim; i++) {
+		b += parse_dump_op_string(b, rle->op[i]>>BAM_CIGAR_SHIFT, ch[rle->op[i] & 0x03]);
+	}
+	*b = '\0';
+	return(b - buf);
+}
+
+/**
+ * @struct parse_ext_s
+ * @brief extended cigar (=/X/I/D) and MD tag writer
+ */
+struct parse_ext_s {
+	/* cigar, passed to the printer if not NULL, or stored to the buffer */
+	gaba_dp_printer_t printer;
+	void *fp;
+	char *cb, *cblim;
+	uint64_t clen;
+
+	/* MD tag, skipped if mb is NULL */
+	char *mb, *mblim;
+	int64_t mrun;						/* #matches since the last mismatch or deletion */
+
+	/* pending cigar operation, merged across sections */
+	int64_t plen;
+	char pch, _pad[7];
+
+	/* the down half of a diagonal split at the end of the last section, and its b base */
+	int64_t pend;
+	uint8_t const *pb;
+	int64_t ucnt;						/* #columns and deleted bases not located, MD is dropped if any */
+};
+
+/**
+ * @fn parse_ext_base
+ * @brief load a base as a character, the reverse-complemented side is complemented
+ */
+static _force_inline
+char parse_ext_base(
+	uint8_t const *ptr,
+	uint8_t const *lim)
+{
+	static char const conv[16] = {
+		'N', 'A', 'C', 'M', 'G', 'R', 'S', 'V',
+		'T', 'W', 'Y', 'H', 'K', 'D', 'B', 'N'
+	};
+	static uint8_t const comp[16] = {
+		0x00, 0x08, 0x04, 0x0c, 0x02, 0x0a, 0x06, 0x0e,
+		0x01, 0x09, 0x05, 0x0d, 0x03, 0x0b, 0x07, 0x0f
+	};
+	if(ptr == NULL) { return('N'); }
+	return(conv[(ptr < lim) ? (*ptr & 0x0f) : comp[*((uint8_t const *)_rev(ptr, lim)) & 0x0f]]);
+}
+
+/**
+ * @fn parse_ext_flush
+ */
+static _force_inline
+void parse_ext_flush(
+	struct parse_ext_s *s)
+{
+	if(s->plen == 0) { return; }
+	if(s->printer != NULL) {
+		s->clen += s->printer(s->fp, s->plen, s->pch);
+	} else if(s->cb <= s->cblim) {
+		s->cb += parse_dump_gap_string(s->cb, s->plen, s->pch);
+	}
+	s->plen = 0;
+	return;
+}
+
+/**
+ * @fn parse_ext_push
+ * @brief append len operations of ch, merged to the pending one if the same
+ */
+static _force_inline
+void parse_ext_push(
+	struct parse_ext_s *s,
+	int64_t len,
+	char ch)
+{
+	if(ch != s->pch) {
+		parse_ext_flush(s);
+		s->pch = ch;
+	}
+	s->plen += len;
+	return;
+}
+
+/**
+ * @fn parse_ext_md
+ * @brief append the match count followed by ch to the MD tag
+ */
+static _force_inline
+void parse_ext_md(
+	struct parse_ext_s *s,
+	char ch)
+{
+	if(s->mb == NULL || s->mb > s->mblim) { return; }
+	s->mb += parse_dump_gap_string(s->mb, s->mrun, ch);
+	s->mrun = 0;
+	return;
+}
+
+/**
+ * @fn parse_ext_md_base
+ * @brief append a deleted base to the MD tag
+ */
+static _force_inline
+void parse_ext_md_base(
+	struct parse_ext_s *s,
+	char ch)
+{
+	if(s->mb == NULL || s->mb > s->mblim) { return; }
+	*s->mb++ = ch;
+	return;
+}
+
+/**
+ * @fn parse_ext_walk_diag
+ * @brief len diagonal columns, compared BW bases at a time like _match in the fill loop and
+ * split into = and X on the mismatch mask, or M if either sequence is not located.
+ */
+static _force_inline
+void parse_ext_walk_diag(
+	struct gaba_dp_context_s const *this,
+	uint8_t const *ap,
+	uint8_t const *bp,
+	int64_t len,
+	struct parse_ext_s *s)
+{
+	if(ap == NULL || bp == NULL) {
+		parse_ext_push(s, len, 'M');
+		s->mrun += len;
+		s->ucnt += len;
+		return;
+	}
+	for(int64_t j = 0; j < len; j += BW) {
+		int64_t l = MIN2(len - j, BW);
+		vec_t a = ungapped_load(ap + j, this->w.r.alim);
+		vec_t b = ungapped_load(bp + j, this->w.r.blim);
+		uint64_t mask = ((vec_masku_t){ .mask = _mask(_eq(_match(a, b), _zero())) }).all;
+		mask &= 0xffffffffffffffffULL>>(64 - l);
+
+		/* alternating runs of matches and mismatches */
+		for(int64_t k = 0; k < l;) {
+			int64_t e = MIN2((int64_t)tzcnt(mask>>k), l - k);
+			if(e > 0) {
+				parse_ext_push(s, e, '=');
+				s->mrun += e; k += e;
+				continue;
+			}
+			int64_t x = MIN2((int64_t)tzcnt(~(mask>>k)), l - k);
+			parse_ext_push(s, x, 'X');
+			for(int64_t q = 0; q < x; q++) {
+				parse_ext_md(s, parse_ext_base(ap + j + k + q, this->w.r.alim));
+			}
+			k += x;
+		}
+	}
+	return;
+}
+
+/**
+ * @fn parse_ext_walk_section
+ * @brief walk [spos, epos) of the path on the sequences. a diagonal split at the end of the
+ * section is left pending in s and closed with the head of the next section.
+ */
+static _force_inline
+void parse_ext_walk_section(
+	struct gaba_dp_context_s const *this,
+	uint64_t const *p,
+	int64_t spos,
+	int64_t epos,
+	uint8_t const *ap,
+	uint8_t const *bp,
+	struct parse_ext_s *s)
+{
+	int64_t idx[2] = { 0, 0 };
+	int64_t i = spos;
+
+	/* the right half of the diagonal split at the end of the last section */
+	if(s->pend != 0 && i < epos && (parse_load_uint64(p, i) & 0x01) == 0) {
+		parse_ext_walk_diag(this, (s->pb == NULL) ? NULL : ap, s->pb, 1, s);
+		idx[0]++; i++;
+	} else if(s->pend != 0) {
+		parse_ext_push(s, 1, 'I');
+	}
+	s->pend = 0;
+
+	for(; i < epos;) {
+		uint64_t arr = parse_load_uint64(p, i);
+		int64_t d = MIN2((int64_t)_parse_count_match_forward(arr), epos - i) & ~0x01;
+		if(d > 0) {
+			parse_ext_walk_diag(this,
+				(ap == NULL) ? NULL : ap + idx[0], (bp == NULL) ? NULL : bp + idx[1], d>>1, s);
+			idx[0] += d>>1; idx[1] += d>>1;
+			i += d;
+			continue;
+		}
+
+		/* gap, down (1) consumes b (I), right (0) consumes a (D) */
+		int64_t g = MIN2((int64_t)_parse_count_gap_forward(arr), epos - i), dir = arr & 0x01;
+		if(g <= 0) {
+			/* down of a diagonal split at the end of the section */
+			s->pend = 1;
+			s->pb = (bp == NULL) ? NULL : bp + idx[1];
+			idx[1]++; i++;
+			continue;
+		}
+		if(dir == 0) {
+			/* a deletion continued from the previous section shares the caret */
+			if(s->pch != 'D') { parse_ext_md(s, '^'); }
+			for(int64_t q = 0; q < g; q++) {
+				parse_ext_md_base(s, parse_ext_base((ap == NULL) ? NULL : ap + idx[0] + q, this->w.r.alim));
+			}
+			s->ucnt += (ap == NULL) ? g : 0;
+		}
+		parse_ext_push(s, g, dir ? 'I' : 'D');
+		idx[dir] += g;
+		i += g;
+	}
+	return;
+}
+
+/**
+ * @fn parse_ext_walk
+ * @brief walk all the sections of the alignment, then flush the cigar and close the MD tag
+ */
+static _force_inline
+void parse_ext_walk(
+	struct gaba_dp_context_s const *this,
+	struct gaba_alignment_s const *aln,
+	struct gaba_section_s const *sec,
+	uint32_t slen,
+	struct parse_ext_s *s)
+{
+	/* convert path to uint64_t pointer */
+	uint32_t const *path = aln->path->array;
+	uint64_t const *p = (uint64_t const *)((uint64_t)path & ~(sizeof(uint64_t) - 1));
+	int64_t ofs = ((uint64_t)path & sizeof(uint32_t)) ? 32 : 0;
+
+	for(uint32_t i = 0; i < aln->slen; i++) {
+		struct gaba_path_section_s const *t = &aln->sec[i];
+		uint8_t const *ap = rescore_locate_aln_seq(this, aln, sec, slen, t->aid, 0);
+		uint8_t const *bp = rescore_locate_aln_seq(this, aln, sec, slen, t->bid, 1);
+		parse_ext_walk_section(this, p, ofs + t->ppos, ofs + t->ppos + _plen(t),
+			(ap == NULL) ? NULL : ap + (int32_t)t->apos, (bp == NULL) ? NULL : bp + (int32_t)t->bpos, s);
+	}
+	if(s->pend != 0) { parse_ext_push(s, 1, 'I'); }
+	parse_ext_flush(s);
+
+	/* MD ends with the match count; the trailing character is overwritten by the terminator */
+	if(s->mb != NULL && s->mb <= s->mblim) {
+		s->mb += parse_dump_gap_string(s->mb, s->mrun, '\0') - 1;
+	}
+	return;
+}
+
+/**
+ * @fn gaba_dp_print_cigar_ext
+ * @brief print extended cigar (=/X/I/D) of the alignment, comparing the bases on the sections
+ */
+uint64_t suffix(gaba_dp_print_cigar_ext)(
+	struct gaba_dp_context_s *this,
+	gaba_dp_printer_t printer,
+	void *fp,
+	struct gaba_alignment_s const *aln,
+	struct gaba_section_s const *sec,
+	uint32_t slen)
+{
+	struct parse_ext_s s = { .printer = printer, .fp = fp };
+	parse_ext_walk(this, aln, sec, slen, &s);
+	return(s.clen);
+}
+
+/**
+ * @fn gaba_dp_dump_cigar_ext
+ * @brief store extended cigar and MD tag (if md is not NULL) of the alignment in one pass
+ */
+uint64_t suffix(gaba_dp_dump_cigar_ext)(
+	struct gaba_dp_context_s *this,
+	char *buf,
+	uint64_t buf_size,
+	char *md,
+	uint64_t md_size,
+	struct gaba_alignment_s const *aln,
+	struct gaba_section_s const *sec,
+	uint32_t slen)
+{
+	uint64_t const filled_len_margin = 16;
+	struct parse_ext_s s = {
+		.cb = buf,
+		.cblim = buf + buf_size - filled_len_margin,
+		.mb = md,
+		.mblim = (md == NULL) ? NULL : md + md_size - filled_len_margin
+	};
+	parse_ext_walk(this, aln, sec, slen, &s);
+	*s.cb = '\0';
+	if(md != NULL) { *((s.ucnt != 0) ? md : s.mb) = '\0'; }
+	return(s.cb - buf);
+}
+
+/**
+ * @fn gaba_dp_rescore
+ * @brief rescore the alignment on the sequences of sec under params (the scores of the dp
+ * context if NULL), without filling again.
+ */
+struct gaba_rescore_s suffix(gaba_dp_rescore)(
+	struct gaba_dp_context_s *this,
+	struct gaba_alignment_s const *aln,
+	struct gaba_section_s const *sec,
+	uint32_t slen,
+	struct gaba_params_s const *params)
+{
+	struct rescore_acc_s acc = rescore_walk_alignment(this, aln, sec, slen);
+
+	/* penalties in positive integers, restored from the dp context if NULL */
+	int64_t m = this->m, x = -this->x, gi = -this->gi, ge = -this->ge;
+	if(params != NULL) {
+		m = params->m; x = params->x; gi = params->gi; ge = params->ge;
+	}
+
+	int64_t gecnt = acc.gecnt[0] + acc.gecnt[1], len = acc.mcnt + acc.xcnt + acc.acnt + gecnt;
+	return((struct gaba_rescore_s){
+		.score = m * (acc.mcnt + acc.acnt + acc.ucnt) - x * acc.xcnt - gi * acc.gicnt - ge * gecnt,
+		.mcnt = acc.mcnt,
+		.xcnt = acc.xcnt,
+		.gicnt = acc.gicnt,
+		.gecnt = gecnt,
+		.identity = (len == 0) ? 0.0 : (double)acc.mcnt / (double)len,
+		.acnt = acc.acnt,
+		.ucnt = acc.ucnt
+	});
+}
+
+/**
+ * @fn extract_max, extract_min
+ * @brief extract max /min value from 8-bit 16-cell vector
+ */
+static _force_inline
+int8_t extract_max(int8_t const vector[][4])
+{
+	int8_t *v = (int8_t *)vector;
+	int8_t max = -128;
+	for(int i = 0; i < 16; i++) {
+		max = (v[i] > max) ? v[i] : max;
+	}
+	return(max);
+}
+static _force_inline
+int8_t extract_min(int8_t const vector[][4])
+{
+	int8_t *v = (int8_t *)vector;
+	int8_t min = 127;
+	for(int i = 0; i < 16; i++) {
+		min = (v[i] < min) ? v[i] : min;
+	}
+	return(min);
+}
+
+/**
+ * @fn gaba_init_restore_default_params
+ */
+static _force_inline
+void gaba_init_restore_default_params(
+	struct gaba_params_s *params)
+{
+	#define restore(_name, _default) { \
+		params->_name = ((uint64_t)(params->_name) == 0) ? (_default) : (params->_name); \
+	}
+	if(params->m == 0 && params->x == 0 && params->gi == 0 && params->ge == 0) {
+		params->m = 1;
+		params->x = 1;
+		params->gi = 1;
+		params->ge = 1;
+	}
+	restore(xdrop, 				50);
+	restore(filter_thresh,		0);
+	restore(head_margin, 		0);
+	restore(tail_margin, 		0);
+	return;
+}
+
+/**
+ * @fn gaba_init_check_score
+ * @brief return non-zero if the score is not applicable
+ */
+static _force_inline
+int gaba_init_check_score(
+	struct gaba_params_s const *params)
+{
+	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
+
+	#if MODEL == LINEAR
+		if(m - 2 * (ge + gi) > 255) { return(-1); }
+		if((ge + gi) > 0) { return(-1); }
+	#else
+		if(m - 2 * (ge + gi) > 31) { return(-1); }
+		if(ge < gi) { return(-1); }
+		if((ge + gi) < -7) { return(-1); }
+	#endif
+	return(0);
+}
+
+/**
+ * @fn gaba_init_create_score_vector
+ */
+static _force_inline
+struct gaba_score_vec_s gaba_init_create_score_vector(
+	struct gaba_params_s const *params)
+{
+	int8_t m = params->m, x = -params->x, ge = -params->ge, gi = -params->gi;
+	int8_t sb[16] __attribute__(( aligned(16) ));
+	struct gaba_score_vec_s sc __attribute__(( aligned(BW) ));
+
+	sb[0] = x - 2 * (ge + gi);
+	for(int i = 1; i < 16; i++) {
+		sb[i] = m - 2 * (ge + gi);
+	}
+	_store_sb(sc, _load_v16i8(sb));
+
+	#if MODEL == LINEAR
+		_store_adjh(sc, 0, 0, ge + gi, ge + gi);
+		_store_adjv(sc, 0, 0, ge + gi, ge + gi);
+		_store_ofsh(sc, 0, 0, ge + gi, ge + gi);
+		_store_ofsv(sc, 0, 0, ge + gi, ge + gi);
+	#else
+		_store_adjh(sc, -gi, -gi, -(ge + gi), ge + gi);
+		_store_adjv(sc, -gi, -gi, -(ge + gi), ge + gi);
+		_store_ofsh(sc, -gi, -gi, -(ge + gi), ge + gi);
+		_store_ofsv(sc, -gi, -gi, -(ge + gi), ge + gi);
+	#endif
+	return(sc);
+}
+
+/**
+ * @fn gaba_init_create_dir_dynamic
+ */
+static _force_inline
+union gaba_dir_u gaba_init_create_dir_dynamic(
+	struct gaba_params_s const *params)
+{
+	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
+
+	#if MODEL == LINEAR
+		int16_t coef = -m + 2 * (ge + gi);
+		int16_t ofs = 0;
+	#else
+		int16_t coef = -m + 2 * ge;
+		int16_t ofs = gi;
+	#endif
+
+	int64_t acc = (ofs + coef * BW/2) - (ofs + coef * (BW/2 - 1));
+	#if STEER == CENTER
+		acc = 0;	/* start on the diagonal, alternating right and down */
+	#endif
+	return((union gaba_dir_u) {
+		.dynamic = {
+			.acc = acc,
+			.array = 0x80000000	/* (0, 0) -> (0, 1) (down) */
+		}
+	});
+}
+
+/**
+ * @fn gaba_init_create_small_delta
+ */
+static _force_inline
+struct gaba_small_delta_s gaba_init_create_small_delta(
+	struct gaba_params_s const *params)
+{
+	int8_t relax = -128 / BW;
+
+	struct gaba_small_delta_s sd;
+	#if MODEL == LINEAR
+		for(int i = 0; i < BW/2; i++) {
+			sd.delta[i] = relax * (BW/2 - i);
+			sd.delta[BW/2 + i] = relax * i;
+			sd.max[i] = relax * (BW/2 - i);
+			sd.max[BW/2 + i] = relax * i;
+		}
+	#else
+		for(int i = 0; i < BW/2; i++) {
+			sd.delta[i] = relax * (BW/2 - i);
+			sd.delta[BW/2 + i] = relax * i;
+			sd.max[i] = relax * (BW/2 - i);
+			sd.max[BW/2 + i] = relax * i;
+		}
+	#endif
+
+	return(sd);
+}
+
+/**
+ * @fn gaba_init_create_middle_delta
+ */
+static _force_inline
+struct gaba_middle_delta_s gaba_init_create_middle_delta(
+	struct gaba_params_s const *params)
+{
+	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
+	int8_t relax = 128 / BW;
+
+	#if MODEL == LINEAR
+		int16_t coef = -m + 2 * (ge + gi) + relax;
+		int16_t ofs = 0;
+	#else
+		int16_t coef = -m + 2*ge + relax;
+		int16_t ofs = gi;
+	#endif
+
+	struct gaba_middle_delta_s md;
+	for(int i = 0; i < BW/2; i++) {
+		md.delta[i] = ofs + coef * (BW/2 - i);
+		md.delta[BW/2 + i] = ofs + coef * i;
+	}
+	md.delta[BW/2] = 0;
+	return(md);
+}
+
+/**
+ * @fn gaba_init_create_diff_vectors
+ *
+ * @detail
+ * dH[i, j] = S[i, j] - S[i - 1, j]
+ * dV[i, j] = S[i, j] - S[i, j - 1]
+ * dE[i, j] = E[i, j] - S[i, j]
+ * dF[i, j] = F[i, j] - S[i, j]
+ */
+#if MODEL == LINEAR
+static _force_inline
+struct gaba_diff_vec_s gaba_init_create_diff_vectors(
+	struct gaba_params_s const *params)
+{
+	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
+	int8_t drop = 0;
+	int8_t raise = m - 2 * (ge + gi);
+
+	int8_t dh[BW] __attribute__(( aligned(BW) ));
+	int8_t dv[BW] __attribute__(( aligned(BW) ));
+
+	struct gaba_diff_vec_s diff __attribute__(( aligned(BW) ));
+	/**
+	 * dh: dH[i, j] - gh
+	 * dv: dV[i, j] - gv
+	 */
+	/* calc dh and dv */
+	for(int i = 0; i < BW/2; i++) {
+		dh[i] = drop;
+		dh[BW/2 + i] = raise;
+		dv[i] = raise;
+		dv[BW/2 + i] = drop;
+	}
+ 	dh[BW/2] = raise;
+ 	dv[BW/2] = raise;
+
+	_store(&diff.dh, _load(dh));
+	_store(&diff.dv, _load(dv));
+	return(diff);
+}
+#else
+static _force_inline
+struct gaba_diff_vec_s gaba_init_create_diff_vectors(
+	struct gaba_params_s const *params)
+{
+	int8_t m = params->m, ge = -params->ge, gi = -params->gi;
+
+	int8_t ofs_dh = -(ge + gi);
+	int8_t ofs_dv = -(ge + gi);
+	int8_t ofs_de = -gi;
+	int8_t ofs_df = -gi;
+	
+	int8_t drop_dh = ge + ofs_dh;
+	int8_t raise_dh = m - ge + ofs_dh;
+	int8_t drop_dv = ge + ofs_dv;
+	int8_t raise_dv = m - ge + ofs_dv;
+	int8_t drop_de = gi + ofs_de;
+	int8_t raise_de = ofs_de;
+	int8_t drop_df = gi + ofs_df;
+	int8_t raise_df = ofs_df;
+
+	int8_t dh[BW] __attribute__(( aligned(BW) ));
+	int8_t dv[BW] __attribute__(( aligned(BW) ));
+	int8_t de[BW] __attribute__(( aligned(BW) ));
+	int8_t df[BW] __attribute__(( aligned(BW) ));
+
+	struct gaba_diff_vec_s diff __attribute__(( aligned(BW) ));
+	/**
+	 * dh: dH[i, j] - ge
+	 * dv: dV[i, j] - gev
+	 * de: dE[i, j] + gi + dV[i, j] - gev
+	 * df: dF[i, j] + gi + dH[i, j] - ge
+	 */
+	/* calc dh and dv */
+	for(int i = 0; i < BW/2; i++) {
+		dh[i] = drop_dh;
+		dh[BW/2 + i] = raise_dh;
+		dv[i] = raise_dv;
+		dv[BW/2 + i] = drop_dv;
+	}
+ 	dh[BW/2] = raise_dh - gi;
+ 	dv[BW/2] = raise_dv - gi;
+
+	/* calc de and df */
+ 	for(int i = 0; i < BW/2; i++) {
+ 		de[i] = raise_de;
+ 		de[BW/2 + i] = drop_de;
+ 		df[i] = drop_df;
+ 		df[BW/2 + i] = raise_df;
+ 	}
+ 	de[BW/2] = drop_de;
+ 	df[BW/2] = drop_df;
+
+ 	vec_t _dh = _load(dh);
+ 	vec_t _dv = _load(dv);
+ 	vec_t _de = _load(de);
+ 	vec_t _df = _load(df);
+
+ 	_print(_dh);
+ 	_print(_dv);
+ 	_print(_de);
+ 	_print(_df);
+
+	_dh = _shl(_dh, 3);
+	_dv = _shl(_dv, 3);
+	_store(&diff.dh, _add(_dh, _de));
+	_store(&diff.dv, _add(_dv, _df));
+	_print(_add(_dh, _de));
+	_print(_add(_dv, _df));
+
+	return(diff);
+}
+#endif
+
+/**
+ * @fn gaba_init_create_char_vector
+ */
+static _force_inline
+struct gaba_char_vec_s gaba_init_create_char_vector(
+	void)
+{
+	struct gaba_char_vec_s ch;
+
+	for(int i = 0; i < BW; i++) {
+		ch.w[i] = 0;
+	}
+	return(ch);
+}
+
+/**
+ * @fn gaba_init
+ */
+gaba_t *suffix(gaba_init)(
+	struct gaba_params_s const *params)
+{
+	if(params == NULL) {
+		debug("params must not be NULL");
+		return(NULL);
+	}
+
+	/* copy params to local stack */
+	struct gaba_params_s params_intl = *params;
+
+	/* restore defaults */
+	gaba_init_restore_default_params(&params_intl);
+
+	/* check the scores are applicable */
+	if(gaba_init_check_score(&params_intl) != 0) {
+		return(NULL);
+	}
+
+	/* malloc gaba_context_s */
+	struct gaba_context_s *ctx = (struct gaba_context_s *)gaba_aligned_malloc(
+		sizeof(struct gaba_context_s),
+		MEM_ALIGN_SIZE);
+	if(ctx == NULL) {
+		return(NULL);
+	}
+
+	/* fill context */
+	*ctx = (struct gaba_context_s) {
+		/* template */
+		.k = (struct gaba_dp_context_s) {
+			/* memory management */
+			.mem = { 0 },
+			.curr_mem = NULL,
+			.stack_top = NULL,						/* stored on init */
+			.stack_end = NULL,						/* stored on init */
+
+			/* score vectors */
+			.scv = gaba_init_create_score_vector(&params_intl),
+			.m = params_intl.m,
+			.x = -params_intl.x,
+			.gi = (MODEL == LINEAR)
+				? 0
+				: -params_intl.gi,
+			.ge = (MODEL == LINEAR)
+				? -(params_intl.gi + params_intl.ge)
+				: -params_intl.ge,
+			.tx = (params_intl.mode == GABA_MODE_GLOBAL)
+				? INT8_MAX		/* never below the center-lane drop */
+				: params_intl.xdrop,
+			.tf = params_intl.filter_thresh,
+
+			/* input and output options */
+			.head_margin = _roundup(params_intl.head_margin, MEM_ALIGN_SIZE),
+			.tail_margin = _roundup(params_intl.tail_margin, MEM_ALIGN_SIZE),
+			.mode = params_intl.mode,
+			.eb = MIN2(params_intl.ebonus, INT8_MAX),
+			.rc = MIN2(params_intl.recenter, INT8_MAX),
+			.bias = 0,
+			.ut = params_intl.ungapped,
+			.ur = 0,
+			.ts = (params_intl.score_stop == 0) ? INT64_MAX : params_intl.score_stop,
+			.tc = INT64_MAX,
+
+			/* phantom block at root */
+			.blk = (struct gaba_phantom_block_s) {
+				/* direction array */
+				.dir = gaba_init_create_dir_dynamic(&params_intl),
+				
+				/* offset, diffs and deltas */
+				.offset = 0,
+				.diff = gaba_init_create_diff_vectors(&params_intl),
+				.sd = gaba_init_create_small_delta(&params_intl),
+				.md = &ctx->md,
+
+				/* char vectors */
+				.ch = gaba_init_create_char_vector(),
+
+				/* indices */
+				.aridx = 0,
+				.bridx = 0
+			},
+
+			/* tail of root section */
+			.tail = (struct gaba_joint_tail_s) {
+				/* coordinates */
+				.psum = PSUM_BASE - BW,
+				.p = 0,
+				.ssum = 0,
+
+				/* max */
+				.max = 0,
+
+				/* status */
+				.stat = CONT,
+
+				/* internals */
+				.mblk = 0,
+				.tail = NULL,
+				.apos = 0,
+				.bpos = 0,
+				.alen = 0,
+				.blen = 0,
+				.aid = 0xfffc,
+				.bid = 0xfffd
+			},
+		},
+
+		/* default middle delta vector */
+		.md = gaba_init_create_middle_delta(&params_intl)
+	};
+
+	return((gaba_t *)ctx);
+}
+
+/**
+ * @fn gaba_clean
+ */
+void suffix(gaba_clean)(
+	struct gaba_context_s *ctx)
+{
+	gaba_aligned_free(ctx);
+	return;
+}
+
+/**
+ * @fn gaba_dp_init
+ */
+struct gaba_dp_context_s *suffix(gaba_dp_init)(
+	struct gaba_context_s const *ctx,
+	uint8_t const *alim,
+	uint8_t const *blim)
+{
+	/* malloc stack memory */
+	struct gaba_dp_context_s *this = (struct gaba_dp_context_s *)gaba_aligned_malloc(
+		MEM_INIT_SIZE, MEM_ALIGN_SIZE);
+	if(this == NULL) {
+		debug("failed to malloc memory");
+		return(NULL);
+	}
+
+	/* init stack pointers */
+	this->stack_top = (uint8_t *)(this + 1);
+	this->stack_end = (uint8_t *)this + MEM_INIT_SIZE - MEM_MARGIN_SIZE;
+
+	/* init seq lims */
+	this->w.r.alim = alim;
+	this->w.r.blim = blim;
+
+	/* copy template */
+	_memcpy_blk_aa(
+		(uint8_t *)this + GABA_DP_CONTEXT_LOAD_OFFSET,
+		(uint8_t *)&ctx->k + GABA_DP_CONTEXT_LOAD_OFFSET,
+		GABA_DP_CONTEXT_LOAD_SIZE);
+
+	/* init mem object */
+	this->curr_mem = &this->mem;
+	this->mem = (struct gaba_mem_block_s){
+		.next = NULL,
+		.prev = NULL,
+		.size = MEM_INIT_SIZE
+	};
+	return(this);
+}
+
+/**
+ * @fn gaba_dp_add_stack
+ */
+static _force_inline
+int32_t gaba_dp_add_stack(
+	struct gaba_dp_context_s *this,
+	uint64_t size)
+{
+	if(this->curr_mem->next == NULL) {
+		/* add new block */
+		uint64_t next_size = this->curr_mem->size * 2;
+		struct gaba_mem_block_s *mem = this->curr_mem->next =
+			(struct gaba_mem_block_s *)gaba_aligned_malloc(
+				next_size, MEM_ALIGN_SIZE);
+		if(mem == NULL) { return(GABA_ERROR_OUT_OF_MEM); }
+
+		mem->next = NULL;
+		mem->prev = this->curr_mem;
+		mem->size = next_size;
+	}
+
+	/* follow the forward link */
+	this->curr_mem = this->curr_mem->next;
+
+	/* init stack pointers */
+	this->stack_top = (uint8_t *)(this->curr_mem + 1);
+	this->stack_end = (uint8_t *)this->curr_mem + this->curr_mem->size - MEM_MARGIN_SIZE;
+	return(GABA_SUCCESS);
+}
+
+/**
+ * @fn gaba_dp_flush
+ */
+void suffix(gaba_dp_flush)(
+	struct gaba_dp_context_s *this,
+	uint8_t const *alim,
+	uint8_t const *blim)
+{
+	/* init seq lims */
+	this->w.r.alim = alim;
+	this->w.r.blim = blim;
+
+	this->curr_mem = &this->mem;
+	this->stack_top = (uint8_t *)(this + 1);
+	this->stack_end = (uint8_t *)this + this->mem.size - MEM_MARGIN_SIZE;
+	return;
+}
+
+/**
+ * @fn gaba_dp_save_stack
+ */
+struct gaba_stack_s const *suffix(gaba_dp_save_stack)(
+	struct gaba_dp_context_s *this)
+{
+	struct gaba_mem_block_s *mem = this->curr_mem;
+	uint8_t *stack_top = this->stack_top;
+	uint8_t *stack_end = this->stack_end;
+
+	/* save */
+	struct gaba_stack_s *stack = (struct gaba_stack_s *)gaba_dp_malloc(
+		this, sizeof(struct gaba_stack_s));
+	stack->mem = mem;
+	stack->stack_top = stack_top;
+	stack->stack_end = stack_end;
+	debug("save stack(%p, %p, %p)", stack->mem, stack->stack_top, stack->stack_end);
+	return(stack);
+}
+
+/**
+ * @fn gaba_dp_flush_stack
+ */
+void suffix(gaba_dp_flush_stack)(
+	struct gaba_dp_context_s *this,
+	gaba_stack_t const *stack)
+{
+	if(stack == NULL) {
+		return;
+	}
+
+	this->curr_mem = stack->mem;
+	this->stack_top = stack->stack_top;
+	this->stack_end = stack->stack_end;
+	debug("restore stack(%p, %p, %p)", stack->mem, stack->stack_top, stack->stack_end);
+	return;
+}
+
+/**
+ * @fn gaba_dp_malloc
+ */
+static _force_inline
+void *gaba_dp_malloc(
+	struct gaba_dp_context_s *this,
+	uint64_t size)
+{
+	/* roundup */
+	size = _roundup(size, MEM_ALIGN_SIZE);
+
+	/* malloc */
+	debug("this(%p), stack_top(%p), size(%llu)", this, this->stack_top, size);
+	if((uint64_t)(this->stack_end - this->stack_top) < size) {
+		if(gaba_dp_add_stack(this, size) != GABA_SUCCESS) {
+			return(NULL);
+		}
+		debug("stack_top(%p)", this->stack_top);
+	}
+	this->stack_top += size;
+	return((void *)(this->stack_top - size));
+}
+
+/**
+ * @fn gaba_dp_clean
+ */
+void suffix(gaba_dp_clean)(
+	struct gaba_dp_context_s *this)
+{
+	if(this == NULL) {
+		return;
+	}
+
+	struct gaba_mem_block_s *m = this->mem.next;
+	while(m != NULL) {
+		struct gaba_mem_block_s *mnext = m->next;
+		free(m); m = mnext;
+	}
+	gaba_aligned_free(this);
+	return;
+}
+
+/* unittests */
+#if UNITTEST == 1
+
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * @fn unittest_build_context
+ * @brief build context for unittest
+ */
+#if MODEL == LINEAR
+static struct gaba_params_s const *unittest_default_params = GABA_PARAMS(
+	.xdrop = 100,
+	GABA_SCORE_SIMPLE(2, 3, 0, 6));
+#else
+static struct gaba_params_s const *unittest_default_params = GABA_PARAMS(
+	.xdrop = 100,
+	GABA_SCORE_SIMPLE(2, 3, 5, 1));
+#endif
+static
+void *unittest_build_context(void *params)
+{
+	/* build context */
+	gaba_t *ctx = gaba_init(unittest_default_params);
+	return((void *)ctx);
+}
+
+/**
+ * @fn unittest_clean_context
+ */
+static
+void unittest_clean_context(void *ctx)
+{
+	gaba_clean((struct gaba_context_s *)ctx);
+	return;
+}
+
+/**
+ * @struct unittest_seqs_s
+ * @brief sequence container
+ */
+struct unittest_seqs_s {
+	char const *a;
+	char const *b;
+};
+#define unittest_seq_pair(_a, _b) ( \
+	(void *)&((struct unittest_seqs_s const){ \
+		.a = _a "GGGGGGGGGGGGGGGGGGGG", \
+		.b = _b "CCCCCCCCCCCCCCCCCCCC" \
+	}) \
+)
+
+/**
+ * @struct unittest_sections_s
+ * @brief section container
+ */
+struct unittest_sections_s {
+	uint8_t const *a, *b;
+	uint8_t const *alim, *blim;
+	uint64_t alen, blen;
+	struct gaba_section_s afsec, aftail, bfsec, bftail;
+	struct gaba_section_s arsec, artail, brsec, brtail;
+	struct gaba_section_s assec, bssec;
+};
+
+/**
+ * @fn unittest_encode_base
+ * @brief mapping IUPAC amb. to 2bit / 4bit encoding
+ */
+static _force_inline
+uint8_t unittest_encode_base(
+	char c)
+{
+	/* convert to upper case and subtract offset by 0x40 */
+	#define _b(x)	( (x) & 0x1f )
+
+	/* conversion tables */
+	enum bases { A = 0x01, C = 0x02, G = 0x04, T = 0x08 };
+	static uint8_t const table[] = {
+		[_b('A')] = A,
+		[_b('C')] = C,
+		[_b('G')] = G,
+		[_b('T')] = T,
+		[_b('U')] = T,
+		[_b('R')] = A | G,
+		[_b('Y')] = C | T,
+		[_b('S')] = G | C,
+		[_b('W')] = A | T,
+		[_b('K')] = G | T,
+		[_b('M')] = A | C,
+		[_b('B')] = C | G | T,
+		[_b('D')] = A | G | T,
+		[_b('H')] = A | C | T,
+		[_b('V')] = A | C | G,
+		[_b('N')] = 0,		/* treat 'N' as a gap */
+		[_b('_')] = 0		/* sentinel */
+	};
+	return(table[_b((uint8_t)c)]);
+
+	#undef _b
+}
+
+/**
+ * @fn unittest_build_seqs
+ * @brief build seq_pair and sections
+ */
+static
+void *unittest_build_seqs(void *params)
+{
+	struct unittest_seqs_s const *seqs = (struct unittest_seqs_s const *)params;
+	char const *a = seqs->a;
+	char const *b = seqs->b;
+
+	uint64_t atot = strlen(a);
+	uint64_t btot = strlen(b);
+	uint32_t alen = atot - 20;
+	uint32_t blen = btot - 20;
+
+	uint64_t margin = 64;
+	struct unittest_sections_s *sec = malloc(
+		sizeof(struct unittest_sections_s) + (atot + 1) + (btot + 1) + margin);
+
+	/* copy sequences */
+	uint8_t *ca = (uint8_t *)(sec + 1);
+	uint8_t *cb = ca + atot + 1;
+	uint8_t *cm = cb + btot + 1;
+
+	for(uint64_t i = 0; i < atot; i++) {
+		ca[i] = unittest_encode_base(a[i]);
+	}
+	for(uint64_t i = 0; i < btot; i++) {
+		cb[i] = unittest_encode_base(b[i]);
+	}
+	ca[atot] = cb[btot] = '\0';
+	memset(cm, 0, margin);
+
+	/* build context */
+	uint8_t const *const alim = (void const *)0x800000000000;
+	uint8_t const *const blim = (void const *)0x800000000000;
+	*sec = (struct unittest_sections_s){
+		.a = ca,
+		.b = cb,
+		.alim = alim,
+		.blim = blim,
+		.alen = atot,
+		.blen = btot,
+		
+		/* forward */
+		.afsec = gaba_build_section(0, ca, alen),
+		.aftail = gaba_build_section(2, ca + alen, 20),
+		.bfsec = gaba_build_section(4, cb, blen),
+		.bftail = gaba_build_section(6, cb + blen, 20),
+
+		/* reverse */
+		.arsec = gaba_build_section(1, _rev(ca + alen - 1, alim), alen),
+		.artail = gaba_build_section(3, _rev(ca + atot - 1, alim), 20),
+		.brsec = gaba_build_section(5, _rev(cb + blen - 1, blim), blen),
+		.brtail = gaba_build_section(7, _rev(cb + btot - 1, blim), 20),
+
+		/* seed section */
+		.assec = gaba_build_section(100, ca, 14),
+		.bssec = gaba_build_section(102, cb, 14)
+	};
+	return((void *)sec);
+}
+
+/**
+ * @fn unittest_clean_seqs
+ */
+static
+void unittest_clean_seqs(void *ctx)
+{
+	free(ctx);
+}
+
+/**
+ * @macro with_seq_pair
+ * @brief constructs .param, .init, and .clean parameters
+ */
+#define with_seq_pair(_a, _b) \
+	.params = unittest_seq_pair(_a, _b), \
+	.init = unittest_build_seqs, \
+	.clean = unittest_clean_seqs
+
+/**
+ * misc macros and functions for assertion
+ */
+#define check_tail(_t, _max, _p, _psum, _ssum) ( \
+	   (_t) != NULL \
+	&& (_t)->max == (_max) \
+	&& (_t)->p == (_p) \
+	&& (_t)->psum == (_psum) \
+	&& (_t)->ssum == (_ssum) \
+)
+#define print_tail(_t) \
+	"tail(%p), max(%lld), p(%d), psum(%lld), ssum(%u)", \
+	(_t), (_t)->max, (_t)->p, (_t)->psum, (_t)->ssum
+#define check_result(_r, _score, _xcnt, _plen, _slen, _rsidx, _rppos, _rapos, _rbpos) ( \
+	   (_r) != NULL \
+	&& (_r)->sec != NULL \
+	&& (_r)->path != NULL \
+	&& (_r)->path->len == (_plen) \
+	&& (_r)->slen == (_slen) \
+	&& (_r)->score == (_score) \
+	&& (_r)->xcnt == (_xcnt) \
+	&& (_r)->rsidx == (_rsidx) \
+	&& (_r)->rppos == (_rppos) \
+	&& (_r)->rapos == (_rapos) \
+	&& (_r)->rbpos == (_rbpos) \
+)
+#define print_result(_r) \
+	"res(%p), score(%lld), xcnt(%lld), plen(%u), slen(%u), rsid(%u), rppos(%u), rapos(%u), rbpos(%u)", \
+	(_r), (_r)->score, (_r)->xcnt, (_r)->path->len, (_r)->slen, (_r)->rsidx, (_r)->rppos, (_r )->rapos, (_r)->rbpos
+
+static
+int check_path(
+	struct gaba_alignment_s const *aln,
+	char const *str)
+{
+	int64_t plen = aln->path->len, slen = strlen(str);
+	uint32_t const *p = aln->path->array;
+	debug("%s", str);
+
+	/* first check length */
+	if(plen != slen) {
+		debug("plen(%lld), slen(%lld)", plen, slen);
+		return(0);
+	}
+
+	/* next compare encoded string (bit string) */
+	while(plen > 0) {
+		uint32_t array = 0;
+		for(int64_t i = 0; i < 32; i++) {
+			if(plen-- == 0) {
+				array = (array>>(32 - i)) | ((uint64_t)0x55555555<<i);
+				break;
+			}
+			array = (array>>1) | ((*str++ == 'D') ? 0x80000000 : 0);
+			debug("%c, %x", str[-1], array);
+		}
+		debug("path(%x), array(%x)", *p, array);
+		if(*p++ != array) {
+			return(0);
+		}
+	}
+	return(1);
+}
+
+static
+int check_cigar(
+	struct gaba_alignment_s const *aln,
+	char const *cigar)
+{
+	char buf[1024];
+
+	debug("path(%x), len(%lld)", aln->path->array[0], aln->path->len);
+
+	uint64_t l = gaba_dp_dump_cigar_forward(
+		buf, 1024, aln->path->array, 0, aln->path->len);
+
+	debug("cigar(%s)", buf);
+
+	/* first check length */
+	if(strlen(cigar) != l) { return(0); }
+
+	/* next compare cigar string */
+	return((strcmp(buf, cigar) == 0) ? 1 : 0);
+}
+
+#define decode_path(_r) ({ \
+	uint64_t plen = (_r)->path->len, cnt = 0; \
+	uint32_t const *path = (_r)->path->array; \
+	uint32_t path_array = *path; \
+	char *ptr = alloca(plen); \
+	char *p = ptr; \
+ 	while(plen-- > 0) { \
+		*p++ = (path_array & 0x01) ? 'D' : 'R'; \
+		path_array >>= 1; \
+		if(++cnt == 32) { \
+			path_array = *++path; \
+			cnt = 0; \
+		} \
+	} \
+	*p = '\0'; \
+	ptr; \
+})
+#define print_path(_r)			"%s", decode_path(_r)
+#define check_section(_s, _a, _apos, _alen, _b, _bpos, _blen, _ppos, _pl) ( \
+	   (_s).aid == (_a).id \
+	&& (_s).apos == (_apos) \
+	&& (_s).alen == (_alen) \
+	&& (_s).bid == (_b).id \
+	&& (_s).bpos == (_bpos) \
+	&& (_s).blen == (_blen) \
+	&& (_s).ppos == (_ppos) \
+	&& _plen(&(_s)) == (_pl) \
+)
+#define print_section(_s) \
+	"a(%u), apos(%u), alen(%u), b(%u), bpos(%u), blen(%u), ppos(%u), plen(%u)", \
+	(_s).aid, (_s).apos, (_s).alen, \
+	(_s).bid, (_s).bpos, (_s).blen, \
+	(_s).ppos, _plen(&(_s))
+
+/* global configuration of the tests */
+unittest_config(
+	.name = "gaba",
+	.init = unittest_build_context,
+	.clean = unittest_clean_context
+);
+
+/**
+ * check if gaba_init returns a valid pointer to a context
+ */
+unittest()
+{
+	struct gaba_context_s const *c = (struct gaba_context_s const *)gctx;
+	assert(c != NULL, "%p", c);
+}
+
+/**
+ * check if unittest_build_seqs returns a valid seq_pair and sections
+ */
+unittest(with_seq_pair("A", "A"))
+{
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+
+	/* check pointer */
+	assert(s != NULL, "%p", s);
+
+	/* check sequences */
+	assert(strncmp((char const *)s->a,
+		"\x01\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\0",
+		22) == 0, "%s", (char const *)s->a);
+	assert(strncmp((char const *)s->b,
+		"\x01\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\0",
+		22) == 0, "%s", (char const *)s->b);
+	assert(s->alen == 21, "%llu", s->alen);
+	assert(s->blen == 21, "%llu", s->blen);
+
+	/* check forward sections */
+	assert(s->afsec.id == 0, "%d", s->afsec.id);
+	assert((uintptr_t)s->afsec.base == (uintptr_t)s->a + 0, "%p", s->afsec.base);
+	assert(s->afsec.len == 1, "%u", s->afsec.len);
+
+	assert(s->aftail.id == 2, "%d", s->aftail.id);
+	assert((uintptr_t)s->aftail.base == (uintptr_t)s->a + 1, "%p", s->aftail.base);
+	assert(s->aftail.len == 20, "%u", s->aftail.len);
+
+	assert(s->bfsec.id == 4, "%d", s->bfsec.id);
+	assert((uintptr_t)s->bfsec.base == (uintptr_t)s->b + 0, "%p", s->bfsec.base);
+	assert(s->bfsec.len == 1, "%u", s->bfsec.len);
+
+	assert(s->bftail.id == 6, "%d", s->bftail.id);
+	assert((uintptr_t)s->bftail.base == (uintptr_t)s->b + 1, "%p", s->bftail.base);
+	assert(s->bftail.len == 20, "%u", s->bftail.len);
+
+	/* check reverse sections */
+	assert(s->arsec.id == 1, "%d", s->arsec.id);
+	assert((uintptr_t)s->arsec.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->a - 1, "%p", s->arsec.base);
+	assert(s->arsec.len == 1, "%u", s->arsec.len);
+
+	assert(s->artail.id == 3, "%d", s->artail.id);
+	assert((uintptr_t)s->artail.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->a - 21, "%p", s->artail.base);
+	assert(s->artail.len == 20, "%u", s->artail.len);
+
+	assert(s->brsec.id == 5, "%d", s->brsec.id);
+	assert((uintptr_t)s->brsec.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->b - 1, "%p", s->brsec.base);
+	assert(s->brsec.len == 1, "%u", s->brsec.len);
+
+	assert(s->brtail.id == 7, "%d", s->brtail.id);
+	assert((uintptr_t)s->brtail.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->b - 21, "%p", s->brtail.base);
+	assert(s->brtail.len == 20, "%u", s->brtail.len);
+}
+
+/**
+ * check if gaba_dp_init returns a vaild pointer to a dp context
+ */
+#define omajinai() \
+	struct gaba_context_s const *c = (struct gaba_context_s const *)gctx; \
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx; \
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
+
+unittest(with_seq_pair("A", "A"))
+{
+	omajinai();
+
+	assert(d != NULL, "%p", d);
+	gaba_dp_clean(d);
+}
+
+/**
+ * check if gaba_dp_fill_root and gaba_dp_fill returns a correct score
+ */
+unittest(with_seq_pair("A", "A"))
+{
+	omajinai();
+
+	/* fill root section */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 0, 0, -29, 1), print_tail(f));
+
+	/* fill again */
+	f = gaba_dp_fill(d, f, &s->afsec, &s->bfsec);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 0, 0, -27, 2), print_tail(f));
+
+	/* fill tail section */
+	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 4, 13, 13, 3), print_tail(f));
+
+	/* fill tail section again */
+	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	#if MODEL == LINEAR
+		assert(f->status == 0x1ff, "%x", f->status);
+		assert(check_tail(f, 4, 40, 53, 4), print_tail(f));
+	#else
+		assert(f->status == 0x10f, "%x", f->status);
+		assert(check_tail(f, 4, 31, 44, 4), print_tail(f));
+	#endif
+
+	gaba_dp_clean(d);
+}
+
+/* reverse fetch */
+unittest(with_seq_pair("A", "A"))
+{
+	omajinai();
+
+	/* fill root section */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->arsec, 0, &s->brsec, 0);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 0, 0, -29, 1), print_tail(f));
+
+	/* fill again */
+	f = gaba_dp_fill(d, f, &s->arsec, &s->brsec);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 0, 0, -27, 2), print_tail(f));
+
+	/* fill tail section */
+	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 4, 13, 13, 3), print_tail(f));
+
+	/* fill tail section again */
+	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
+	#if MODEL == LINEAR
+		assert(f->status == 0x1ff, "%x", f->status);
+		assert(check_tail(f, 4, 40, 53, 4), print_tail(f));
+	#else
+		assert(f->status == 0x10f, "%x", f->status);
+		assert(check_tail(f, 4, 31, 44, 4), print_tail(f));
+	#endif
+
+	gaba_dp_clean(d);
+}
+
+/* with longer sequences */
+unittest(with_seq_pair("ACGTACGTACGT", "ACGTACGTACGT"))
+{
+	omajinai();
+
+	/* fill root section */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 0, 0, -7, 1), print_tail(f));
+
+	/* fill again */
+	f = gaba_dp_fill(d, f, &s->afsec, &s->bfsec);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 16, 17, 17, 2), print_tail(f));
+
+	/* fill tail section */
+	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 48, 40, 57, 3), print_tail(f));
+
+	/* fill tail section again */
+	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	#if MODEL == LINEAR
+		assert(f->status == 0x1ff, "%x", f->status);
+		assert(check_tail(f, 48, 40, 97, 4), print_tail(f));
+	#else
+		assert(f->status == 0x10f, "%x", f->status);
+		assert(check_tail(f, 48, 31, 88, 4), print_tail(f));
+	#endif
+
+	gaba_dp_clean(d);
+}
+
+/* reverse fetch */
+unittest(with_seq_pair("ACGTACGTACGT", "ACGTACGTACGT"))
+{
+	omajinai();
+
+	/* fill root section */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->arsec, 0, &s->brsec, 0);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 0, 0, -7, 1), print_tail(f));
+
+	/* fill again */
+	f = gaba_dp_fill(d, f, &s->arsec, &s->brsec);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 16, 17, 17, 2), print_tail(f));
+
+	/* fill tail section */
+	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
+	assert(f->status == 0x1ff, "%x", f->status);
+	assert(check_tail(f, 48, 40, 57, 3), print_tail(f));
+
+	/* fill tail section again */
+	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
+	#if MODEL == LINEAR
+		assert(f->status == 0x1ff, "%x", f->status);
+		assert(check_tail(f, 48, 40, 97, 4), print_tail(f));
+	#else
+		assert(f->status == 0x10f, "%x", f->status);
+		assert(check_tail(f, 48, 31, 88, 4), print_tail(f));
+	#endif
+
+	gaba_dp_clean(d);
+}
+
+/* max block tracking */
+unittest(with_seq_pair("ACGTACGTACGT", "ACGTACGTACGT"))
+{
+	omajinai();
 
-		mem->next = NULL;
-		mem->prev = this->curr_mem;
-		mem->size = next_size;
-	}
+	/* max is reached in the tail section fill */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	f = gaba_dp_fill(d, f, &s->afsec, &s->bfsec);
+	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	assert(check_tail(f, 48, 40, 57, 3), print_tail(f));
+	assert(_tail(f)->mblk != 0, "%u", _tail(f)->mblk);
 
-	/* follow the forward link */
-	this->curr_mem = this->curr_mem->next;
+	struct gaba_pos_pair_s pos = gaba_dp_search_max(d, f);
+	assert(pos.apos == 11 && pos.bpos == 11, "apos(%u), bpos(%u)", pos.apos, pos.bpos);
 
-	/* init stack pointers */
-	this->stack_top = (uint8_t *)(this->curr_mem + 1);
-	this->stack_end = (uint8_t *)this->curr_mem + this->curr_mem->size - MEM_MARGIN_SIZE;
-	return(GABA_SUCCESS);
+	/* not updated in the mismatching tail */
+	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	assert(f->max == 48, print_tail(f));
+	assert(_tail(f)->mblk == 0, "%u", _tail(f)->mblk);
+
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn gaba_dp_flush
- */
-void suffix(gaba_dp_flush)(
-	struct gaba_dp_context_s *this,
-	uint8_t const *alim,
-	uint8_t const *blim)
+/* top-k maxima, two matching regions separated by mismatches */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"AAAAAAAAAAAAAAAAAAAA"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA",
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"CCCCCCCCCCCCCCCCCCCC"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA"))
 {
-	/* init seq lims */
-	this->w.r.alim = alim;
-	this->w.r.blim = blim;
+	omajinai();
 
-	this->curr_mem = &this->mem;
-	this->stack_top = (uint8_t *)(this + 1);
-	this->stack_end = (uint8_t *)this + this->mem.size - MEM_MARGIN_SIZE;
-	return;
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	while((f->status & GABA_STATUS_TERM) == 0) {
+		f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	}
+
+	struct gaba_max_s max[4];
+	uint32_t cnt = gaba_dp_search_topk(d, f, 4, 32, max);
+	assert(cnt == 2, "%u", cnt);
+
+	/* global max comes first, located on the fragment where it was reached */
+	assert(max[0].score == f->max, "%lld, %lld", max[0].score, f->max);
+	assert(max[0].apos == 139 && max[0].bpos == 139, "apos(%u), bpos(%u)", max[0].apos, max[0].bpos);
+
+	/* the end of the first region */
+	assert(max[1].score == 120, "%lld", max[1].score);
+	assert(max[1].apos == 59 && max[1].bpos == 59, "apos(%u), bpos(%u)", max[1].apos, max[1].bpos);
+
+	/* traceable */
+	struct gaba_alignment_s *r = gaba_dp_trace_max(d, &max[1], NULL, NULL);
+	assert(r != NULL);
+	assert(r->score == 120, "%lld", r->score);
+	assert(check_cigar(r, "60M"), print_path(r));
+
+	/* k = 1 returns the global max only */
+	assert(gaba_dp_search_topk(d, f, 1, 32, max) == 1);
+	assert(max[0].score == f->max, "%lld, %lld", max[0].score, f->max);
+
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn gaba_dp_save_stack
- */
-struct gaba_stack_s const *suffix(gaba_dp_save_stack)(
-	struct gaba_dp_context_s *this)
+/* traceback from an arbitrary cell in the band */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCA",
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCA"))
 {
-	struct gaba_mem_block_s *mem = this->curr_mem;
-	uint8_t *stack_top = this->stack_top;
-	uint8_t *stack_end = this->stack_end;
+	omajinai();
 
-	/* save */
-	struct gaba_stack_s *stack = (struct gaba_stack_s *)gaba_dp_malloc(
-		this, sizeof(struct gaba_stack_s));
-	stack->mem = mem;
-	stack->stack_top = stack_top;
-	stack->stack_end = stack_end;
-	debug("save stack(%p, %p, %p)", stack->mem, stack->stack_top, stack->stack_end);
-	return(stack);
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert((f->status & GABA_STATUS_TERM) == 0, "%x", f->status);
+
+	/* on the diagonal, before the max */
+	struct gaba_pos_pair_s pos = { .apos = 19, .bpos = 19 };
+	struct gaba_alignment_s *r = gaba_dp_trace_cell(d, f, &pos, NULL, NULL, NULL);
+	assert(r != NULL);
+	assert(r->score == 40 && r->xcnt == 0, "score(%lld), xcnt(%lld)", r->score, r->xcnt);
+	assert(check_cigar(r, "20M"), print_path(r));
+	assert(check_section(r->sec[0], s->afsec, 0, 20, s->bfsec, 0, 20, 0, 40), print_section(r->sec[0]));
+
+	/* off the diagonal, the path ends with gaps */
+	pos = (struct gaba_pos_pair_s){ .apos = 21, .bpos = 19 };
+	r = gaba_dp_trace_cell(d, f, &pos, NULL, NULL, NULL);
+	assert(r != NULL);
+	assert(r->gecnt == 2, "%lld", r->gecnt);
+	assert(check_section(r->sec[0], s->afsec, 0, 22, s->bfsec, 0, 20, 0, 42), print_section(r->sec[0]));
+
+	/* out of the band and out of the sections */
+	pos = (struct gaba_pos_pair_s){ .apos = 39, .bpos = 0 };
+	assert(gaba_dp_trace_cell(d, f, &pos, NULL, NULL, NULL) == NULL);
+	pos = (struct gaba_pos_pair_s){ .apos = 40, .bpos = 0 };
+	assert(gaba_dp_trace_cell(d, f, &pos, NULL, NULL, NULL) == NULL);
+
+	/* the max if NULL */
+	r = gaba_dp_trace_cell(d, f, NULL, NULL, NULL, NULL);
+	assert(r != NULL);
+	assert(r->score == f->max, "%lld, %lld", r->score, f->max);
+
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn gaba_dp_flush_stack
- */
-void suffix(gaba_dp_flush_stack)(
-	struct gaba_dp_context_s *this,
-	gaba_stack_t const *stack)
+/* recombination, the mismatching section in the middle is spliced out */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"AAAAAAAAAAAAAAAAAAAA"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA",
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"CCCCCCCCCCCCCCCCCCCC"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA"))
 {
-	if(stack == NULL) {
-		return;
+	omajinai();
+
+	struct gaba_section_s const a[4] = {
+		gaba_build_section(10, s->afsec.base, 60),
+		gaba_build_section(12, s->afsec.base + 60, 20),
+		gaba_build_section(14, s->afsec.base + 80, 60),
+		s->aftail
+	};
+	struct gaba_section_s const b[4] = {
+		gaba_build_section(20, s->bfsec.base, 60),
+		gaba_build_section(22, s->bfsec.base + 60, 20),
+		gaba_build_section(24, s->bfsec.base + 80, 60),
+		s->bftail
+	};
+
+	/* keep the fragment where the max was reached */
+	uint32_t ai = 0, bi = 0;
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &a[0], 0, &b[0], 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		ai = MIN2(ai + ((t->status & GABA_STATUS_UPDATE_A) != 0), 3);
+		bi = MIN2(bi + ((t->status & GABA_STATUS_UPDATE_B) != 0), 3);
+		t = gaba_dp_fill(d, t, &a[ai], &b[bi]);
+		f = (t->max > f->max) ? t : f;
 	}
 
-	this->curr_mem = stack->mem;
-	this->stack_top = stack->stack_top;
-	this->stack_end = stack->stack_end;
-	debug("restore stack(%p, %p, %p)", stack->mem, stack->stack_top, stack->stack_end);
-	return;
+	/* mismatches on the linear, a deletion and an insertion on the affine */
+	struct gaba_alignment_s *x = gaba_dp_trace(d, f, NULL, NULL);
+	struct gaba_alignment_s *y = gaba_dp_trace(d, f, NULL, NULL);
+	assert(x != NULL && y != NULL);
+	assert(x->slen == 3, "%u", x->slen);
+	#if MODEL == LINEAR
+		assert(x->score == 180 && x->xcnt == 20, "score(%lld), xcnt(%lld)", x->score, x->xcnt);
+	#else
+		assert(x->score == 190, "%lld", x->score);
+	#endif
+
+	/* out of range, both released */
+	assert(gaba_dp_recombine(d, x, 3, y, 0) == NULL);
+	x = gaba_dp_trace(d, f, NULL, NULL);
+	y = gaba_dp_trace(d, f, NULL, NULL);
+	assert(x != NULL && y != NULL);
+
+	/* the first section of x and the last of y */
+	struct gaba_alignment_s *r = gaba_dp_recombine(d, x, 0, y, 2);
+	assert(r != NULL);
+	assert(r->score == 240 && r->xcnt == 0, "score(%lld), xcnt(%lld)", r->score, r->xcnt);
+	assert(r->gicnt == 0 && r->gecnt == 0, "gicnt(%lld), gecnt(%lld)", r->gicnt, r->gecnt);
+	assert(check_cigar(r, "120M"), print_path(r));
+	assert(r->slen == 2, "%u", r->slen);
+	assert(check_section(r->sec[0], a[0], 0, 60, b[0], 0, 60, 0, 120), print_section(r->sec[0]));
+	assert(check_section(r->sec[1], a[2], 0, 60, b[2], 0, 60, 120, 120), print_section(r->sec[1]));
+
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn gaba_dp_malloc
- */
-static _force_inline
-void *gaba_dp_malloc(
-	struct gaba_dp_context_s *this,
-	uint64_t size)
+/* recombine alignments from more origins than two traces carry */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGGCTTAACCTCCAGTACGATCGG"))
 {
-	/* roundup */
-	size = _roundup(size, MEM_ALIGN_SIZE);
+	omajinai();
 
-	/* malloc */
-	debug("this(%p), stack_top(%p), size(%llu)", this, this->stack_top, size);
-	if((uint64_t)(this->stack_end - this->stack_top) < size) {
-		if(gaba_dp_add_stack(this, size) != GABA_SUCCESS) {
-			return(NULL);
+	struct gaba_alignment_s *r = NULL;
+	for(uint32_t i = 0; i < 6; i++) {
+		struct gaba_section_s const a = gaba_build_section(40 + 2 * i, s->afsec.base, s->afsec.len);
+		struct gaba_section_s const b = gaba_build_section(60 + 2 * i, s->bfsec.base, s->bfsec.len);
+		struct gaba_fill_s *f = gaba_dp_fill_root(d, &a, 0, &b, 0), *t = f;
+		while((t->status & GABA_STATUS_TERM) == 0) {
+			t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+			f = (t->max > f->max) ? t : f;
 		}
-		debug("stack_top(%p)", this->stack_top);
+		struct gaba_alignment_s *x = gaba_dp_trace(d, f, NULL, NULL);
+		assert(x != NULL && x->slen == 1, "%u", x->slen);
+		r = (r == NULL) ? x : gaba_dp_recombine(d, r, r->slen - 1, x, 0);
+		assert(r != NULL);
 	}
-	this->stack_top += size;
-	return((void *)(this->stack_top - size));
+
+	/* every section located on its own origin, the mismatch counted on each */
+	assert(r->slen == 6, "%u", r->slen);
+	assert(r->xcnt == 6, "%lld", r->xcnt);
+	assert(check_cigar(r, "180M"), print_path(r));
+
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn gaba_dp_clean
- */
-void suffix(gaba_dp_clean)(
-	struct gaba_dp_context_s *this)
+/* a diagonal split at a section boundary counted as one column, on the stats and the cigar */
+unittest(with_seq_pair("ACGTACGTAC", "ACGTTCGTAC"))
 {
-	if(this == NULL) {
-		return;
-	}
+	omajinai();
 
-	struct gaba_mem_block_s *m = this->mem.next;
-	while(m != NULL) {
-		struct gaba_mem_block_s *mnext = m->next;
-		free(m); m = mnext;
-	}
-	gaba_aligned_free(this);
-	return;
-}
+	/* ten diagonals, the section ends after the down half of the fifth, on the mismatch */
+	uint64_t pbuf[4] = { 20, 0x5555555555555555, 0x5555555555555555, 0x5555555555555555 };
+	struct gaba_path_section_s const psec[2] = {
+		{ .aid = 10, .bid = 20, .apos = 0, .bpos = 0, .alen = 4, .blen = 5, .ppos = 0 },
+		{ .aid = 10, .bid = 20, .apos = 4, .bpos = 5, .alen = 6, .blen = 5, .ppos = 9 }
+	};
+	struct gaba_alignment_s const r = { .slen = 2, .sec = psec, .path = (struct gaba_path_s const *)pbuf };
+	struct gaba_section_s const sec[2] = {
+		gaba_build_section(10, s->afsec.base, 10),
+		gaba_build_section(20, s->bfsec.base, 10)
+	};
 
-/* unittests */
-#if UNITTEST == 1
+	struct gaba_rescore_s x = gaba_dp_rescore(d, &r, sec, 2, NULL);
+	assert(x.mcnt == 9 && x.xcnt == 1, "mcnt(%u), xcnt(%u)", x.mcnt, x.xcnt);
+	assert(x.gicnt == 0 && x.gecnt == 0, "gicnt(%u), gecnt(%u)", x.gicnt, x.gecnt);
+	assert(x.score == 9 * 2 - 3, "%lld", x.score);
 
-#include <string.h>
-#include <sys/types.h>
-#include <unistd.h>
+	/* the same column on the extended cigar and the MD tag */
+	char cigar[128], md[128];
+	gaba_dp_dump_cigar_ext(d, cigar, 128, md, 128, &r, sec, 2);
+	assert(strcmp(cigar, "4=1X5=") == 0, "%s", cigar);
+	assert(strcmp(md, "4A5") == 0, "%s", md);
 
-/**
- * @fn unittest_build_context
- * @brief build context for unittest
- */
-#if MODEL == LINEAR
-static struct gaba_params_s const *unittest_default_params = GABA_PARAMS(
-	.xdrop = 100,
-	GABA_SCORE_SIMPLE(2, 3, 0, 6));
-#else
-static struct gaba_params_s const *unittest_default_params = GABA_PARAMS(
-	.xdrop = 100,
-	GABA_SCORE_SIMPLE(2, 3, 5, 1));
-#endif
-static
-void *unittest_build_context(void *params)
+	/* b not located */
+	x = gaba_dp_rescore(d, &r, sec, 1, NULL);
+	assert(x.ucnt == 10 && x.mcnt == 0 && x.gecnt == 0, "ucnt(%u), mcnt(%u), gecnt(%u)", x.ucnt, x.mcnt, x.gecnt);
+	gaba_dp_dump_cigar_ext(d, cigar, 128, md, 128, &r, sec, 1);
+	assert(strcmp(cigar, "10M") == 0, "%s", cigar);
+	assert(strcmp(md, "") == 0, "%s", md);
+
+	gaba_dp_clean(d);
+}
+
+/* exact counts across a section boundary after an insertion, an ambiguous base apart */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGCATGCAAGTCTGACTTGCAGTCAGGACTTC",
+	"GATTACAGGCTTRACGATCCAGTACGATCGGCATGCAAGTCTGACTTGCAGTCAGGACTTC"))
 {
-	/* build context */
-	gaba_t *ctx = gaba_init(unittest_default_params);
-	return((void *)ctx);
+	omajinai();
+
+	/* b, one base longer with the insertion, ends the first section before a */
+	struct gaba_section_s const a[3] = {
+		gaba_build_section(10, s->afsec.base, 30),
+		gaba_build_section(12, s->afsec.base + 30, 30),
+		s->aftail
+	};
+	struct gaba_section_s const b[3] = {
+		gaba_build_section(20, s->bfsec.base, 25),
+		gaba_build_section(22, s->bfsec.base + 25, 36),
+		s->bftail
+	};
+
+	uint32_t ai = 0, bi = 0;
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &a[0], 0, &b[0], 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		ai = MIN2(ai + ((t->status & GABA_STATUS_UPDATE_A) != 0), 2);
+		bi = MIN2(bi + ((t->status & GABA_STATUS_UPDATE_B) != 0), 2);
+		t = gaba_dp_fill(d, t, &a[ai], &b[bi]);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+	assert(r->slen == 3, "%u", r->slen);
+	assert(r->mcnt == 59 && r->acnt == 1 && r->ucnt == 0, "mcnt(%u), acnt(%u), ucnt(%u)", r->mcnt, r->acnt, r->ucnt);
+	assert(r->xcnt == 0 && r->gicnt == 1 && r->icnt == 1 && r->dcnt == 0 && r->nm == 1,
+		"xcnt(%lld), gicnt(%lld), icnt(%u), dcnt(%u), nm(%u)", r->xcnt, r->gicnt, r->icnt, r->dcnt, r->nm);
+
+	/* the same on the rescore, the score unchanged */
+	struct gaba_rescore_s x = gaba_dp_rescore(d, r, (struct gaba_section_s const []){ a[0], a[1], b[0], b[1] }, 4, NULL);
+	assert(x.score == r->score, "%lld, %lld", x.score, r->score);
+	assert(x.mcnt == 59 && x.acnt == 1 && x.gicnt == 1 && x.gecnt == 1,
+		"mcnt(%u), acnt(%u), gicnt(%u), gecnt(%u)", x.mcnt, x.acnt, x.gicnt, x.gecnt);
+
+	/* columns on the sections not given are not compared */
+	x = gaba_dp_rescore(d, r, (struct gaba_section_s const []){ a[0], a[1], b[1] }, 3, NULL);
+	assert(x.score == r->score, "%lld, %lld", x.score, r->score);
+	assert(x.ucnt == 24 && x.mcnt == 36 && x.acnt == 0, "ucnt(%u), mcnt(%u), acnt(%u)", x.ucnt, x.mcnt, x.acnt);
+
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn unittest_clean_context
- */
-static
-void unittest_clean_context(void *ctx)
+/* rescoring under another scoring scheme */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGCCTTAACGTCAGTACGATTCGG"))
 {
-	gaba_clean((struct gaba_context_s *)ctx);
-	return;
+	omajinai();
+
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+
+	/* same as the trace under the scores of the context */
+	struct gaba_section_s const sec[4] = { s->afsec, s->aftail, s->bfsec, s->bftail };
+	struct gaba_rescore_s x = gaba_dp_rescore(d, r, sec, 4, NULL);
+	assert(x.score == r->score, "%lld, %lld", x.score, r->score);
+	assert(x.mcnt == 25 && x.xcnt == 1, "mcnt(%u), xcnt(%u)", x.mcnt, x.xcnt);
+	assert(x.gicnt == 1 && x.gecnt == 1, "gicnt(%u), gecnt(%u)", x.gicnt, x.gecnt);
+	assert(x.identity * 27 > 24.99 && x.identity * 27 < 25.01, "%f", x.identity);
+
+	/* another scheme */
+	x = gaba_dp_rescore(d, r, sec, 4, GABA_PARAMS( GABA_SCORE_SIMPLE(1, 4, 6, 1) ));
+	assert(x.score == 25 - 4 - 6 - 1, "%lld", x.score);
+
+	/* located on the reverse-complemented sections */
+	struct gaba_section_s const rsec[4] = { s->arsec, s->aftail, s->brsec, s->bftail };
+	x = gaba_dp_rescore(d, r, rsec, 4, GABA_PARAMS( GABA_SCORE_SIMPLE(1, 4, 6, 1) ));
+	assert(x.score == 25 - 4 - 6 - 1, "%lld", x.score);
+	assert(x.mcnt == 25 && x.xcnt == 1, "mcnt(%u), xcnt(%u)", x.mcnt, x.xcnt);
+
+	gaba_dp_clean(d);
 }
 
-/**
- * @struct unittest_seqs_s
- * @brief sequence container
- */
-struct unittest_seqs_s {
-	char const *a;
-	char const *b;
-};
-#define unittest_seq_pair(_a, _b) ( \
-	(void *)&((struct unittest_seqs_s const){ \
-		.a = _a "GGGGGGGGGGGGGGGGGGGG", \
-		.b = _b "CCCCCCCCCCCCCCCCCCCC" \
-	}) \
-)
+/* exact counts on the path and the sequences */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGCCTTAACGTCAGTACGATTCGG"))
+{
+	omajinai();
 
-/**
- * @struct unittest_sections_s
- * @brief section container
- */
-struct unittest_sections_s {
-	uint8_t const *a, *b;
-	uint8_t const *alim, *blim;
-	uint64_t alen, blen;
-	struct gaba_section_s afsec, aftail, bfsec, bftail;
-	struct gaba_section_s arsec, artail, brsec, brtail;
-	struct gaba_section_s assec, bssec;
-};
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+	assert(r->mcnt == 25 && r->xcnt == 1, "mcnt(%u), xcnt(%lld)", r->mcnt, r->xcnt);
+	assert(r->icnt + r->dcnt == 1, "icnt(%u), dcnt(%u)", r->icnt, r->dcnt);
+	assert(r->gicnt == 1 && r->gecnt == 1, "gicnt(%lld), gecnt(%lld)", r->gicnt, r->gecnt);
+	assert(r->nm == 2, "%u", r->nm);
+
+	/* consistent with the spans of the sections */
+	uint64_t alen = 0, blen = 0;
+	for(uint32_t i = 0; i < r->slen; i++) { alen += r->sec[i].alen; blen += r->sec[i].blen; }
+	assert(r->mcnt + r->xcnt + r->dcnt == alen, "%lu", alen);
+	assert(r->mcnt + r->xcnt + r->icnt == blen, "%lu", blen);
 
-/**
- * @fn unittest_encode_base
- * @brief mapping IUPAC amb. to 2bit / 4bit encoding
- */
-static _force_inline
-uint8_t unittest_encode_base(
-	char c)
+	gaba_dp_clean(d);
+}
+
+/* extended cigar and MD tag */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGCCTTAACGTCAGTACGATTCGG"))
 {
-	/* convert to upper case and subtract offset by 0x40 */
-	#define _b(x)	( (x) & 0x1f )
+	omajinai();
 
-	/* conversion tables */
-	enum bases { A = 0x01, C = 0x02, G = 0x04, T = 0x08 };
-	static uint8_t const table[] = {
-		[_b('A')] = A,
-		[_b('C')] = C,
-		[_b('G')] = G,
-		[_b('T')] = T,
-		[_b('U')] = T,
-		[_b('R')] = A | G,
-		[_b('Y')] = C | T,
-		[_b('S')] = G | C,
-		[_b('W')] = A | T,
-		[_b('K')] = G | T,
-		[_b('M')] = A | C,
-		[_b('B')] = C | G | T,
-		[_b('D')] = A | G | T,
-		[_b('H')] = A | C | T,
-		[_b('V')] = A | C | G,
-		[_b('N')] = 0,		/* treat 'N' as a gap */
-		[_b('_')] = 0		/* sentinel */
-	};
-	return(table[_b((uint8_t)c)]);
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+
+	/* located on the tails */
+	char cigar[128], md[128];
+	uint64_t l = gaba_dp_dump_cigar_ext(d, cigar, 128, md, 128, r, NULL, 0);
+	assert(l == strlen(cigar), "%lu", l);
+	assert(strcmp(cigar, "8=1X9=1D8=") == 0, "%s", cigar);
+	assert(strcmp(md, "8G9^C8") == 0, "%s", md);
+
+	/* located on the reverse-complemented sections */
+	struct gaba_section_s const rsec[4] = { s->arsec, s->aftail, s->brsec, s->bftail };
+	gaba_dp_dump_cigar_ext(d, cigar, 128, md, 128, r, rsec, 4);
+	assert(strcmp(cigar, "8=1X9=1D8=") == 0, "%s", cigar);
+	assert(strcmp(md, "8G9^C8") == 0, "%s", md);
+
+	/* cigar only */
+	l = gaba_dp_dump_cigar_ext(d, cigar, 128, NULL, 0, r, NULL, 0);
+	assert(strcmp(cigar, "8=1X9=1D8=") == 0, "%s", cigar);
+
+	/* BAM cigars of three alignments in one buffer, the last one does not fit */
+	uint32_t bam[7];
+	uint64_t ofs[4] = { 0 };
+	struct gaba_alignment_s const *alns[3] = { r, r, r };
+	assert(gaba_dp_dump_bam_cigar_batch(bam, 7, ofs, alns, 3) == 2);
+	assert(ofs[0] == 0 && ofs[1] == 3 && ofs[2] == 6, "%lu, %lu, %lu", ofs[0], ofs[1], ofs[2]);
+	assert(bam[3] == (18<<4) && bam[4] == ((1<<4) | 2) && bam[5] == (8<<4), "%x, %x, %x", bam[3], bam[4], bam[5]);
 
-	#undef _b
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn unittest_build_seqs
- * @brief build seq_pair and sections
- */
-static
-void *unittest_build_seqs(void *params)
+/* run-length encoded path */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGCCTTAACGTCAGTACGATTCGG"))
 {
-	struct unittest_seqs_s const *seqs = (struct unittest_seqs_s const *)params;
-	char const *a = seqs->a;
-	char const *b = seqs->b;
+	omajinai();
 
-	uint64_t atot = strlen(a);
-	uint64_t btot = strlen(b);
-	uint32_t alen = atot - 20;
-	uint32_t blen = btot - 20;
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL && r->rle == NULL);
+
+	r = gaba_dp_trace(d, f, NULL, GABA_TRACE_PARAMS( .mode = GABA_TRACE_RLE ));
+	assert(r != NULL && r->rle != NULL);
+	assert(r->rle->len == 3, "%u", r->rle->len);
+	assert(r->rle->op[0] == (18<<4) && r->rle->op[1] == ((1<<4) | 2) && r->rle->op[2] == (8<<4),
+		"%x, %x, %x", r->rle->op[0], r->rle->op[1], r->rle->op[2]);
+
+	char cigar[128], rcigar[128];
+	gaba_dp_dump_cigar_forward(cigar, 128, r->path->array, 0, r->path->len);
+	uint64_t l = gaba_dp_dump_cigar_rle(rcigar, 128, r->rle);
+	assert(l == strlen(rcigar) && strcmp(cigar, rcigar) == 0, "%s, %s", cigar, rcigar);
+
+	/* copied to the batch */
+	uint32_t bam[8];
+	uint64_t ofs[3] = { 0 };
+	struct gaba_alignment_s const *alns[2] = { r, r };
+	assert(gaba_dp_dump_bam_cigar_batch(bam, 8, ofs, alns, 2) == 2);
+	assert(ofs[1] == 3 && ofs[2] == 6 && memcmp(&bam[3], r->rle->op, 3 * sizeof(uint32_t)) == 0);
+	assert(gaba_dp_dump_bam_cigar_batch(bam, 5, ofs, alns, 2) == 1);
 
-	uint64_t margin = 64;
-	struct unittest_sections_s *sec = malloc(
-		sizeof(struct unittest_sections_s) + (atot + 1) + (btot + 1) + margin);
+	gaba_dp_clean(d);
+}
 
-	/* copy sequences */
-	uint8_t *ca = (uint8_t *)(sec + 1);
-	uint8_t *cb = ca + atot + 1;
-	uint8_t *cm = cb + btot + 1;
+/* result in the caller's buffer */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGCCTTAACGTCAGTACGATTCGG"))
+{
+	omajinai();
 
-	for(uint64_t i = 0; i < atot; i++) {
-		ca[i] = unittest_encode_base(a[i]);
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
 	}
-	for(uint64_t i = 0; i < btot; i++) {
-		cb[i] = unittest_encode_base(b[i]);
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+
+	uint64_t size = gaba_dp_trace_size(d, f, NULL, NULL);
+	uint64_t rle_size = gaba_dp_trace_size(d, f, NULL, GABA_TRACE_PARAMS( .mode = GABA_TRACE_RLE ));
+	assert(size > sizeof(struct gaba_alignment_s) && rle_size > size, "%lu, %lu", size, rle_size);
+	uint8_t *buf = (uint8_t *)malloc(rle_size);
+
+	/* fails on a short buffer */
+	assert(gaba_dp_trace(d, f, NULL, GABA_TRACE_PARAMS( .buf = buf, .buf_size = size - 1 )) == NULL);
+
+	/* the encoded path follows the path */
+	struct gaba_alignment_s *b = gaba_dp_trace(d, f, NULL,
+		GABA_TRACE_PARAMS( .buf = buf, .buf_size = rle_size, .mode = GABA_TRACE_RLE ));
+	assert(b != NULL && b->lmm == NULL);
+	assert((uint8_t *)b >= buf && (uint8_t *)(b + 1) <= buf + size);
+	assert((uint8_t *)b->path >= buf && (uint8_t *)b->path < buf + size);
+	assert((uint8_t *)b->sec >= buf && (uint8_t *)(b->sec + b->slen) <= buf + size);
+	assert((uint8_t *)b->rle > (uint8_t *)b->path && (uint8_t *)&b->rle->op[b->rle->len] <= buf + rle_size);
+	assert(b->score == r->score && b->slen == r->slen && b->path->len == r->path->len);
+	assert(b->nm == r->nm && b->rle->len == 3, "%u, %u", b->nm, b->rle->len);
+
+	/* fails if the encoded path does not fit, it is never placed out of the buffer */
+	uint64_t rle_end = (uint8_t *)&b->rle->op[b->rle->len] - buf;
+	for(uint64_t sz = size; sz < rle_size; sz++) {
+		struct gaba_alignment_s *c = gaba_dp_trace(d, f, NULL,
+			GABA_TRACE_PARAMS( .buf = buf, .buf_size = sz, .mode = GABA_TRACE_RLE ));
+		assert(c == NULL || (sz >= rle_end && c->rle == b->rle && c->rle->len == 3), "%lu", sz);
 	}
-	ca[atot] = cb[btot] = '\0';
-	memset(cm, 0, margin);
-
-	/* build context */
-	uint8_t const *const alim = (void const *)0x800000000000;
-	uint8_t const *const blim = (void const *)0x800000000000;
-	*sec = (struct unittest_sections_s){
-		.a = ca,
-		.b = cb,
-		.alim = alim,
-		.blim = blim,
-		.alen = atot,
-		.blen = btot,
-		
-		/* forward */
-		.afsec = gaba_build_section(0, ca, alen),
-		.aftail = gaba_build_section(2, ca + alen, 20),
-		.bfsec = gaba_build_section(4, cb, blen),
-		.bftail = gaba_build_section(6, cb + blen, 20),
+	b = gaba_dp_trace(d, f, NULL, GABA_TRACE_PARAMS( .buf = buf, .buf_size = rle_size, .mode = GABA_TRACE_RLE ));
 
-		/* reverse */
-		.arsec = gaba_build_section(1, _rev(ca + alen - 1, alim), alen),
-		.artail = gaba_build_section(3, _rev(ca + atot - 1, alim), 20),
-		.brsec = gaba_build_section(5, _rev(cb + blen - 1, blim), blen),
-		.brtail = gaba_build_section(7, _rev(cb + btot - 1, blim), 20),
+	char cigar[128], bcigar[128];
+	gaba_dp_dump_cigar_forward(cigar, 128, r->path->array, 0, r->path->len);
+	gaba_dp_dump_cigar_forward(bcigar, 128, b->path->array, 0, b->path->len);
+	assert(strcmp(cigar, bcigar) == 0, "%s, %s", cigar, bcigar);
 
-		/* seed section */
-		.assec = gaba_build_section(100, ca, 14),
-		.bssec = gaba_build_section(102, cb, 14)
-	};
-	return((void *)sec);
+	gaba_dp_res_free(b);			/* no-op */
+	free(buf);
+	gaba_dp_clean(d);
 }
 
-/**
- * @fn unittest_clean_seqs
- */
-static
-void unittest_clean_seqs(void *ctx)
+/* encoded path of a gap-rich alignment in the caller's buffer, fails where it does not fit */
+unittest(with_seq_pair(
+	"GCGCTCCATCCCTCAATACTCCAGGGACGGAGCGTCCTGAGAGGTAACCGTGTAAGTTGATTTGCGCTCCCCCGTTTATGAAAAAGGATTATATCCACCGATTAGAGTTACTGAAACCCA",
+	"GCGCTCATCCCTCAATATCCAGGGACGGGCGTCCTGAGAGTAACCGTGTAGTTGATTTGCGTCCCCCGTTTAGAAAAAGGATTTATCCACCGATAGAGTTACTGAACCCA"))
 {
-	free(ctx);
+	omajinai();
+
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, GABA_TRACE_PARAMS( .mode = GABA_TRACE_RLE ));
+	assert(r != NULL && r->rle != NULL && r->rle->len > 16, "%u", r->rle->len);
+
+	uint64_t size = gaba_dp_trace_size(d, f, NULL, NULL);
+	uint64_t rle_size = gaba_dp_trace_size(d, f, NULL, GABA_TRACE_PARAMS( .mode = GABA_TRACE_RLE ));
+	uint8_t *buf = (uint8_t *)malloc(rle_size);
+
+	uint64_t failed = 0;
+	for(uint64_t sz = size; sz <= rle_size; sz++) {
+		struct gaba_alignment_s *b = gaba_dp_trace(d, f, NULL,
+			GABA_TRACE_PARAMS( .buf = buf, .buf_size = sz, .mode = GABA_TRACE_RLE ));
+		if(b == NULL) { failed++; continue; }
+		assert((uint8_t *)b->rle > buf && (uint8_t *)&b->rle->op[b->rle->len] <= buf + sz, "%lu", sz);
+		assert(b->rle->len == r->rle->len && memcmp(b->rle->op, r->rle->op, sizeof(uint32_t) * r->rle->len) == 0, "%lu", sz);
+	}
+	assert(failed > 0 && failed < rle_size - size, "%lu", failed);
+	assert(gaba_dp_trace(d, f, NULL,
+		GABA_TRACE_PARAMS( .buf = buf, .buf_size = rle_size, .mode = GABA_TRACE_RLE )) != NULL);
+
+	free(buf);
+	gaba_dp_clean(d);
 }
 
-/**
- * @macro with_seq_pair
- * @brief constructs .param, .init, and .clean parameters
- */
-#define with_seq_pair(_a, _b) \
-	.params = unittest_seq_pair(_a, _b), \
-	.init = unittest_build_seqs, \
-	.clean = unittest_clean_seqs
+/* batched trace, across the boundary of the batch, with NULL tails */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGCCTTAACGTCAGTACGATTCGG"))
+{
+	omajinai();
 
-/**
- * misc macros and functions for assertion
- */
-#define check_tail(_t, _max, _p, _psum, _ssum) ( \
-	   (_t) != NULL \
-	&& (_t)->max == (_max) \
-	&& (_t)->p == (_p) \
-	&& (_t)->psum == (_psum) \
-	&& (_t)->ssum == (_ssum) \
-)
-#define print_tail(_t) \
-	"tail(%p), max(%lld), p(%d), psum(%lld), ssum(%u)", \
-	(_t), (_t)->max, (_t)->p, (_t)->psum, (_t)->ssum
-#define check_result(_r, _score, _xcnt, _plen, _slen, _rsidx, _rppos, _rapos, _rbpos) ( \
-	   (_r) != NULL \
-	&& (_r)->sec != NULL \
-	&& (_r)->path != NULL \
-	&& (_r)->path->len == (_plen) \
-	&& (_r)->slen == (_slen) \
-	&& (_r)->score == (_score) \
-	&& (_r)->xcnt == (_xcnt) \
-	&& (_r)->rsidx == (_rsidx) \
-	&& (_r)->rppos == (_rppos) \
-	&& (_r)->rapos == (_rapos) \
-	&& (_r)->rbpos == (_rbpos) \
-)
-#define print_result(_r) \
-	"res(%p), score(%lld), xcnt(%lld), plen(%u), slen(%u), rsid(%u), rppos(%u), rapos(%u), rbpos(%u)", \
-	(_r), (_r)->score, (_r)->xcnt, (_r)->path->len, (_r)->slen, (_r)->rsidx, (_r)->rppos, (_r )->rapos, (_r)->rbpos
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_fill_s const *tail[20];
+	for(uint64_t i = 0; i < 20; i++) {
+		tail[i] = (i % 7 == 3) ? NULL : f;
+	}
 
-static
-int check_path(
-	struct gaba_alignment_s const *aln,
-	char const *str)
+	struct gaba_alignment_s *r[20], *a[20];
+	for(uint64_t i = 0; i < 20; i++) {
+		r[i] = gaba_dp_trace(d, tail[i], NULL, NULL);
+	}
+	assert(gaba_dp_trace_batch(d, tail, NULL, 20, NULL, a) == 20);
+	for(uint64_t i = 0; i < 20; i++) {
+		assert(a[i] != NULL && r[i] != NULL, "%lu", i);
+		assert(a[i]->score == r[i]->score && a[i]->path->len == r[i]->path->len, "%lu", i);
+		char cigar[128], acigar[128];
+		gaba_dp_dump_cigar_forward(cigar, 128, r[i]->path->array, 0, r[i]->path->len);
+		gaba_dp_dump_cigar_forward(acigar, 128, a[i]->path->array, 0, a[i]->path->len);
+		assert(strcmp(cigar, acigar) == 0, "%lu, %s, %s", i, cigar, acigar);
+	}
+
+	/* packed in the caller's buffer, the last slots are short */
+	uint64_t size = 0;
+	for(uint64_t i = 0; i < 20; i++) {
+		size += _roundup(gaba_dp_trace_size(d, tail[i], NULL, NULL), 16);
+	}
+	uint8_t *buf = (uint8_t *)malloc(size);
+	uint64_t short_size = size - _roundup(gaba_dp_trace_size(d, tail[19], NULL, NULL), 16) - 16;
+	assert(gaba_dp_trace_batch(d, tail, NULL, 20,
+		GABA_TRACE_PARAMS( .buf = buf, .buf_size = short_size ), a) == 18);
+	assert(a[18] == NULL && a[19] == NULL);
+	assert(gaba_dp_trace_batch(d, tail, NULL, 20, GABA_TRACE_PARAMS( .buf = buf, .buf_size = size ), a) == 20);
+	for(uint64_t i = 0; i < 20; i++) {
+		assert(a[i]->lmm == NULL && (uint8_t *)a[i] >= buf && (uint8_t *)a[i] < buf + size, "%lu", i);
+		assert(i == 0 || (uint8_t *)a[i] > (uint8_t *)(a[i - 1]->path->array + (a[i - 1]->path->len>>5)), "%lu", i);
+		assert(a[i]->score == r[i]->score && a[i]->path->len == r[i]->path->len, "%lu", i);
+	}
+	free(buf);
+	gaba_dp_clean(d);
+}
+
+/* trace on the leaves of a fill tree, two branches on the same sequences and one on the shifted */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGG" "TAGCATGCAAGTCCAGTACCTAGGCATTCA" "CGTAGGCTAACGATTCAGGCATCCATGACT" "AGTCCATGAATTCGCGGATACCAGTTGCAA",
+	"GATTACAGCCTTAACGTCAGTACGATTCGG" "TAGCATGCAAGTCCAGTACCTAGGCATTCA" "CGTAGGCTAACGTTCAGGCATCCATGACTT" "AGTCCATGAATTCGCGGATACCAGTTGCAA"))
 {
-	int64_t plen = aln->path->len, slen = strlen(str);
-	uint32_t const *p = aln->path->array;
-	debug("%s", str);
+	omajinai();
 
-	/* first check length */
-	if(plen != slen) {
-		debug("plen(%lld), slen(%lld)", plen, slen);
-		return(0);
+	/* trunk on the first halves, in sections of 20 bases, then branches on the second halves */
+	struct gaba_section_s const a[6] = {
+		gaba_build_section(8, s->a, 20),
+		gaba_build_section(10, s->a + 20, 20),
+		gaba_build_section(12, s->a + 40, 20),
+		gaba_build_section(14, s->a + 60, 60),
+		gaba_build_section(16, s->a + 60, 60),
+		gaba_build_section(18, s->a + 60, 60)
+	};
+	struct gaba_section_s const b[6] = {
+		gaba_build_section(20, s->b, 20),
+		gaba_build_section(22, s->b + 20, 20),
+		gaba_build_section(24, s->b + 40, 20),
+		gaba_build_section(26, s->b + 60, 60),
+		gaba_build_section(28, s->b + 60, 60),
+		gaba_build_section(30, s->b + 61, 59)
+	};
+	#define _sec(_x, _i, _k)		( ((_i) < 3) ? &(_x)[_i] : (((_i) == 3) ? &(_x)[3 + (_k)] : NULL) )
+	uint32_t ai = 0, bi = 0;
+	struct gaba_fill_s const *t = gaba_dp_fill_root(d, &a[0], 0, &b[0], 0);
+	while(1) {
+		ai += (t->status & GABA_STATUS_UPDATE_A) != 0;
+		bi += (t->status & GABA_STATUS_UPDATE_B) != 0;
+		if(ai == 3 || bi == 3) { break; }
+		t = gaba_dp_fill(d, t, &a[ai], &b[bi]);
 	}
 
-	/* next compare encoded string (bit string) */
-	while(plen > 0) {
-		uint32_t array = 0;
-		for(int64_t i = 0; i < 32; i++) {
-			if(plen-- == 0) {
-				array = (array>>(32 - i)) | ((uint64_t)0x55555555<<i);
-				break;
-			}
-			array = (array>>1) | ((*str++ == 'D') ? 0x80000000 : 0);
-			debug("%c, %x", str[-1], array);
+	/* branches, and the root */
+	struct gaba_fill_s const *leaf[4] = { NULL };
+	for(uint64_t k = 0; k < 3; k++) {
+		uint32_t aj = ai, bj = bi;
+		struct gaba_fill_s const *f = t, *m = t;
+		while((f->status & GABA_STATUS_TERM) == 0) {
+			struct gaba_section_s const *as = _sec(a, aj, k), *bs = _sec(b, bj, k);
+			f = gaba_dp_fill(d, f, as == NULL ? &s->aftail : as, bs == NULL ? &s->bftail : bs);
+			m = (f->max > m->max) ? f : m;
+			aj += (f->status & GABA_STATUS_UPDATE_A) != 0;
+			bj += (f->status & GABA_STATUS_UPDATE_B) != 0;
 		}
-		debug("path(%x), array(%x)", *p, array);
-		if(*p++ != array) {
-			return(0);
+		leaf[k] = m;
+	}
+	#undef _sec
+
+	struct gaba_alignment_s *r[4], *x[4];
+	struct gaba_path_prefix_s p[4];
+	for(uint64_t i = 0; i < 4; i++) {
+		r[i] = gaba_dp_trace(d, leaf[i], NULL, NULL);
+		assert(r[i] != NULL, "%lu", i);
+	}
+	assert(gaba_dp_trace_tree(d, leaf, 4, NULL, NULL, x, p) == 4);
+	for(uint64_t i = 0; i < 4; i++) {
+		assert(x[i] != NULL, "%lu", i);
+		assert(x[i]->score == r[i]->score && x[i]->path->len == r[i]->path->len, "%lu", i);
+		assert(x[i]->slen == r[i]->slen && memcmp(x[i]->sec, r[i]->sec, sizeof(struct gaba_path_section_s) * r[i]->slen) == 0, "%lu", i);
+		assert(x[i]->mcnt == r[i]->mcnt && x[i]->xcnt == r[i]->xcnt && x[i]->gicnt == r[i]->gicnt, "%lu", i);
+
+		char cigar[256], xcigar[256];
+		gaba_dp_dump_cigar_forward(cigar, 256, r[i]->path->array, 0, r[i]->path->len);
+		gaba_dp_dump_cigar_forward(xcigar, 256, x[i]->path->array, 0, x[i]->path->len);
+		assert(strcmp(cigar, xcigar) == 0, "%lu, %s, %s", i, cigar, xcigar);
+
+		/* the shared prefix is equal to that of the leaf referred */
+		assert(p[i].ref <= i && (p[i].ref < i || p[i].len == 0), "%lu, %u, %u", i, p[i].ref, p[i].len);
+		for(uint32_t j = 0; j < p[i].len; j++) {
+			uint32_t const *u = x[i]->path->array, *v = x[p[i].ref]->path->array;
+			assert(((u[j>>5] ^ v[j>>5])>>(j & 31) & 0x01) == 0, "%lu, %u", i, j);
 		}
 	}
-	return(1);
+	assert(p[0].ref == 0, "%u", p[0].ref);
+	assert(p[1].ref == 0 && p[1].len == x[1]->path->len, "%u, %u", p[1].ref, p[1].len);
+	assert(p[2].ref < 2 && p[2].len > 0 && p[2].len < x[2]->path->len, "%u, %u", p[2].ref, p[2].len);
+	assert(p[3].ref == 3 && x[3]->path->len == 0, "%u", p[3].ref);
+
+	/* encoded paths, in the caller's buffer */
+	uint64_t size = 0;
+	for(uint64_t i = 0; i < 4; i++) {
+		size += _roundup(gaba_dp_trace_size(d, leaf[i], NULL,
+			GABA_TRACE_PARAMS( .mode = GABA_TRACE_RLE )), 16);
+	}
+	uint8_t *buf = (uint8_t *)malloc(size);
+	assert(gaba_dp_trace_tree(d, leaf, 4, NULL,
+		GABA_TRACE_PARAMS( .buf = buf, .buf_size = size, .mode = GABA_TRACE_RLE ), x, NULL) == 4);
+	for(uint64_t i = 0; i < 4; i++) {
+		assert((uint8_t *)x[i] >= buf && (uint8_t *)x[i] < buf + size && x[i]->rle != NULL, "%lu", i);
+		char cigar[256], xcigar[256];
+		gaba_dp_dump_cigar_forward(cigar, 256, r[i]->path->array, 0, r[i]->path->len);
+		gaba_dp_dump_cigar_rle(xcigar, 256, x[i]->rle);
+		assert(strcmp(cigar, xcigar) == 0, "%lu, %s, %s", i, cigar, xcigar);
+	}
+	free(buf);
+	gaba_dp_clean(d);
 }
 
-static
-int check_cigar(
-	struct gaba_alignment_s const *aln,
-	char const *cigar)
+/* mismatches across the boundary of the vector comparison */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGA" "TC" "GTTAGCATGCAAGTCCAGTAC",
+	"GATTACAGGCTTAACGTCCAGTACGATCGGA" "AG" "GTTAGCATGCAAGTCCAGTAC"))
 {
-	char buf[1024];
-
-	debug("path(%x), len(%lld)", aln->path->array[0], aln->path->len);
-
-	uint64_t l = gaba_dp_dump_cigar_forward(
-		buf, 1024, aln->path->array, 0, aln->path->len);
+	omajinai();
 
-	debug("cigar(%s)", buf);
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
 
-	/* first check length */
-	if(strlen(cigar) != l) { return(0); }
+	char cigar[128], md[128];
+	gaba_dp_dump_cigar_ext(d, cigar, 128, md, 128, r, NULL, 0);
+	assert(strcmp(cigar, "31=2X21=") == 0, "%s", cigar);
+	assert(strcmp(md, "31T0C21") == 0, "%s", md);
 
-	/* next compare cigar string */
-	return((strcmp(buf, cigar) == 0) ? 1 : 0);
+	gaba_dp_clean(d);
 }
 
-#define decode_path(_r) ({ \
-	uint64_t plen = (_r)->path->len, cnt = 0; \
-	uint32_t const *path = (_r)->path->array; \
-	uint32_t path_array = *path; \
-	char *ptr = alloca(plen); \
-	char *p = ptr; \
- 	while(plen-- > 0) { \
-		*p++ = (path_array & 0x01) ? 'D' : 'R'; \
-		path_array >>= 1; \
-		if(++cnt == 32) { \
-			path_array = *++path; \
-			cnt = 0; \
-		} \
-	} \
-	*p = '\0'; \
-	ptr; \
-})
-#define print_path(_r)			"%s", decode_path(_r)
-#define check_section(_s, _a, _apos, _alen, _b, _bpos, _blen, _ppos, _pl) ( \
-	   (_s).aid == (_a).id \
-	&& (_s).apos == (_apos) \
-	&& (_s).alen == (_alen) \
-	&& (_s).bid == (_b).id \
-	&& (_s).bpos == (_bpos) \
-	&& (_s).blen == (_blen) \
-	&& (_s).ppos == (_ppos) \
-	&& _plen(&(_s)) == (_pl) \
-)
-#define print_section(_s) \
-	"a(%u), apos(%u), alen(%u), b(%u), bpos(%u), blen(%u), ppos(%u), plen(%u)", \
-	(_s).aid, (_s).apos, (_s).alen, \
-	(_s).bid, (_s).bpos, (_s).blen, \
-	(_s).ppos, _plen(&(_s))
+/* local clipping, mismatching head in front of a matching region */
+unittest(with_seq_pair(
+	"TTTTT" "GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCA",
+	"GGGGG" "GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCA"))
+{
+	omajinai();
 
-/* global configuration of the tests */
-unittest_config(
-	.name = "gaba",
-	.init = unittest_build_context,
-	.clean = unittest_clean_context
-);
+	/* keep the fragment where the max was reached */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0), *t = f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	assert(f->max == 65, "%lld", f->max);
 
-/**
- * check if gaba_init returns a valid pointer to a context
- */
-unittest()
-{
-	struct gaba_context_s const *c = (struct gaba_context_s const *)gctx;
-	assert(c != NULL, "%p", c);
+	/* extension keeps the seed */
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+	assert(r->score == 65 && r->xcnt == 5, "score(%lld), xcnt(%lld)", r->score, r->xcnt);
+	assert(check_cigar(r, "45M"), print_path(r));
+
+	/* local mode moves the start past the mismatches */
+	r = gaba_dp_trace(d, f, NULL, GABA_TRACE_PARAMS( .mode = GABA_TRACE_LOCAL ));
+	assert(r != NULL);
+	assert(r->score == 80 && r->xcnt == 0, "score(%lld), xcnt(%lld)", r->score, r->xcnt);
+	assert(r->gicnt == 0 && r->gecnt == 0, "gicnt(%lld), gecnt(%lld)", r->gicnt, r->gecnt);
+	assert(check_cigar(r, "40M"), print_path(r));
+	assert(r->slen == 1, "%u", r->slen);
+	assert(check_section(r->sec[0], s->afsec, 5, 40, s->bfsec, 5, 40, 0, 80), print_section(r->sec[0]));
+	assert(r->rsidx == 0 && r->rppos == 0, "rsidx(%u), rppos(%u)", r->rsidx, r->rppos);
+	assert(r->rapos == 5 && r->rbpos == 5, "rapos(%u), rbpos(%u)", r->rapos, r->rbpos);
+
+	gaba_dp_clean(d);
 }
 
-/**
- * check if unittest_build_seqs returns a valid seq_pair and sections
- */
-unittest(with_seq_pair("A", "A"))
+/* global mode, forced through a mismatching stretch exceeding the X-drop threshold */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCA" "TTTTTTTT" "GTACGATCGGATCCTAGGCA",
+	"GATTACAGGCTTAACGTCCA" "GGGGGGGG" "GTACGATCGGATCCTAGGCA"))
 {
 	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	p.xdrop = 20;
+	p.mode = GABA_MODE_GLOBAL;
+	gaba_t *c = gaba_init(&p);
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
 
-	/* check pointer */
-	assert(s != NULL, "%p", s);
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert((f->status & GABA_STATUS_TERM) == 0, "%x", f->status);
+	f = gaba_dp_fill_end(d, f);
+	assert(f != NULL);
+	assert((f->status & (GABA_STATUS_TERM | GABA_STATUS_END)) == (GABA_STATUS_TERM | GABA_STATUS_END), "%x", f->status);
 
-	/* check sequences */
-	assert(strncmp((char const *)s->a,
-		"\x01\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\x04\0",
-		22) == 0, "%s", (char const *)s->a);
-	assert(strncmp((char const *)s->b,
-		"\x01\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\x02\0",
-		22) == 0, "%s", (char const *)s->b);
-	assert(s->alen == 21, "%llu", s->alen);
-	assert(s->blen == 21, "%llu", s->blen);
+	/* traceback starts from the end cell, not from the max */
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+	assert(r->score == 56 && r->xcnt == 8, "score(%lld), xcnt(%lld)", r->score, r->xcnt);
+	assert(check_cigar(r, "48M"), print_path(r));
+	assert(r->slen == 1, "%u", r->slen);
+	assert(check_section(r->sec[0], s->afsec, 0, 48, s->bfsec, 0, 48, 0, 96), print_section(r->sec[0]));
+
+	gaba_dp_clean(d);
+	gaba_clean(c);
+}
+
+/* extension mode, the max is searched back over the fragments of gaba_dp_fill_end */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCA" "TTTTTTTT" "GTACGATCGGATCCTAGGCA",
+	"GATTACAGGCTTAACGTCCA" "GGGGGGGG" "GTACGATCGGATCCTAGGCA"))
+{
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	p.xdrop = 20;
+	gaba_t *c = gaba_init(&p);
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
 
-	/* check forward sections */
-	assert(s->afsec.id == 0, "%d", s->afsec.id);
-	assert((uintptr_t)s->afsec.base == (uintptr_t)s->a + 0, "%p", s->afsec.base);
-	assert(s->afsec.len == 1, "%u", s->afsec.len);
+	struct gaba_fill_s *m = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	struct gaba_fill_s *f = gaba_dp_fill_end(d, m);
+	assert(f != NULL && f != m && f->max == m->max, "%lld, %lld", f->max, m->max);
+	assert((f->status & GABA_STATUS_END) == 0, "%x", f->status);
 
-	assert(s->aftail.id == 2, "%d", s->aftail.id);
-	assert((uintptr_t)s->aftail.base == (uintptr_t)s->a + 1, "%p", s->aftail.base);
-	assert(s->aftail.len == 20, "%u", s->aftail.len);
+	struct gaba_pos_pair_s fp = gaba_dp_search_max(d, f), mp = gaba_dp_search_max(d, m);
+	assert(fp.apos == mp.apos && fp.bpos == mp.bpos, "(%u, %u), (%u, %u)", fp.apos, fp.bpos, mp.apos, mp.bpos);
 
-	assert(s->bfsec.id == 4, "%d", s->bfsec.id);
-	assert((uintptr_t)s->bfsec.base == (uintptr_t)s->b + 0, "%p", s->bfsec.base);
-	assert(s->bfsec.len == 1, "%u", s->bfsec.len);
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	struct gaba_alignment_s *q = gaba_dp_trace(d, m, NULL, NULL);
+	assert(r != NULL && q != NULL);
+	assert(r->score == q->score && r->path->len == q->path->len, "%lld, %lld", r->score, q->score);
 
-	assert(s->bftail.id == 6, "%d", s->bftail.id);
-	assert((uintptr_t)s->bftail.base == (uintptr_t)s->b + 1, "%p", s->bftail.base);
-	assert(s->bftail.len == 20, "%u", s->bftail.len);
+	gaba_dp_clean(d);
+	gaba_clean(c);
+}
 
-	/* check reverse sections */
-	assert(s->arsec.id == 1, "%d", s->arsec.id);
-	assert((uintptr_t)s->arsec.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->a - 1, "%p", s->arsec.base);
-	assert(s->arsec.len == 1, "%u", s->arsec.len);
+/* global mode, sections with different lengths */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAACG", "GATTACAGGCTTAACGTCCA"))
+{
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	p.mode = GABA_MODE_GLOBAL;
+	gaba_t *c = gaba_init(&p);
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
 
-	assert(s->artail.id == 3, "%d", s->artail.id);
-	assert((uintptr_t)s->artail.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->a - 21, "%p", s->artail.base);
-	assert(s->artail.len == 20, "%u", s->artail.len);
+	/* continue the longer section until both are exhausted */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	f = gaba_dp_fill_end(d, f);
+	assert(f != NULL);
+	assert((f->status & GABA_STATUS_END) != 0, "%x", f->status);
 
-	assert(s->brsec.id == 5, "%d", s->brsec.id);
-	assert((uintptr_t)s->brsec.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->b - 1, "%p", s->brsec.base);
-	assert(s->brsec.len == 1, "%u", s->brsec.len);
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+	#if MODEL == LINEAR
+		assert(r->score == 22, "%lld", r->score);
+	#else
+		assert(r->score == 32, "%lld", r->score);
+	#endif
+	assert(r->xcnt == 0 && r->gecnt == 3, "xcnt(%lld), gecnt(%lld)", r->xcnt, r->gecnt);
+	assert(check_cigar(r, "20M3D"), print_path(r));
+	assert(check_section(r->sec[0], s->afsec, 0, 23, s->bfsec, 0, 20, 0, 43), print_section(r->sec[0]));
 
-	assert(s->brtail.id == 7, "%d", s->brtail.id);
-	assert((uintptr_t)s->brtail.base == (uintptr_t)0x1000000000000 - (uintptr_t)s->b - 21, "%p", s->brtail.base);
-	assert(s->brtail.len == 20, "%u", s->brtail.len);
+	gaba_dp_clean(d);
+	gaba_clean(c);
 }
 
-/**
- * check if gaba_dp_init returns a vaild pointer to a dp context
- */
-#define omajinai() \
-	struct gaba_context_s const *c = (struct gaba_context_s const *)gctx; \
-	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx; \
+/* sections with the ids reserved for the margins are rejected */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCA", "GATTACAGGCTTAACGTCCA"))
+{
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	p.mode = GABA_MODE_GLOBAL;
+	gaba_t *c = gaba_init(&p);
 	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
 
-unittest(with_seq_pair("A", "A"))
-{
-	omajinai();
+	struct gaba_section_s a = gaba_build_section(GABA_MARGIN_AID, s->afsec.base, s->afsec.len);
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &a, 0, &s->bfsec, 0);
+	assert(f != NULL);
+	assert(gaba_dp_fill_end(d, f) == NULL);
 
-	assert(d != NULL, "%p", d);
 	gaba_dp_clean(d);
+	gaba_clean(c);
 }
 
-/**
- * check if gaba_dp_fill_root and gaba_dp_fill returns a correct score
- */
-unittest(with_seq_pair("A", "A"))
+/* end bonus, the path is extended to the end of the shorter sequence */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCA" "GGGGG", "GATTACAGGCTTAACGTCCA" "TTTTTTTTTT"))
 {
-	omajinai();
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	gaba_t *c = gaba_init(&p);
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
 
-	/* fill root section */
+	/* stops at the max without the bonus */
 	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 0, 0, -29, 1), print_tail(f));
+	f = gaba_dp_fill_end(d, f);
+	assert(f != NULL);
+	assert((f->status & GABA_STATUS_END) == 0, "%x", f->status);
 
-	/* fill again */
-	f = gaba_dp_fill(d, f, &s->afsec, &s->bfsec);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 0, 0, -27, 2), print_tail(f));
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r->score == 40, "%lld", r->score);
+	assert(check_cigar(r, "20M"), print_path(r));
+	gaba_dp_clean(d);
+	gaba_clean(c);
 
-	/* fill tail section */
-	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 4, 13, 13, 3), print_tail(f));
+	/* reaches the end of a with the bonus */
+	p.ebonus = 20;
+	c = gaba_init(&p);
+	d = gaba_dp_init(c, s->alim, s->blim);
 
-	/* fill tail section again */
-	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	f = gaba_dp_fill_end(d, f);
+	assert(f != NULL);
+	assert((f->status & (GABA_STATUS_TERM | GABA_STATUS_END)) == (GABA_STATUS_TERM | GABA_STATUS_END), "%x", f->status);
+
+	r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
 	#if MODEL == LINEAR
-		assert(f->status == 0x1ff, "%x", f->status);
-		assert(check_tail(f, 4, 40, 53, 4), print_tail(f));
+		assert(r->score == 25, "%lld", r->score);
+		assert(check_cigar(r, "25M"), print_path(r));
+		assert(check_section(r->sec[0], s->afsec, 0, 25, s->bfsec, 0, 25, 0, 50), print_section(r->sec[0]));
 	#else
-		assert(f->status == 0x10f, "%x", f->status);
-		assert(check_tail(f, 4, 31, 44, 4), print_tail(f));
+		assert(r->score == 30, "%lld", r->score);
+		assert(check_cigar(r, "20M5D"), print_path(r));
+		assert(check_section(r->sec[0], s->afsec, 0, 25, s->bfsec, 0, 20, 0, 45), print_section(r->sec[0]));
 	#endif
 
 	gaba_dp_clean(d);
+	gaba_clean(c);
 }
 
-/* reverse fetch */
-unittest(with_seq_pair("A", "A"))
+/* band recentering, the centering band loses a diagonal 19 bases off the root with the max on its edge */
+unittest(with_seq_pair(
+	"CAAGGACCAGGTGAGCAGT"
+	"GGTGCTTTCTGGCTGTCGAGGGCCACAGCGCTACCCAACCATTCGCAATCGCT",
+	"GGTGCTTTCTGGCTGTCGAGGGCCACAGCGCTACCCAACCATTCGCAATCGCT"))
 {
-	omajinai();
-
-	/* fill root section */
-	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->arsec, 0, &s->brsec, 0);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 0, 0, -29, 1), print_tail(f));
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	p.xdrop = 60;
+	p.steer = GABA_STEER_CENTER;
+	gaba_t *c = gaba_init(&p);
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
 
-	/* fill again */
-	f = gaba_dp_fill(d, f, &s->arsec, &s->brsec);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 0, 0, -27, 2), print_tail(f));
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	#if MODEL == LINEAR
+		assert(f->max == 0, "%lld", f->max);
+		assert((f->status & GABA_STATUS_EDGE) == 0, "%x", f->status);
+	#else
+		assert(f->max == 2, "%lld", f->max);
+		assert((f->status & GABA_STATUS_EDGE) != 0, "%x", f->status);
+	#endif
+	gaba_dp_clean(d);
+	gaba_clean(c);
 
-	/* fill tail section */
-	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 4, 13, 13, 3), print_tail(f));
+	/* refilled with the band shifted toward the edge, the X-drop termination alone does not trigger it */
+	p.recenter = 64;
+	c = gaba_init(&p);
+	d = gaba_dp_init(c, s->alim, s->blim);
 
-	/* fill tail section again */
-	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
+	f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
 	#if MODEL == LINEAR
-		assert(f->status == 0x1ff, "%x", f->status);
-		assert(check_tail(f, 4, 40, 53, 4), print_tail(f));
+		assert(f->max == 0, "%lld", f->max);
 	#else
-		assert(f->status == 0x10f, "%x", f->status);
-		assert(check_tail(f, 4, 31, 44, 4), print_tail(f));
+		assert(f->max == 50, "%lld", f->max);
+		assert((f->status & GABA_STATUS_EDGE) == 0, "%x", f->status);
+
+		struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+		assert(r != NULL);
+		assert(r->score == f->max, "score(%lld), max(%lld)", r->score, f->max);
 	#endif
 
 	gaba_dp_clean(d);
+	gaba_clean(c);
 }
 
-/* with longer sequences */
-unittest(with_seq_pair("ACGTACGTACGT", "ACGTACGTACGT"))
+/* band recentering, the checkpoints of the refill leave the fill of a long pair unchanged */
+unittest(with_seq_pair("A", "A"))
+{
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+
+	static uint8_t a[8192 + 64], b[9216 + 64];
+	uint64_t x = 0x1234567;
+	#define _rand()		( x = x * 6364136223846793005ULL + 1442695040888963407ULL, x>>33 )
+	int64_t m = 8192, n = 0;
+	for(int64_t i = 0; i < m; i++) {
+		uint64_t r = _rand() % 100;
+		a[i] = 0x01<<(_rand() % 4);
+		if(r < 2) { continue; }										/* deletion */
+		if(r < 4) { b[n++] = 0x01<<(_rand() % 4); }					/* insertion */
+		b[n++] = (r < 8) ? 0x01<<(_rand() % 4) : a[i];				/* substitution */
+	}
+	#undef _rand
+	struct gaba_section_s as = gaba_build_section(0, a, m), bs = gaba_build_section(2, b, n);
+
+	int64_t max[2], score[2], fmax[2];
+	uint32_t fapos[2];
+	for(uint64_t i = 0; i < 2; i++) {
+		struct gaba_params_s p = *unittest_default_params;
+		p.recenter = (i == 0) ? 0 : 64;
+		gaba_t *c = gaba_init(&p);
+		struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
+
+		struct gaba_fill_s *f = gaba_dp_fill_root(d, &as, 0, &bs, 0);
+		struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+		assert(r != NULL);
+		max[i] = f->max; fmax[i] = f->fmax; fapos[i] = f->fapos;
+		score[i] = r->score;
+
+		gaba_dp_clean(d);
+		gaba_clean(c);
+	}
+	assert(max[0] > 8192 && max[0] == max[1], "max(%lld, %lld)", max[0], max[1]);
+	assert(score[0] == max[0] && score[1] == max[1], "score(%lld, %lld)", score[0], score[1]);
+	assert(fmax[0] == fmax[1] && fapos[0] == fapos[1], "fmax(%lld, %lld), fapos(%u, %u)", fmax[0], fmax[1], fapos[0], fapos[1]);
+}
+
+/* banded edit distance, a substitution, a deletion, and an insertion */
+unittest(with_seq_pair("GATTACAGGCTTAACGTCCAGTACGATCGG", "GATTACAGCCTTAACGTCAGTACGATTCGG"))
 {
 	omajinai();
 
-	/* fill root section */
-	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 0, 0, -7, 1), print_tail(f));
+	assert(gaba_dp_edit_dist(d, &s->afsec, 0, &s->bfsec, 0, 5) == 3);
+	assert(gaba_dp_edit_dist(d, &s->arsec, 0, &s->brsec, 0, 5) == 3);
+	assert(gaba_dp_edit_dist(d, &s->afsec, 0, &s->bfsec, 0, 3) == 3);
+	assert(gaba_dp_edit_dist(d, &s->afsec, 0, &s->bfsec, 0, 1) == 2);
+	assert(gaba_dp_edit_dist(d, &s->afsec, 8, &s->bfsec, 8, 5) == 3);
+	assert(gaba_dp_edit_dist(d, &s->afsec, 20, &s->bfsec, 19, 5) == 1);
+	assert(gaba_dp_edit_dist(d, &s->afsec, 24, &s->bfsec, 30, 5) == 6);
+	assert(gaba_dp_edit_dist(d, &s->afsec, 24, &s->bfsec, 30, 10) == 6);
 
-	/* fill again */
-	f = gaba_dp_fill(d, f, &s->afsec, &s->bfsec);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 16, 17, 17, 2), print_tail(f));
+	gaba_dp_clean(d);
+}
 
-	/* fill tail section */
-	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 48, 40, 57, 3), print_tail(f));
+/* banded edit distance, compared to the naive dp on random pairs */
+unittest(with_seq_pair("A", "A"))
+{
+	omajinai();
 
-	/* fill tail section again */
-	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
-	#if MODEL == LINEAR
-		assert(f->status == 0x1ff, "%x", f->status);
-		assert(check_tail(f, 48, 40, 97, 4), print_tail(f));
-	#else
-		assert(f->status == 0x10f, "%x", f->status);
-		assert(check_tail(f, 48, 31, 88, 4), print_tail(f));
-	#endif
+	uint64_t x = 0x1234567;
+	#define _rand()		( x = x * 6364136223846793005ULL + 1442695040888963407ULL, x>>33 )
+	for(uint64_t t = 0; t < 200; t++) {
+		uint8_t a[160], b[160];
+		int64_t m = 1 + _rand() % 128, n = 0;
+		for(int64_t i = 0; i < m; i++) { a[i] = 0x01<<(_rand() % 4); }
+		for(int64_t i = 0; i < m && n < 150; i++) {
+			uint64_t r = _rand() % 100;
+			if(r < 4) { continue; }										/* deletion */
+			if(r < 8) { b[n++] = 0x01<<(_rand() % 4); }					/* insertion */
+			b[n++] = (r < 12) ? 0x01<<(_rand() % 4) : a[i];				/* substitution */
+		}
+
+		int64_t dp[161];
+		for(int64_t j = 0; j <= n; j++) { dp[j] = j; }
+		for(int64_t i = 1; i <= m; i++) {
+			int64_t diag = dp[0]; dp[0] = i;
+			for(int64_t j = 1; j <= n; j++) {
+				int64_t v = MIN3(dp[j] + 1, dp[j - 1] + 1, diag + ((a[i - 1] & b[j - 1]) == 0));
+				diag = dp[j]; dp[j] = v;
+			}
+		}
+
+		struct gaba_section_s as = gaba_build_section(0, a, m), bs = gaba_build_section(2, b, n);
+		uint32_t const k[3] = { 4, 12, 31 };
+		for(uint64_t i = 0; i < 3; i++) {
+			int64_t e = gaba_dp_edit_dist(d, &as, 0, &bs, 0, k[i]);
+			assert(e == MIN2(dp[n], k[i] + 1), "t(%llu), k(%u), e(%lld), dp(%lld)", t, k[i], e, dp[n]);
+		}
+	}
+	#undef _rand
 
 	gaba_dp_clean(d);
 }
 
-/* reverse fetch */
-unittest(with_seq_pair("ACGTACGTACGT", "ACGTACGTACGT"))
+/* ungapped x-drop extension */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCA" "TTTTTTTT" "GTACGATCGGATCCTAGGCA",
+	"GATTACAGGCTTAACGTCCA" "GGGGGGGG" "GTACGATCGGATCCTAGGCA"))
 {
 	omajinai();
 
-	/* fill root section */
-	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->arsec, 0, &s->brsec, 0);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 0, 0, -7, 1), print_tail(f));
+	/* over the mismatching stretch, across the vector boundary */
+	struct gaba_ungapped_s u = gaba_dp_ungapped(d, &s->afsec, 0, &s->bfsec, 0);
+	assert(u.score == 56 && u.len == 48 && u.diag == 0, "score(%lld), len(%u), diag(%d)", u.score, u.len, u.diag);
+	u = gaba_dp_ungapped(d, &s->arsec, 0, &s->brsec, 0);
+	assert(u.score == 56 && u.len == 48 && u.diag == 0, "score(%lld), len(%u), diag(%d)", u.score, u.len, u.diag);
+	u = gaba_dp_ungapped(d, &s->afsec, 30, &s->bfsec, 30);
+	assert(u.score == 36 && u.len == 18 && u.diag == 0, "score(%lld), len(%u), diag(%d)", u.score, u.len, u.diag);
 
-	/* fill again */
-	f = gaba_dp_fill(d, f, &s->arsec, &s->brsec);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 16, 17, 17, 2), print_tail(f));
+	/* seed off by one */
+	u = gaba_dp_ungapped(d, &s->afsec, 28, &s->bfsec, 29);
+	assert(u.score == 38 && u.len == 19 && u.diag == 1, "score(%lld), len(%u), diag(%d)", u.score, u.len, u.diag);
+	u = gaba_dp_ungapped(d, &s->afsec, 29, &s->bfsec, 28);
+	assert(u.score == 38 && u.len == 19 && u.diag == -1, "score(%lld), len(%u), diag(%d)", u.score, u.len, u.diag);
 
-	/* fill tail section */
-	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
-	assert(f->status == 0x1ff, "%x", f->status);
-	assert(check_tail(f, 48, 40, 57, 3), print_tail(f));
+	gaba_dp_clean(d);
+}
 
-	/* fill tail section again */
-	f = gaba_dp_fill(d, f, &s->artail, &s->brtail);
-	#if MODEL == LINEAR
-		assert(f->status == 0x1ff, "%x", f->status);
-		assert(check_tail(f, 48, 40, 97, 4), print_tail(f));
-	#else
-		assert(f->status == 0x10f, "%x", f->status);
-		assert(check_tail(f, 48, 31, 88, 4), print_tail(f));
-	#endif
+/* ungapped prefilter, x-drop at the mismatching stretch */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCA" "TTTTTTTT" "GTACGATCGGATCCTAGGCA",
+	"GATTACAGGCTTAACGTCCA" "GGGGGGGG" "GTACGATCGGATCCTAGGCA"))
+{
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	p.xdrop = 20;
+	p.ungapped = 41;
+	gaba_t *c = gaba_init(&p);
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
+
+	struct gaba_ungapped_s u = gaba_dp_ungapped(d, &s->afsec, 0, &s->bfsec, 0);
+	assert(u.score == 40 && u.len == 20 && u.diag == 0, "score(%lld), len(%u), diag(%d)", u.score, u.len, u.diag);
+
+	/* rejected without filling blocks */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert(f != NULL);
+	assert((f->status & GABA_STATUS_TERM) != 0, "%x", f->status);
+	assert(f->max == 0, "%lld", f->max);
+	assert(f->fmax == INT64_MIN, "%lld", f->fmax);
+	gaba_dp_clean(d);
+	gaba_clean(c);
+
+	/* passes with the threshold at the score */
+	p.ungapped = 40;
+	c = gaba_init(&p);
+	d = gaba_dp_init(c, s->alim, s->blim);
+	f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert(f != NULL);
+	assert(f->max == 40, "%lld", f->max);
+
+	gaba_dp_clean(d);
+	gaba_clean(c);
+}
+
+/* target-score early termination, resumed on the same sections */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA",
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA"))
+{
+	struct unittest_sections_s const *s = (struct unittest_sections_s const *)ctx;
+	struct gaba_params_s p = *unittest_default_params;
+	p.score_stop = 100;
+	gaba_t *c = gaba_init(&p);
+	struct gaba_dp_context_s *d = gaba_dp_init(c, s->alim, s->blim);
+
+	/* stops within a block after the max reaches the target */
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert((f->status & (GABA_STATUS_STOP | GABA_STATUS_TERM)) == GABA_STATUS_STOP, "%x", f->status);
+	assert(f->max >= 100 && f->max < 100 + 2 * BLK, "%lld", f->max);
+
+	/* resumed to the end without stopping again, keep the fragment where the max was reached */
+	struct gaba_fill_s *t = gaba_dp_fill(d, f, &s->afsec, &s->bfsec);
+	assert((t->status & GABA_STATUS_STOP) == 0, "%x", t->status);
+	f = (t->max > f->max) ? t : f;
+	while((t->status & GABA_STATUS_TERM) == 0) {
+		t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+		f = (t->max > f->max) ? t : f;
+	}
+	assert(f->max == 240, "%lld", f->max);
+
+	struct gaba_alignment_s *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+	assert(r->score == 240, "%lld", r->score);
+	assert(check_cigar(r, "120M"), print_path(r));
+	assert(r->slen == 1, "%u", r->slen);
+
+	gaba_dp_clean(d);
+	gaba_clean(c);
+}
+
+/* per-fragment max */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA",
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC"
+	"TCAGGACTTCGATGCCATAGGTACCTTGAGCATCGATGGCTAACGTTGACCAGTCATGCA"))
+{
+	omajinai();
+
+	struct gaba_fill_s *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	assert(f->fmax == f->max, "fmax(%lld), max(%lld)", f->fmax, f->max);
+	assert(f->faid == s->afsec.id && f->fbid == s->bfsec.id, "faid(%u), fbid(%u)", f->faid, f->fbid);
+	assert(f->fapos == f->fbpos && f->fapos < 120, "fapos(%u), fbpos(%u)", f->fapos, f->fbpos);
+	assert(f->fmax == 2 * (f->fapos + 1), "fmax(%lld), fapos(%u)", f->fmax, f->fapos);
+
+	/* the cells at the ends of the sections are filled in the next fragment */
+	struct gaba_fill_s *t = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	assert(t->max == 240, "%lld", t->max);
+	assert(t->fmax == t->max, "fmax(%lld), max(%lld)", t->fmax, t->max);
+	assert(t->faid == s->afsec.id && t->fbid == s->bfsec.id, "faid(%u), fbid(%u)", t->faid, t->fbid);
+	assert(t->fapos == 119 && t->fbpos == 119, "fapos(%u), fbpos(%u)", t->fapos, t->fbpos);
+
+	/* not improved on the mismatching tails */
+	t = gaba_dp_fill(d, t, &s->aftail, &s->bftail);
+	assert(t->max == 240, "%lld", t->max);
+	assert(t->fmax < t->max, "fmax(%lld), max(%lld)", t->fmax, t->max);
 
 	gaba_dp_clean(d);
 }
@@ -5147,10 +9480,107 @@ unittest()
 	gaba_dp_dump_cigar_forward(buf, len, _arr(0xaaabf554, 0xaaaa0556, 0xaaaaaaaa), 0, 65);
 	assert(strcmp(buf, "2D5M5I8M1I5M5D8M") == 0, "%s", buf);
 
+	/* runs longer than a word are not split */
+	gaba_dp_dump_cigar_forward(buf, len, _arr(0x55555555, 0, 0, 0, 0x55555555), 0, 160);
+	assert(strcmp(buf, "16M96D16M") == 0, "%s", buf);
+
+	gaba_dp_dump_cigar_forward(buf, len, _arr(0x55555555, 0xffffffff, 0xffffffff, 0xffffffff, 0x55555555), 0, 160);
+	assert(strcmp(buf, "16M96I16M") == 0, "%s", buf);
+
+	gaba_dp_dump_cigar_forward(buf, len, _arr(0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555), 2, 254);
+	assert(strcmp(buf, "127M") == 0, "%s", buf);
+
 	#undef _arr
 	free(buf);
 }
 
+/* short mixed runs decoded from the table, against a bit-by-bit decoder */
+static
+char *ut_decode_forward(
+	char *b,
+	uint32_t const *path,
+	int64_t offset,
+	int64_t len)
+{
+	#define _bit(_i)		( (path[(_i)>>5]>>((_i) & 31)) & 0x01 )
+	int64_t pos = offset, ridx = len;
+	while(1) {
+		int64_t k = 0;
+		while(k <= ridx && _bit(pos + k) == ((k & 0x01) ^ 0x01)) { k++; }
+		int64_t m = MIN2(k, ridx) & ~0x01;
+		if(m > 0) { b += sprintf(b, "%ldM", (long)(m>>1)); }
+		pos += m; ridx -= m;
+		if(ridx == 0) { break; }
+
+		int64_t r = 0, c = _bit(pos);
+		while(r <= ridx && _bit(pos + r) == c) { r++; }
+		int64_t g = MIN2(r - c, ridx);
+		if(g > 0) { b += sprintf(b, "%ld%c", (long)g, c ? 'I' : 'D'); }
+		pos += g; ridx -= g;
+		if(ridx <= 1) { break; }
+	}
+	#undef _bit
+	*b = '\0';
+	return(b);
+}
+
+unittest()
+{
+	uint64_t const cnt = 256;
+	uint32_t *arr = (uint32_t *)malloc(sizeof(uint32_t) * (cnt + 2));
+	char *buf = (char *)malloc(16384), *ref = (char *)malloc(16384);
+	uint32_t bam[8192];
+
+	uint64_t x = 1;
+	for(uint64_t t = 0; t < 200; t++) {
+		/* random bits, biased to ones or zeros on the odd trials for longer gaps */
+		for(uint64_t i = 0; i < cnt; i++) {
+			x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+			uint32_t r = x>>32;
+			arr[i] = (t & 0x01) ? ((t & 0x02) ? (r & (r>>3)) : (r | (r>>5))) : r;
+		}
+		arr[cnt] = arr[cnt + 1] = 0x55555555;
+
+		/* at both phases of the 64-bit words, from an offset */
+		uint32_t const *path = arr + ((t>>2) & 0x01);
+		int64_t ofs = t % 37, plen = 32 * (cnt - 1) - ofs - t;
+		ut_decode_forward(ref, path, ofs, plen);
+
+		gaba_dp_dump_cigar_forward(buf, 16384, path, ofs, plen);
+		assert(strcmp(buf, ref) == 0, "%lu, %lu, %lu", t, strlen(buf), strlen(ref));
+
+		char *p = buf;
+		gaba_dp_print_cigar_forward(ut_printer, (void *)&p, path, ofs, plen);
+		assert(strcmp(buf, ref) == 0, "%lu, %lu, %lu", t, strlen(buf), strlen(ref));
+
+		uint64_t bcnt = gaba_dp_dump_bam_cigar_forward(bam, 8192, path, ofs, plen), l = 0;
+		for(uint64_t i = 0; i < bcnt; i++) {
+			l += sprintf(buf + l, "%u%c", bam[i]>>4, "MID"[bam[i] & 0x0f]);
+		}
+		assert(strcmp(buf, ref) == 0, "%lu, %lu, %lu", t, strlen(buf), strlen(ref));
+	}
+
+	/* lengths formatted in the lanes of a word, and above */
+	uint64_t const glen[3] = { 1234567, 99999999, 123456789 };
+	for(uint64_t j = 0; j < 3; j++) {
+		uint64_t w = (glen[j] + 32 + 31) / 32 + 4;
+		uint32_t *g = (uint32_t *)malloc(sizeof(uint32_t) * w);
+		memset(g, 0xff, sizeof(uint32_t) * w);
+		g[0] = 0x55555555;
+		uint64_t plen = 32 + glen[j];
+		g[plen>>5] &= (0x01ULL<<(plen & 31)) - 1;
+		g[plen>>5] |= 0x55555555ULL<<(plen & 31);
+		g[(plen>>5) + 1] = 0x55555555;
+
+		gaba_dp_dump_cigar_forward(buf, 16384, g, 0, plen);
+		sprintf(ref, "16M%luI", glen[j]);
+		assert(strcmp(buf, ref) == 0, "%s, %s", buf, ref);
+		free(g);
+	}
+
+	free(arr); free(buf); free(ref);
+}
+
 unittest()
 {
 	uint64_t const len = 16384;
@@ -5199,10 +9629,46 @@ unittest()
 	gaba_dp_dump_cigar_reverse(buf, len, _arr(0xaaabf554, 0xaaaa0556, 0xaaaaaaaa), 0, 65);
 	assert(strcmp(buf, "8M5D5M1I8M5I5M2D") == 0, "%s", buf);
 
+	/* runs longer than a word are not split */
+	gaba_dp_dump_cigar_reverse(buf, len, _arr(0x55555555, 0, 0, 0, 0x55555555), 0, 160);
+	assert(strcmp(buf, "16M96D16M") == 0, "%s", buf);
+
+	gaba_dp_dump_cigar_reverse(buf, len, _arr(0x55555555, 0xffffffff, 0xffffffff, 0xffffffff, 0x55555555), 0, 160);
+	assert(strcmp(buf, "16M96I16M") == 0, "%s", buf);
+
+	gaba_dp_dump_cigar_reverse(buf, len, _arr(0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555, 0x55555555), 2, 254);
+	assert(strcmp(buf, "127M") == 0, "%s", buf);
+
 	#undef _arr
 	free(buf);
 }
 
+/* BAM cigar */
+unittest()
+{
+	uint32_t buf[16];
+	#define _arr(...)		( (uint32_t const []){ 0, 0, __VA_ARGS__, 0, 0 } + 2 )
+	#define _op(_l, _c)		( ((_l)<<4) | (((_c) == 'M') ? 0 : ((_c) == 'I') ? 1 : 2) )
+
+	uint64_t l = gaba_dp_dump_bam_cigar_forward(buf, 16, _arr(0x55555555, 0x55555555), 0, 64);
+	assert(l == 1 && buf[0] == _op(32, 'M'), "%lu, %x", l, buf[0]);
+
+	l = gaba_dp_dump_bam_cigar_forward(buf, 16, _arr(0xaaabf554, 0xaaaa0556, 0xaaaaaaaa), 0, 65);
+	uint32_t const f[] = { _op(2, 'D'), _op(5, 'M'), _op(5, 'I'), _op(8, 'M'), _op(1, 'I'), _op(5, 'M'), _op(5, 'D'), _op(8, 'M') };
+	assert(l == 8 && memcmp(buf, f, sizeof(f)) == 0, "%lu", l);
+
+	l = gaba_dp_dump_bam_cigar_reverse(buf, 16, _arr(0xaaabf554, 0xaaaa0556, 0xaaaaaaaa), 0, 65);
+	uint32_t const r[] = { _op(8, 'M'), _op(5, 'D'), _op(5, 'M'), _op(1, 'I'), _op(8, 'M'), _op(5, 'I'), _op(5, 'M'), _op(2, 'D') };
+	assert(l == 8 && memcmp(buf, r, sizeof(r)) == 0, "%lu", l);
+
+	/* truncated at the buffer size */
+	l = gaba_dp_dump_bam_cigar_forward(buf, 3, _arr(0xaaabf554, 0xaaaa0556, 0xaaaaaaaa), 0, 65);
+	assert(l == 3 && memcmp(buf, f, 3 * sizeof(uint32_t)) == 0, "%lu", l);
+
+	#undef _op
+	#undef _arr
+}
+
 /**
  * check if gaba_dp_trace returns a correct path
  */
@@ -74,9 +74,46 @@ struct gaba_params_s {
 	/** output options */
 	uint8_t head_margin;		/** margin at the head of gaba_res_t */
 	uint8_t tail_margin;		/** margin at the tail of gaba_res_t */
+
+	/** alignment mode */
+	uint8_t mode;				/** GABA_MODE_EXTEND (default) or GABA_MODE_GLOBAL */
+	uint8_t ebonus;				/** end bonus, the same on the ends of a and b, applied only by gaba_dp_fill_end, zero to disable */
+	uint8_t recenter;			/** band shift on the refill of the segment with the max at the edge, zero to disable */
+
+	/** band steering */
+	uint8_t steer;				/** GABA_STEER_EDGE (default), GABA_STEER_CENTER, or GABA_STEER_HYBRID */
+
+	/** ungapped prefilter */
+	uint8_t ungapped;			/** min. ungapped X-drop score to start gaba_dp_fill_root, set zero to disable */
+	uint8_t _pad[3];
+
+	/** early termination */
+	int64_t score_stop;			/** stop the fill with GABA_STATUS_STOP once the max reaches it, set zero to disable */
 };
 typedef struct gaba_params_s gaba_params_t;
 
+/**
+ * @enum gaba_mode
+ * @brief GABA_MODE_GLOBAL disables the X-drop termination. paths are forced to the ends
+ * of the terminal sections with gaba_dp_fill_end.
+ */
+enum gaba_mode {
+	GABA_MODE_EXTEND			= 0,
+	GABA_MODE_GLOBAL			= 1
+};
+
+/**
+ * @enum gaba_steer
+ * @brief band steering policies. EDGE follows the difference of the scores at the two
+ * edges of the band, CENTER moves the band to put the max lane at the center after
+ * each block, and HYBRID steers by the edges while the max stays in the central half.
+ */
+enum gaba_steer {
+	GABA_STEER_EDGE				= 0,
+	GABA_STEER_CENTER			= 1,
+	GABA_STEER_HYBRID			= 2
+};
+
 /**
  * @macro GABA_PARAMS
  * @brief utility macro for gaba_init, see example on header.
@@ -143,7 +180,12 @@ struct gaba_fill_s {
 	int64_t max;				/** (8) max */
 	uint32_t status;			/** (4) */
 
-	uint8_t _pad[36];
+	uint8_t _pad[100];
+
+	/* exact max of the cells filled in this fragment and the cell where it was first reached */
+	int64_t fmax;				/** (8) max of the cells filled in this fragment, INT64_MIN if no cell was filled */
+	uint32_t faid, fbid;		/** (8) ids of the sections of the cell of fmax */
+	uint32_t fapos, fbpos;		/** (8) positions of the cell of fmax on the sections */
 };
 typedef struct gaba_fill_s gaba_fill_t;
 
@@ -155,7 +197,10 @@ enum gaba_status {
 	GABA_STATUS_UPDATE		= 0x100,
 	GABA_STATUS_UPDATE_A 	= 0x0f,
 	GABA_STATUS_UPDATE_B 	= 0xf0,
-	GABA_STATUS_TERM		= 0x200
+	GABA_STATUS_TERM		= 0x200,
+	GABA_STATUS_END			= 0x400,
+	GABA_STATUS_EDGE		= 0x800,
+	GABA_STATUS_STOP		= 0x1000	/** the max reached score_stop, resumable with gaba_dp_fill on the same sections */
 };
 
 /**
@@ -187,6 +232,27 @@ struct gaba_path_s {
 };
 typedef struct gaba_path_s gaba_path_t;
 
+/**
+ * @struct gaba_path_rle_s
+ * @brief run-length encoded path, in the BAM cigar encoding (op_len<<4 | op, M = 0, I = 1, D = 2)
+ */
+struct gaba_path_rle_s {
+	uint32_t len;				/** (4) #operations */
+	uint32_t reserved;
+	uint32_t op[];				/** () operations */
+};
+typedef struct gaba_path_rle_s gaba_path_rle_t;
+
+/**
+ * @struct gaba_path_prefix_s
+ * @brief path prefix shared with another result of gaba_dp_trace_tree
+ */
+struct gaba_path_prefix_s {
+	uint32_t ref;				/** (4) index of the result sharing the prefix, itself if none */
+	uint32_t len;				/** (4) length of the shared prefix of path->array */
+};
+typedef struct gaba_path_prefix_s gaba_path_prefix_t;
+
 /**
  * @struct gaba_alignment_s
  */
@@ -201,6 +267,18 @@ struct gaba_alignment_s {
 	uint32_t slen;
 	struct gaba_path_section_s const *sec;
 	struct gaba_path_s const *path;
+
+	/* exact counts on the sequences */
+	uint32_t mcnt;				/** (4) #matches */
+	uint32_t icnt, dcnt;		/** (8) #inserted (on b) and #deleted (on a) bases */
+	uint32_t nm;				/** (4) edit distance, xcnt + icnt + dcnt */
+
+	/* run-length encoded copy of path, NULL unless traced with GABA_TRACE_RLE */
+	struct gaba_path_rle_s const *rle;
+
+	/* columns left out of mcnt and xcnt */
+	uint32_t acnt;				/** (4) #columns matched on an ambiguous base (not one of ACGT) */
+	uint32_t ucnt;				/** (4) #columns on sequences not located (seeds), not compared */
 };
 typedef struct gaba_alignment_s gaba_alignment_t;
 
@@ -210,6 +288,15 @@ typedef struct gaba_alignment_s gaba_alignment_t;
  */
 gaba_t *gaba_init(gaba_params_t const *params);
 
+/**
+ * @fn gaba_init_linear_filter
+ * @brief (API) linear-gap context for the first stage of gaba_dp_fill_cascade. the gap open
+ * penalty is dropped from params, so its cell scores are never below those of the affine
+ * recurrence. the filter is heuristic: the band and the X-drop termination follow each model's
+ * own path, so the linear max may fall below the affine one and reject a passing candidate.
+ */
+gaba_t *gaba_init_linear_filter(gaba_params_t const *params);
+
 /**
  * @fn gaba_clean
  *
@@ -260,8 +347,38 @@ void gaba_dp_flush_stack(
 void gaba_dp_clean(
 	gaba_dp_t *dp);
 
+/**
+ * @struct gaba_watchdog_params_s
+ * @brief thresholds of the slow-call capture, see gaba_dp_set_watchdog
+ */
+struct gaba_watchdog_params_s {
+	uint64_t cell_thresh;		/** dump fills of more cells or traces of longer paths than this, zero to disable */
+	uint64_t usec_thresh;		/** dump calls which take longer than this (in usec), zero to disable */
+	char const *path;			/** path to the dump file, must be kept valid while the watchdog is enabled */
+};
+typedef struct gaba_watchdog_params_s gaba_watchdog_params_t;
+
+/**
+ * @macro GABA_WATCHDOG_PARAMS
+ */
+#define GABA_WATCHDOG_PARAMS(...)	( &((struct gaba_watchdog_params_s const) { __VA_ARGS__ }) )
+
+/**
+ * @fn gaba_dp_set_watchdog
+ * @brief enable slow-call capture on the dp context (disable if params is NULL).
+ * fill, fill_end, and trace calls exceeding either threshold append the section pairs of
+ * their tail chains and the params of the context to the dump file, which can be replayed
+ * with bench -r.
+ */
+void gaba_dp_set_watchdog(
+	gaba_dp_t *dp,
+	gaba_watchdog_params_t const *params);
+
 /**
  * @fn gaba_dp_fill_root
+ * @brief with a non-zero ungapped in the params, the section pair is first extended by
+ * gaba_dp_ungapped, and the returned fill has GABA_STATUS_TERM without any block filled
+ * if the ungapped score is below the threshold.
  */
 gaba_fill_t *gaba_dp_fill_root(
 	gaba_dp_t *dp,
@@ -280,6 +397,103 @@ gaba_fill_t *gaba_dp_fill(
 	gaba_section_t const *a,
 	gaba_section_t const *b);
 
+/**
+ * @macro GABA_MARGIN_AID, GABA_MARGIN_BID
+ * @brief section ids reserved for the internal margins of gaba_dp_fill_end
+ */
+#define GABA_MARGIN_AID				( 0xfffe )
+#define GABA_MARGIN_BID				( 0xffff )
+
+/**
+ * @fn gaba_dp_fill_end
+ * @brief fill the tail triangle after the terminal sections of prev_sec with internal margins.
+ * the returned fill has GABA_STATUS_TERM, and GABA_STATUS_END if the cell at the ends of
+ * both sections is in the band. gaba_dp_trace starts from the end cell on such fills.
+ * the end bonus (ebonus in the params) takes effect only here: gaba_dp_fill and
+ * gaba_dp_fill_root cannot tell the end of a section from the end of a sequence, so
+ * the sections of prev_sec are taken as the terminal ones.
+ * the margins take the ids GABA_MARGIN_AID and GABA_MARGIN_BID, which the sections must not
+ * use, and a static array of the library, which must lie below lim. returns NULL otherwise.
+ */
+gaba_fill_t *gaba_dp_fill_end(
+	gaba_dp_t *dp,
+	gaba_fill_t const *prev_sec);
+
+/**
+ * @fn gaba_dp_edit_dist
+ * @brief banded unit-cost (Levenshtein) distance between a[apos..] and b[bpos..] for
+ * prefiltering candidates before gaba_dp_fill_root. returns the distance if it is at most
+ * max_dist (capped at 31), max_dist + 1 otherwise.
+ */
+int64_t gaba_dp_edit_dist(
+	gaba_dp_t *dp,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos,
+	uint32_t max_dist);
+
+/**
+ * @struct gaba_ungapped_s
+ * @brief result of gaba_dp_ungapped
+ */
+struct gaba_ungapped_s {
+	int64_t score;				/** (8) max of the ungapped extension, the diagonal shift is not penalized */
+	uint32_t len;				/** (4) length of the extension at the max */
+	int32_t diag;				/** (4) -1, 0, or 1, the extension starts at (apos + max(diag, 0), bpos + max(-diag, 0)) */
+};
+typedef struct gaba_ungapped_s gaba_ungapped_t;
+
+/**
+ * @fn gaba_dp_ungapped
+ * @brief ungapped X-drop extension of a[apos..] and b[bpos..] on the seed diagonal and the
+ * two diagonals next to it, with the match award, mismatch penalty, and xdrop in the params.
+ * the best of the three is returned. no block is allocated on the dp context.
+ */
+gaba_ungapped_t gaba_dp_ungapped(
+	gaba_dp_t *dp,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos);
+
+/**
+ * @enum gaba_cascade_stage
+ */
+enum gaba_cascade_stage {
+	GABA_CASCADE_LINEAR			= 1,	/** rejected by the linear-gap filter */
+	GABA_CASCADE_AFFINE			= 2		/** passed the filter and refilled with the affine-gap scores */
+};
+
+/**
+ * @struct gaba_cascade_s
+ * @brief result of gaba_dp_fill_cascade
+ */
+struct gaba_cascade_s {
+	gaba_fill_t const *fill;	/** (8) terminal fill of the stage that decided, on the dp context of the stage */
+	int64_t lmax;				/** (8) max of the linear-gap stage */
+	uint32_t stage;				/** (4) GABA_CASCADE_LINEAR or GABA_CASCADE_AFFINE */
+	uint32_t _pad;
+};
+typedef struct gaba_cascade_s gaba_cascade_t;
+
+/**
+ * @fn gaba_dp_fill_cascade
+ * @brief extend a[apos..] and b[bpos..] to the ends (or to the X-drop termination) on the
+ * linear-gap dp context ldp (see gaba_init_linear_filter), and again on the affine-gap dp
+ * context adp only if the linear max reaches min_score. the linear stage is a heuristic
+ * filter, not a bound (see gaba_init_linear_filter). the two contexts read the same
+ * sections, which must be built on the same lims.
+ */
+gaba_cascade_t gaba_dp_fill_cascade(
+	gaba_dp_t *ldp,
+	gaba_dp_t *adp,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos,
+	int64_t min_score);
+
 /**
  * @fn gaba_dp_merge
  */
@@ -295,6 +509,34 @@ gaba_pos_pair_t gaba_dp_search_max(
 	gaba_dp_t *dp,
 	gaba_fill_t const *sec);
 
+/**
+ * @struct gaba_max_s
+ * @brief a score maximum reported by gaba_dp_search_topk, traceable with gaba_dp_trace_max
+ */
+struct gaba_max_s {
+	gaba_fill_t const *fill;	/** (8) fragment containing the max */
+	void const *blk;			/** (8) (internal) block containing the max */
+	uint32_t aridx, bridx;		/** (8) (internal) reverse indices on the sections */
+	int32_t p, q;				/** (8) local anti-diagonal in the fragment and lane in the band */
+	int64_t score;				/** (8) score at the max */
+	uint32_t apos, bpos;		/** (8) positions on the sections, same as gaba_dp_search_max */
+};
+typedef struct gaba_max_s gaba_max_t;
+
+/**
+ * @fn gaba_dp_search_topk
+ * @brief search at most k score maxima on the fragments from sec to the root.
+ * the global max comes first, followed by local maxima sorted by score.
+ * each max is at least min_dist away from the others in anti-diagonal or lane.
+ * returns the number of maxima stored in max.
+ */
+uint32_t gaba_dp_search_topk(
+	gaba_dp_t *dp,
+	gaba_fill_t const *sec,
+	uint32_t k,
+	uint32_t min_dist,
+	gaba_max_t *max);
+
 /**
  * @struct gaba_trace_params_s
  */
@@ -304,10 +546,27 @@ struct gaba_trace_params_s {
 	uint16_t slen;				/* section length */
 	uint16_t k;					/* path length (k-mer length) */
 	uint16_t xcnt;				/* #mismatches */
-	uint16_t _pad;
+	uint16_t mode;				/* GABA_TRACE_EXTEND or GABA_TRACE_LOCAL, | GABA_TRACE_RLE */
+
+	/* result is placed here instead of lmm or the dp stack if not NULL, see gaba_dp_trace_size */
+	void *buf;
+	uint64_t buf_size;
 };
 typedef struct gaba_trace_params_s gaba_trace_params_t;
 
+/**
+ * @enum gaba_trace_mode
+ * @brief GABA_TRACE_LOCAL clips the path to its best-scoring segment, moving the
+ * start off the seed when the head of the path scores negative. GABA_TRACE_RLE adds the
+ * run-length encoded path (aln->rle) to the result. it is a convenience encoding built on top
+ * of the bit path, which is always kept, so it adds memory to the result rather than saving it.
+ */
+enum gaba_trace_mode {
+	GABA_TRACE_EXTEND			= 0,
+	GABA_TRACE_LOCAL			= 1,
+	GABA_TRACE_RLE				= 2
+};
+
 /**
  * @macro GABA_TRACE_PARAMS
  */
@@ -331,10 +590,91 @@ gaba_alignment_t *gaba_dp_trace(
 	gaba_fill_t const *rv_tail,
 	gaba_trace_params_t const *params);
 
+/**
+ * @fn gaba_dp_trace_size
+ *
+ * @brief size of the buffer (gaba_trace_params_s.buf) that holds the result of tracing on
+ * the pair of tails with params, including the head and tail margins, and the encoded path
+ * if params->mode has GABA_TRACE_RLE. it bounds the results of gaba_dp_trace and
+ * gaba_dp_trace_max on the tails and their ancestors. the trace fails (returns NULL) if
+ * buf_size is short, or if the encoded path does not fit in the rest of the buffer.
+ */
+uint64_t gaba_dp_trace_size(
+	gaba_dp_t *dp,
+	gaba_fill_t const *fw_tail,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params);
+
+/**
+ * @fn gaba_dp_trace_batch
+ *
+ * @brief generate alignments on cnt pairs of tails, aln[i] on fw_tail[i] and rv_tail[i]
+ * (root if the array or the element is NULL), same as gaba_dp_trace on each pair. the
+ * tails and the first two blocks of the walks of up to 16 pairs are prefetched at once,
+ * then the pairs are traced one after another. the results are placed
+ * in params->buf in order, each in a slot of gaba_dp_trace_size rounded up to 16 bytes,
+ * if the buffer is given. returns the number of successful traces, failures are NULL.
+ */
+uint64_t gaba_dp_trace_batch(
+	gaba_dp_t *dp,
+	gaba_fill_t const *const *fw_tail,
+	gaba_fill_t const *const *rv_tail,
+	uint64_t cnt,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln);
+
+/**
+ * @fn gaba_dp_trace_tree
+ *
+ * @brief generate alignments on cnt leaves of a fill tree, aln[i] on fw_tail[i] (root if
+ * the array or the element is NULL) and the common rv_tail, same as gaba_dp_trace on each
+ * leaf. the path from the root to the branch shared with a leaf traced before is copied
+ * from that leaf instead of traced again. prefix[i] (if not NULL) reports the leaf
+ * (prefix[i].ref < i) and the length of path->array equal to its path; prefix[i].ref is i
+ * if no prefix is shared. the results are placed in params->buf in the same slots as
+ * gaba_dp_trace_batch. returns the number of successful traces, failures are NULL.
+ */
+uint64_t gaba_dp_trace_tree(
+	gaba_dp_t *dp,
+	gaba_fill_t const *const *fw_tail,
+	uint64_t cnt,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln,
+	gaba_path_prefix_t *prefix);
+
+/**
+ * @fn gaba_dp_trace_max
+ *
+ * @brief generate alignment from maxima reported by gaba_dp_search_topk (root if NULL)
+ */
+gaba_alignment_t *gaba_dp_trace_max(
+	gaba_dp_t *dp,
+	gaba_max_t const *fw_max,
+	gaba_max_t const *rv_max,
+	gaba_trace_params_t const *params);
+
+/**
+ * @fn gaba_dp_trace_cell
+ *
+ * @brief generate alignment from the cells at fw_pos and rv_pos, positions on the current
+ * sections of the tails (same as gaba_dp_search_max). the max is used if the position is
+ * NULL. returns NULL if the cell is out of the band of the last fragment.
+ */
+gaba_alignment_t *gaba_dp_trace_cell(
+	gaba_dp_t *dp,
+	gaba_fill_t const *fw_tail,
+	gaba_pos_pair_t const *fw_pos,
+	gaba_fill_t const *rv_tail,
+	gaba_pos_pair_t const *rv_pos,
+	gaba_trace_params_t const *params);
+
 /**
  * @fn gaba_dp_recombine
  *
- * @brief recombine two alignments x and y at xsid and ysid.
+ * @brief recombine two alignments x and y at xsid and ysid. the result has the sections
+ * of x up to xsid and those of y from ysid, rescored on the sequences. x and y are
+ * released in either case; NULL if the indices are out of range.
  */
 gaba_alignment_t *gaba_dp_recombine(
 	gaba_dp_t *dp,
@@ -349,6 +689,34 @@ gaba_alignment_t *gaba_dp_recombine(
 void gaba_dp_res_free(
 	gaba_alignment_t *aln);
 
+/**
+ * @struct gaba_rescore_s
+ * @brief statistics of an alignment rescored with gaba_dp_rescore
+ */
+struct gaba_rescore_s {
+	int64_t score;				/** (8) score under the params */
+	uint32_t mcnt, xcnt;		/** (8) #matches, #mismatches */
+	uint32_t gicnt, gecnt;		/** (8) #gap opens, #gap bases */
+	double identity;			/** (8) mcnt / (mcnt + xcnt + acnt + gecnt), zero if empty */
+	uint32_t acnt, ucnt;		/** (8) #ambiguous columns, #columns not located (see gaba_alignment_s) */
+};
+typedef struct gaba_rescore_s gaba_rescore_t;
+
+/**
+ * @fn gaba_dp_rescore
+ * @brief rescore the alignment under params (the scores of dp if NULL) without filling again.
+ * sec is the list of the sections the alignment was built on, located by their ids; the
+ * reverse-complemented section of id ^ 0x01 is also accepted. columns on the sections not
+ * found in the list (seeds) are reported in ucnt, and scored as matches like the ambiguous
+ * ones in acnt; neither is included in mcnt.
+ */
+gaba_rescore_t gaba_dp_rescore(
+	gaba_dp_t *dp,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen,
+	gaba_params_t const *params);
+
 /**
  * @fn gaba_dp_print_cigar_forward
  *
@@ -398,6 +766,98 @@ uint64_t gaba_dp_dump_cigar_reverse(
 	uint32_t offset,
 	uint32_t len);
 
+/**
+ * @fn gaba_dp_dump_bam_cigar_forward
+ *
+ * @brief convert path string to BAM binary cigar (op_len<<4 | op, with M = 0, I = 1, D = 2).
+ * buf_size is in operations, and #operations stored is returned.
+ */
+uint64_t gaba_dp_dump_bam_cigar_forward(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len);
+
+/**
+ * @fn gaba_dp_dump_bam_cigar_reverse
+ */
+uint64_t gaba_dp_dump_bam_cigar_reverse(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len);
+
+/**
+ * @fn gaba_dp_dump_bam_cigar_batch
+ *
+ * @brief store BAM cigars of cnt alignments contiguously in buf. the operations of aln[i]
+ * are in buf[ofs[i]] .. buf[ofs[i + 1] - 1], so ofs must hold cnt + 1 elements. returns
+ * the number of alignments stored, less than cnt if buf is exhausted.
+ */
+uint64_t gaba_dp_dump_bam_cigar_batch(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint64_t *ofs,
+	gaba_alignment_t const *const *aln,
+	uint64_t cnt);
+
+/**
+ * @fn gaba_dp_print_cigar_rle
+ *
+ * @brief print cigar from the run-length encoded path, in O(#operations)
+ */
+uint64_t gaba_dp_print_cigar_rle(
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_path_rle_t const *rle);
+
+/**
+ * @fn gaba_dp_dump_cigar_rle
+ *
+ * @brief store cigar from the run-length encoded path to buf, returns the length
+ */
+uint64_t gaba_dp_dump_cigar_rle(
+	char *buf,
+	uint64_t buf_size,
+	gaba_path_rle_t const *rle);
+
+/**
+ * @fn gaba_dp_print_cigar_ext
+ *
+ * @brief convert the alignment to extended cigar (=/X/I/D), comparing the bases on the
+ * sections listed in aln->sec.
+ * @detail
+ * the sequences are located on sec (by id, or id ^ 0x01 for the reverse-complemented one)
+ * if not NULL, or on the tails the alignment was traced on otherwise, which are valid until
+ * gaba_dp_flush is called. columns on the sections not located are emitted as M.
+ */
+uint64_t gaba_dp_print_cigar_ext(
+	gaba_dp_t *dp,
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen);
+
+/**
+ * @fn gaba_dp_dump_cigar_ext
+ *
+ * @brief store extended cigar to buf, and MD tag (the bases of a, as the reference) to md if
+ * not NULL, in one pass. returns the length of the cigar string. the MD tag is left empty
+ * if any column or deleted base is on a section not located.
+ */
+uint64_t gaba_dp_dump_cigar_ext(
+	gaba_dp_t *dp,
+	char *buf,
+	uint64_t buf_size,
+	char *md,
+	uint64_t md_size,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen);
+
 #endif  /* #ifndef _GABA_H_INCLUDED */
 
 /*
@@ -49,9 +49,18 @@ struct gaba_api_s {
 		gaba_fill_t const *prev_sec,
 		gaba_section_t const *a,
 		gaba_section_t const *b);
+	gaba_fill_t *(*dp_fill_end)(
+		gaba_dp_t *this,
+		gaba_fill_t const *prev_sec);
 	gaba_pos_pair_t (*dp_search_max)(
 		gaba_dp_t *this,
 		gaba_fill_t const *sec);
+	uint32_t (*dp_search_topk)(
+		gaba_dp_t *this,
+		gaba_fill_t const *sec,
+		uint32_t k,
+		uint32_t min_dist,
+		gaba_max_t *max);
 
 	/* trace */
 	gaba_alignment_t *(*dp_trace)(
@@ -59,8 +68,35 @@ struct gaba_api_s {
 		gaba_fill_t const *fw_tail,
 		gaba_fill_t const *rv_tail,
 		gaba_trace_params_t const *params);
+	gaba_alignment_t *(*dp_trace_max)(
+		gaba_dp_t *this,
+		gaba_max_t const *fw_max,
+		gaba_max_t const *rv_max,
+		gaba_trace_params_t const *params);
+	gaba_alignment_t *(*dp_trace_cell)(
+		gaba_dp_t *this,
+		gaba_fill_t const *fw_tail,
+		gaba_pos_pair_t const *fw_pos,
+		gaba_fill_t const *rv_tail,
+		gaba_pos_pair_t const *rv_pos,
+		gaba_trace_params_t const *params);
+	uint64_t (*dp_trace_batch)(
+		gaba_dp_t *this,
+		gaba_fill_t const *const *fw_tail,
+		gaba_fill_t const *const *rv_tail,
+		uint64_t cnt,
+		gaba_trace_params_t const *params,
+		gaba_alignment_t **aln);
+	uint64_t (*dp_trace_tree)(
+		gaba_dp_t *this,
+		gaba_fill_t const *const *fw_tail,
+		uint64_t cnt,
+		gaba_fill_t const *rv_tail,
+		gaba_trace_params_t const *params,
+		gaba_alignment_t **aln,
+		gaba_path_prefix_t *prefix);
 };
-_static_assert(sizeof(struct gaba_api_s) == 6 * sizeof(void *));
+_static_assert(sizeof(struct gaba_api_s) == 12 * sizeof(void *));
 #define _api(_ctx)				( (struct gaba_api_s const *)(_ctx) )
 
 
@@ -84,6 +120,9 @@ void gaba_dp_flush_stack_linear(
 	gaba_stack_t const *stack);
 void gaba_dp_clean_linear(
 	gaba_dp_t *this);
+void gaba_dp_set_watchdog_linear(
+	gaba_dp_t *this,
+	gaba_watchdog_params_t const *params);
 gaba_fill_t *gaba_dp_fill_root_linear(
 	gaba_dp_t *this,
 	gaba_section_t const *a,
@@ -95,6 +134,22 @@ gaba_fill_t *gaba_dp_fill_linear(
 	gaba_fill_t const *prev_sec,
 	gaba_section_t const *a,
 	gaba_section_t const *b);
+gaba_fill_t *gaba_dp_fill_end_linear(
+	gaba_dp_t *this,
+	gaba_fill_t const *prev_sec);
+int64_t gaba_dp_edit_dist_linear(
+	gaba_dp_t *this,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos,
+	uint32_t max_dist);
+gaba_ungapped_t gaba_dp_ungapped_linear(
+	gaba_dp_t *this,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos);
 gaba_fill_t *gaba_dp_merge_linear(
 	gaba_dp_t *this,
 	gaba_fill_t const *sec_list,
@@ -102,11 +157,44 @@ gaba_fill_t *gaba_dp_merge_linear(
 gaba_pos_pair_t gaba_dp_search_max_linear(
 	gaba_dp_t *this,
 	gaba_fill_t const *sec);
+uint32_t gaba_dp_search_topk_linear(
+	gaba_dp_t *this,
+	gaba_fill_t const *sec,
+	uint32_t k,
+	uint32_t min_dist,
+	gaba_max_t *max);
 gaba_alignment_t *gaba_dp_trace_linear(
 	gaba_dp_t *this,
 	gaba_fill_t const *fw_tail,
 	gaba_fill_t const *rv_tail,
 	gaba_trace_params_t const *params);
+gaba_alignment_t *gaba_dp_trace_max_linear(
+	gaba_dp_t *this,
+	gaba_max_t const *fw_max,
+	gaba_max_t const *rv_max,
+	gaba_trace_params_t const *params);
+gaba_alignment_t *gaba_dp_trace_cell_linear(
+	gaba_dp_t *this,
+	gaba_fill_t const *fw_tail,
+	gaba_pos_pair_t const *fw_pos,
+	gaba_fill_t const *rv_tail,
+	gaba_pos_pair_t const *rv_pos,
+	gaba_trace_params_t const *params);
+uint64_t gaba_dp_trace_batch_linear(
+	gaba_dp_t *this,
+	gaba_fill_t const *const *fw_tail,
+	gaba_fill_t const *const *rv_tail,
+	uint64_t cnt,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln);
+uint64_t gaba_dp_trace_tree_linear(
+	gaba_dp_t *this,
+	gaba_fill_t const *const *fw_tail,
+	uint64_t cnt,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln,
+	gaba_path_prefix_t *prefix);
 gaba_alignment_t *gaba_dp_recombine_linear(
 	gaba_dp_t *this,
 	gaba_alignment_t *x,
@@ -115,6 +203,12 @@ gaba_alignment_t *gaba_dp_recombine_linear(
 	uint32_t ysid);
 void gaba_dp_res_free_linear(
 	gaba_alignment_t *res);
+gaba_rescore_t gaba_dp_rescore_linear(
+	gaba_dp_t *this,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen,
+	gaba_params_t const *params);
 int64_t gaba_dp_print_cigar_forward_linear(
 	gaba_dp_printer_t printer,
 	void *fp,
@@ -139,6 +233,53 @@ int64_t gaba_dp_dump_cigar_reverse_linear(
 	uint32_t const *path,
 	uint32_t offset,
 	uint32_t len);
+uint64_t gaba_dp_dump_bam_cigar_forward_linear(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len);
+uint64_t gaba_dp_dump_bam_cigar_reverse_linear(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len);
+uint64_t gaba_dp_dump_bam_cigar_batch_linear(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint64_t *ofs,
+	gaba_alignment_t const *const *aln,
+	uint64_t cnt);
+uint64_t gaba_dp_trace_size_linear(
+	gaba_dp_t *this,
+	gaba_fill_t const *fw_tail,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params);
+uint64_t gaba_dp_print_cigar_rle_linear(
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_path_rle_t const *rle);
+uint64_t gaba_dp_dump_cigar_rle_linear(
+	char *buf,
+	uint64_t buf_size,
+	gaba_path_rle_t const *rle);
+uint64_t gaba_dp_print_cigar_ext_linear(
+	gaba_dp_t *this,
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen);
+uint64_t gaba_dp_dump_cigar_ext_linear(
+	gaba_dp_t *this,
+	char *buf,
+	uint64_t buf_size,
+	char *md,
+	uint64_t md_size,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen);
 
 /* affine */
 gaba_t *gaba_init_affine(
@@ -160,6 +301,9 @@ void gaba_dp_flush_stack_affine(
 	gaba_stack_t const *stack);
 void gaba_dp_clean_affine(
 	gaba_dp_t *this);
+void gaba_dp_set_watchdog_affine(
+	gaba_dp_t *this,
+	gaba_watchdog_params_t const *params);
 gaba_fill_t *gaba_dp_fill_root_affine(
 	gaba_dp_t *this,
 	gaba_section_t const *a,
@@ -171,6 +315,22 @@ gaba_fill_t *gaba_dp_fill_affine(
 	gaba_fill_t const *prev_sec,
 	gaba_section_t const *a,
 	gaba_section_t const *b);
+gaba_fill_t *gaba_dp_fill_end_affine(
+	gaba_dp_t *this,
+	gaba_fill_t const *prev_sec);
+int64_t gaba_dp_edit_dist_affine(
+	gaba_dp_t *this,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos,
+	uint32_t max_dist);
+gaba_ungapped_t gaba_dp_ungapped_affine(
+	gaba_dp_t *this,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos);
 gaba_fill_t *gaba_dp_merge_affine(
 	gaba_dp_t *this,
 	gaba_fill_t const *sec_list,
@@ -178,11 +338,44 @@ gaba_fill_t *gaba_dp_merge_affine(
 gaba_pos_pair_t gaba_dp_search_max_affine(
 	gaba_dp_t *this,
 	gaba_fill_t const *sec);
+uint32_t gaba_dp_search_topk_affine(
+	gaba_dp_t *this,
+	gaba_fill_t const *sec,
+	uint32_t k,
+	uint32_t min_dist,
+	gaba_max_t *max);
 gaba_alignment_t *gaba_dp_trace_affine(
 	gaba_dp_t *this,
 	gaba_fill_t const *fw_tail,
 	gaba_fill_t const *rv_tail,
 	gaba_trace_params_t const *params);
+gaba_alignment_t *gaba_dp_trace_max_affine(
+	gaba_dp_t *this,
+	gaba_max_t const *fw_max,
+	gaba_max_t const *rv_max,
+	gaba_trace_params_t const *params);
+gaba_alignment_t *gaba_dp_trace_cell_affine(
+	gaba_dp_t *this,
+	gaba_fill_t const *fw_tail,
+	gaba_pos_pair_t const *fw_pos,
+	gaba_fill_t const *rv_tail,
+	gaba_pos_pair_t const *rv_pos,
+	gaba_trace_params_t const *params);
+uint64_t gaba_dp_trace_batch_affine(
+	gaba_dp_t *this,
+	gaba_fill_t const *const *fw_tail,
+	gaba_fill_t const *const *rv_tail,
+	uint64_t cnt,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln);
+uint64_t gaba_dp_trace_tree_affine(
+	gaba_dp_t *this,
+	gaba_fill_t const *const *fw_tail,
+	uint64_t cnt,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln,
+	gaba_path_prefix_t *prefix);
 gaba_alignment_t *gaba_dp_recombine_affine(
 	gaba_dp_t *this,
 	gaba_alignment_t *x,
@@ -191,6 +384,12 @@ gaba_alignment_t *gaba_dp_recombine_affine(
 	uint32_t ysid);
 void gaba_dp_res_free_affine(
 	gaba_alignment_t *res);
+gaba_rescore_t gaba_dp_rescore_affine(
+	gaba_dp_t *this,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen,
+	gaba_params_t const *params);
 int64_t gaba_dp_print_cigar_forward_affine(
 	gaba_dp_printer_t printer,
 	void *fp,
@@ -215,9 +414,88 @@ int64_t gaba_dp_dump_cigar_reverse_affine(
 	uint32_t const *path,
 	uint32_t offset,
 	uint32_t len);
-
-
-/* function table */
+uint64_t gaba_dp_dump_bam_cigar_forward_affine(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len);
+uint64_t gaba_dp_dump_bam_cigar_reverse_affine(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len);
+uint64_t gaba_dp_dump_bam_cigar_batch_affine(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint64_t *ofs,
+	gaba_alignment_t const *const *aln,
+	uint64_t cnt);
+uint64_t gaba_dp_trace_size_affine(
+	gaba_dp_t *this,
+	gaba_fill_t const *fw_tail,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params);
+uint64_t gaba_dp_print_cigar_rle_affine(
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_path_rle_t const *rle);
+uint64_t gaba_dp_dump_cigar_rle_affine(
+	char *buf,
+	uint64_t buf_size,
+	gaba_path_rle_t const *rle);
+uint64_t gaba_dp_print_cigar_ext_affine(
+	gaba_dp_t *this,
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen);
+uint64_t gaba_dp_dump_cigar_ext_affine(
+	gaba_dp_t *this,
+	char *buf,
+	uint64_t buf_size,
+	char *md,
+	uint64_t md_size,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen);
+
+
+/* steering variants, api functions only */
+#define _decl_api(_suffix) \
+	gaba_t *gaba_init##_suffix(gaba_params_t const *params); \
+	void gaba_clean##_suffix(gaba_t *ctx); \
+	gaba_fill_t *gaba_dp_fill_root##_suffix(gaba_dp_t *this, \
+		gaba_section_t const *a, uint32_t apos, gaba_section_t const *b, uint32_t bpos); \
+	gaba_fill_t *gaba_dp_fill##_suffix(gaba_dp_t *this, \
+		gaba_fill_t const *prev_sec, gaba_section_t const *a, gaba_section_t const *b); \
+	gaba_fill_t *gaba_dp_fill_end##_suffix(gaba_dp_t *this, gaba_fill_t const *prev_sec); \
+	gaba_pos_pair_t gaba_dp_search_max##_suffix(gaba_dp_t *this, gaba_fill_t const *sec); \
+	uint32_t gaba_dp_search_topk##_suffix(gaba_dp_t *this, gaba_fill_t const *sec, \
+		uint32_t k, uint32_t min_dist, gaba_max_t *max); \
+	gaba_alignment_t *gaba_dp_trace##_suffix(gaba_dp_t *this, \
+		gaba_fill_t const *fw_tail, gaba_fill_t const *rv_tail, gaba_trace_params_t const *params); \
+	gaba_alignment_t *gaba_dp_trace_max##_suffix(gaba_dp_t *this, \
+		gaba_max_t const *fw_max, gaba_max_t const *rv_max, gaba_trace_params_t const *params); \
+	gaba_alignment_t *gaba_dp_trace_cell##_suffix(gaba_dp_t *this, \
+		gaba_fill_t const *fw_tail, gaba_pos_pair_t const *fw_pos, \
+		gaba_fill_t const *rv_tail, gaba_pos_pair_t const *rv_pos, gaba_trace_params_t const *params); \
+	uint64_t gaba_dp_trace_batch##_suffix(gaba_dp_t *this, \
+		gaba_fill_t const *const *fw_tail, gaba_fill_t const *const *rv_tail, uint64_t cnt, \
+		gaba_trace_params_t const *params, gaba_alignment_t **aln); \
+	uint64_t gaba_dp_trace_tree##_suffix(gaba_dp_t *this, \
+		gaba_fill_t const *const *fw_tail, uint64_t cnt, gaba_fill_t const *rv_tail, \
+		gaba_trace_params_t const *params, gaba_alignment_t **aln, gaba_path_prefix_t *prefix);
+_decl_api(_linear_center)
+_decl_api(_affine_center)
+_decl_api(_linear_hybrid)
+_decl_api(_affine_hybrid)
+#undef _decl_api
+
+/* function table, indexed by the gap model and the steering policy */
+#define _api_index(_model, _steer)		( (_model) + 3 * (_steer) )
 static
 struct gaba_api_s const api_table[] __attribute__(( aligned(16) )) = {
 	[LINEAR] = {
@@ -225,17 +503,48 @@ struct gaba_api_s const api_table[] __attribute__(( aligned(16) )) = {
 		.clean = gaba_clean_linear,
 		.dp_fill_root = gaba_dp_fill_root_linear,
 		.dp_fill = gaba_dp_fill_linear,
+		.dp_fill_end = gaba_dp_fill_end_linear,
 		.dp_search_max = gaba_dp_search_max_linear,
-		.dp_trace = gaba_dp_trace_linear
+		.dp_search_topk = gaba_dp_search_topk_linear,
+		.dp_trace = gaba_dp_trace_linear,
+		.dp_trace_max = gaba_dp_trace_max_linear,
+		.dp_trace_cell = gaba_dp_trace_cell_linear,
+		.dp_trace_batch = gaba_dp_trace_batch_linear,
+		.dp_trace_tree = gaba_dp_trace_tree_linear
 	},
 	[AFFINE] = {
 		.init = gaba_init_affine,
 		.clean = gaba_clean_affine,
 		.dp_fill_root = gaba_dp_fill_root_affine,
 		.dp_fill = gaba_dp_fill_affine,
+		.dp_fill_end = gaba_dp_fill_end_affine,
 		.dp_search_max = gaba_dp_search_max_affine,
-		.dp_trace = gaba_dp_trace_affine
+		.dp_search_topk = gaba_dp_search_topk_affine,
+		.dp_trace = gaba_dp_trace_affine,
+		.dp_trace_max = gaba_dp_trace_max_affine,
+		.dp_trace_cell = gaba_dp_trace_cell_affine,
+		.dp_trace_batch = gaba_dp_trace_batch_affine,
+		.dp_trace_tree = gaba_dp_trace_tree_affine
+	},
+	#define _api_entry(_suffix) { \
+		.init = gaba_init##_suffix, \
+		.clean = gaba_clean##_suffix, \
+		.dp_fill_root = gaba_dp_fill_root##_suffix, \
+		.dp_fill = gaba_dp_fill##_suffix, \
+		.dp_fill_end = gaba_dp_fill_end##_suffix, \
+		.dp_search_max = gaba_dp_search_max##_suffix, \
+		.dp_search_topk = gaba_dp_search_topk##_suffix, \
+		.dp_trace = gaba_dp_trace##_suffix, \
+		.dp_trace_max = gaba_dp_trace_max##_suffix, \
+		.dp_trace_cell = gaba_dp_trace_cell##_suffix, \
+		.dp_trace_batch = gaba_dp_trace_batch##_suffix, \
+		.dp_trace_tree = gaba_dp_trace_tree##_suffix \
 	}
+	[_api_index(LINEAR, GABA_STEER_CENTER)] = _api_entry(_linear_center),
+	[_api_index(AFFINE, GABA_STEER_CENTER)] = _api_entry(_affine_center),
+	[_api_index(LINEAR, GABA_STEER_HYBRID)] = _api_entry(_linear_hybrid),
+	[_api_index(AFFINE, GABA_STEER_HYBRID)] = _api_entry(_affine_hybrid)
+	#undef _api_entry
 };
 
 /**
@@ -249,10 +558,11 @@ int64_t gaba_init_get_index(
 		return(AFFINE);
 	}
 
+	int64_t steer = (params->steer > GABA_STEER_HYBRID) ? GABA_STEER_EDGE : params->steer;
 	if(params->gi != 0) {
-		return(AFFINE);
+		return(_api_index(AFFINE, steer));
 	}
-	return(LINEAR);
+	return(_api_index(LINEAR, steer));
 }
 
 /**
@@ -287,6 +597,25 @@ gaba_t *gaba_init(
 	return((gaba_t *)gaba_set_api((void *)api->init(params), api));
 }
 
+/**
+ * @fn gaba_init_linear_filter
+ */
+gaba_t *gaba_init_linear_filter(
+	gaba_params_t const *params)
+{
+	if(params == NULL) {
+		return(NULL);
+	}
+
+	/*
+	 * the linear penalty ge * k never exceeds gi + ge * k, so the scores are upper bounds cell by cell;
+	 * the band and the X-drop termination follow each model's own path, so the fill max is not
+	 */
+	struct gaba_params_s p = *params;
+	p.gi = 0;
+	return(gaba_init(&p));
+}
+
 /**
  * @fn gaba_clean
  */
@@ -350,6 +679,17 @@ void gaba_dp_clean(
 	return;
 }
 
+/**
+ * @fn gaba_dp_set_watchdog
+ */
+void gaba_dp_set_watchdog(
+	gaba_dp_t *this,
+	gaba_watchdog_params_t const *params)
+{
+	gaba_dp_set_watchdog_linear(this, params);
+	return;
+}
+
 /**
  * @fn gaba_dp_fill_root
  */
@@ -376,6 +716,89 @@ gaba_fill_t *gaba_dp_fill(
 	return(_api(this)->dp_fill(this, prev_sec, a, b));
 }
 
+/**
+ * @fn gaba_dp_fill_end
+ */
+gaba_fill_t *gaba_dp_fill_end(
+	gaba_dp_t *this,
+	gaba_fill_t const *prev_sec)
+{
+	return(_api(this)->dp_fill_end(this, prev_sec));
+}
+
+/**
+ * @fn gaba_dp_edit_dist
+ */
+int64_t gaba_dp_edit_dist(
+	gaba_dp_t *this,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos,
+	uint32_t max_dist)
+{
+	return(gaba_dp_edit_dist_linear(this, a, apos, b, bpos, max_dist));
+}
+
+/**
+ * @fn gaba_dp_ungapped
+ */
+gaba_ungapped_t gaba_dp_ungapped(
+	gaba_dp_t *this,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos)
+{
+	return(gaba_dp_ungapped_linear(this, a, apos, b, bpos));
+}
+
+/**
+ * @fn gaba_dp_fill_cascade_stage
+ * @brief fill from the root to the ends of the sections
+ */
+static inline
+gaba_fill_t const *gaba_dp_fill_cascade_stage(
+	gaba_dp_t *this,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos)
+{
+	gaba_fill_t const *f = _api(this)->dp_fill_root(this, a, apos, b, bpos);
+	if(f == NULL || (f->status & GABA_STATUS_TERM) != 0) {
+		return(f);
+	}
+	return(_api(this)->dp_fill_end(this, f));
+}
+
+/**
+ * @fn gaba_dp_fill_cascade
+ */
+gaba_cascade_t gaba_dp_fill_cascade(
+	gaba_dp_t *ldp,
+	gaba_dp_t *adp,
+	gaba_section_t const *a,
+	uint32_t apos,
+	gaba_section_t const *b,
+	uint32_t bpos,
+	int64_t min_score)
+{
+	gaba_fill_t const *f = gaba_dp_fill_cascade_stage(ldp, a, apos, b, bpos);
+	if(f == NULL || f->max < min_score) {
+		return((gaba_cascade_t){
+			.fill = f,
+			.lmax = (f == NULL) ? 0 : f->max,
+			.stage = GABA_CASCADE_LINEAR
+		});
+	}
+	return((gaba_cascade_t){
+		.fill = gaba_dp_fill_cascade_stage(adp, a, apos, b, bpos),
+		.lmax = f->max,
+		.stage = GABA_CASCADE_AFFINE
+	});
+}
+
 /**
  * @fn gaba_dp_merge
  */
@@ -398,6 +821,19 @@ gaba_pos_pair_t gaba_dp_search_max(
 	return(_api(this)->dp_search_max(this, sec));
 }
 
+/**
+ * @fn gaba_dp_search_topk
+ */
+uint32_t gaba_dp_search_topk(
+	gaba_dp_t *this,
+	gaba_fill_t const *sec,
+	uint32_t k,
+	uint32_t min_dist,
+	gaba_max_t *max)
+{
+	return(_api(this)->dp_search_topk(this, sec, k, min_dist, max));
+}
+
 /**
  * @fn gaba_dp_trace
  */
@@ -410,6 +846,61 @@ gaba_alignment_t *gaba_dp_trace(
 	return(_api(this)->dp_trace(this, fw_tail, rv_tail, params));
 }
 
+/**
+ * @fn gaba_dp_trace_max
+ */
+gaba_alignment_t *gaba_dp_trace_max(
+	gaba_dp_t *this,
+	gaba_max_t const *fw_max,
+	gaba_max_t const *rv_max,
+	gaba_trace_params_t const *params)
+{
+	return(_api(this)->dp_trace_max(this, fw_max, rv_max, params));
+}
+
+/**
+ * @fn gaba_dp_trace_cell
+ */
+gaba_alignment_t *gaba_dp_trace_cell(
+	gaba_dp_t *this,
+	gaba_fill_t const *fw_tail,
+	gaba_pos_pair_t const *fw_pos,
+	gaba_fill_t const *rv_tail,
+	gaba_pos_pair_t const *rv_pos,
+	gaba_trace_params_t const *params)
+{
+	return(_api(this)->dp_trace_cell(this, fw_tail, fw_pos, rv_tail, rv_pos, params));
+}
+
+/**
+ * @fn gaba_dp_trace_batch
+ */
+uint64_t gaba_dp_trace_batch(
+	gaba_dp_t *this,
+	gaba_fill_t const *const *fw_tail,
+	gaba_fill_t const *const *rv_tail,
+	uint64_t cnt,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln)
+{
+	return(_api(this)->dp_trace_batch(this, fw_tail, rv_tail, cnt, params, aln));
+}
+
+/**
+ * @fn gaba_dp_trace_tree
+ */
+uint64_t gaba_dp_trace_tree(
+	gaba_dp_t *this,
+	gaba_fill_t const *const *fw_tail,
+	uint64_t cnt,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params,
+	gaba_alignment_t **aln,
+	gaba_path_prefix_t *prefix)
+{
+	return(_api(this)->dp_trace_tree(this, fw_tail, cnt, rv_tail, params, aln, prefix));
+}
+
 /**
  * @fn gaba_dp_recombine
  */
@@ -433,6 +924,19 @@ void gaba_dp_res_free(
 	return;
 }
 
+/**
+ * @fn gaba_dp_rescore
+ */
+gaba_rescore_t gaba_dp_rescore(
+	gaba_dp_t *this,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen,
+	gaba_params_t const *params)
+{
+	return(gaba_dp_rescore_linear(this, aln, sec, slen, params));
+}
+
 
 /**
  * @fn gaba_dp_print_cigar_forward
@@ -486,6 +990,109 @@ uint64_t gaba_dp_dump_cigar_reverse(
 	return(gaba_dp_dump_cigar_reverse_linear(buf, buf_size, path, offset, len));
 }
 
+/**
+ * @fn gaba_dp_dump_bam_cigar_forward
+ */
+uint64_t gaba_dp_dump_bam_cigar_forward(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	return(gaba_dp_dump_bam_cigar_forward_linear(buf, buf_size, path, offset, len));
+}
+
+/**
+ * @fn gaba_dp_dump_bam_cigar_reverse
+ */
+uint64_t gaba_dp_dump_bam_cigar_reverse(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint32_t const *path,
+	uint32_t offset,
+	uint32_t len)
+{
+	return(gaba_dp_dump_bam_cigar_reverse_linear(buf, buf_size, path, offset, len));
+}
+
+/**
+ * @fn gaba_dp_dump_bam_cigar_batch
+ */
+uint64_t gaba_dp_dump_bam_cigar_batch(
+	uint32_t *buf,
+	uint64_t buf_size,
+	uint64_t *ofs,
+	gaba_alignment_t const *const *aln,
+	uint64_t cnt)
+{
+	return(gaba_dp_dump_bam_cigar_batch_linear(buf, buf_size, ofs, aln, cnt));
+}
+
+/**
+ * @fn gaba_dp_trace_size
+ */
+uint64_t gaba_dp_trace_size(
+	gaba_dp_t *this,
+	gaba_fill_t const *fw_tail,
+	gaba_fill_t const *rv_tail,
+	gaba_trace_params_t const *params)
+{
+	return(gaba_dp_trace_size_linear(this, fw_tail, rv_tail, params));
+}
+
+/**
+ * @fn gaba_dp_print_cigar_rle
+ */
+uint64_t gaba_dp_print_cigar_rle(
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_path_rle_t const *rle)
+{
+	return(gaba_dp_print_cigar_rle_linear(printer, fp, rle));
+}
+
+/**
+ * @fn gaba_dp_dump_cigar_rle
+ */
+uint64_t gaba_dp_dump_cigar_rle(
+	char *buf,
+	uint64_t buf_size,
+	gaba_path_rle_t const *rle)
+{
+	return(gaba_dp_dump_cigar_rle_linear(buf, buf_size, rle));
+}
+
+/**
+ * @fn gaba_dp_print_cigar_ext
+ */
+uint64_t gaba_dp_print_cigar_ext(
+	gaba_dp_t *this,
+	gaba_dp_printer_t printer,
+	void *fp,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen)
+{
+	return(gaba_dp_print_cigar_ext_linear(this, printer, fp, aln, sec, slen));
+}
+
+/**
+ * @fn gaba_dp_dump_cigar_ext
+ */
+uint64_t gaba_dp_dump_cigar_ext(
+	gaba_dp_t *this,
+	char *buf,
+	uint64_t buf_size,
+	char *md,
+	uint64_t md_size,
+	gaba_alignment_t const *aln,
+	gaba_section_t const *sec,
+	uint32_t slen)
+{
+	return(gaba_dp_dump_cigar_ext_linear(this, buf, buf_size, md, md_size, aln, sec, slen));
+}
+
 
 /* unittests */
 #if UNITTEST == 1
@@ -735,6 +1342,183 @@ unittest(with_seq_pair("GGAAAAAAAA", "AAAAAAAA"))
 	gaba_clean(c);	
 }
 
+/* steering variants give the same scores on a short pair */
+unittest(with_seq_pair("GGAAAAAAAA", "AAAAAAAA"))
+{
+	omajinai();
+
+	void const *lim = (void const *)0x800000000000;
+	uint8_t const steer[2] = { GABA_STEER_CENTER, GABA_STEER_HYBRID };
+	int64_t const max[2] = { 6, 5 };
+
+	for(uint64_t i = 0; i < 4; i++) {
+		gaba_t *c = gaba_init(GABA_PARAMS(.steer = steer[i>>1], GABA_SCORE_SIMPLE(1, 1, i & 0x01, 1)));
+		gaba_dp_t *d = gaba_dp_init(c, lim, lim);
+
+		gaba_fill_t *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+		f = gaba_dp_fill(d, f, &s->afsec, &s->bftail);
+		f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+		assert(f->max == max[i & 0x01], "%lu, %lld", i, f->max);
+
+		gaba_alignment_t *r = gaba_dp_trace(d, f, NULL, NULL);
+		assert(r != NULL && r->score == f->max, "%lu", i);
+
+		gaba_dp_clean(d);
+		gaba_clean(c);
+	}
+}
+
+/* short indels every ~20 bases, under each steering policy */
+unittest(with_seq_pair(
+	"GCTAAAGACAATTACATAACATACACGTCAGCACGAAACTTGTTGGCCCAGTGTGAATCGCTTAAGGGTTAAGTAAGTGTGATGCATAC"
+	"GCCTTTACTTGCTGTGTCCACCCCATCGGACTGGCATTTTTATTACACTCAGAAACAGAACTCGGGTAATTTTGACAGGTCACGCAGAGG"
+	"CGCGCCCTCCTGAAGTGCGTG",
+	"GCTAAAGACAATTTACATAACATACACGTCAGCACGAACTTGTTGGCCCAGTGTGAATCGAGGGTTAAACCAGTAAGTGTGATGCATACG"
+	"CCTTTATACTTGCTGTGTCCCCTCACCAGTCCGGAAAGGCATTTTTACTATAGACACTCAGAGAAACAGAACTCGGTAATTGCTTTTGAC"
+	"AGAGGCGCGCCCTCCTGCCACGGTTGG"))
+{
+	omajinai();
+
+	void const *lim = (void const *)0x800000000000;
+	for(uint64_t i = 0; i < 6; i++) {
+		gaba_t *c = gaba_init(GABA_PARAMS(.xdrop = 30, .steer = i>>1, GABA_SCORE_SIMPLE(2, 3, (i & 0x01) ? 5 : 0, (i & 0x01) ? 1 : 4)));
+		gaba_dp_t *d = gaba_dp_init(c, lim, lim);
+
+		gaba_fill_t *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+		while((f->status & GABA_STATUS_TERM) == 0) {
+			f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+		}
+		assert(f->max > 0, "%lu", i);
+
+		/* refill in the traceback follows the same band */
+		gaba_alignment_t *r = gaba_dp_trace(d, f, NULL, NULL);
+		assert(r != NULL && r->score == f->max, "%lu, %lld", i, f->max);
+
+		gaba_dp_clean(d);
+		gaba_clean(c);
+	}
+}
+
+/* linear-then-affine cascade */
+unittest(with_seq_pair(
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCTAGGCATGCAAGTCTGACTTGCAGTC",
+	"GATTACAGGCTTAACGTCCAGTACGATCGGATCCCCTAGGCATGCAAGTCTGACTTGCAGTC"))
+{
+	omajinai();
+
+	void const *lim = (void const *)0x800000000000;
+	gaba_params_t const *p = GABA_PARAMS(.xdrop = 30, GABA_SCORE_SIMPLE(2, 3, 5, 1));
+	gaba_t *lc = gaba_init_linear_filter(p), *ac = gaba_init(p);
+	gaba_dp_t *ld = gaba_dp_init(lc, lim, lim), *ad = gaba_dp_init(ac, lim, lim);
+
+	/* affine alone */
+	gaba_fill_t const *f = gaba_dp_fill_root(ad, &s->afsec, 0, &s->bfsec, 0);
+	f = gaba_dp_fill_end(ad, f);
+	int64_t amax = f->max;
+	assert(amax == 120 - 7, "%lld", amax);
+	gaba_dp_flush(ad, lim, lim);
+
+	/* passes the filter, the affine stage gives the same result */
+	gaba_cascade_t r = gaba_dp_fill_cascade(ld, ad, &s->afsec, 0, &s->bfsec, 0, 100);
+	assert(r.stage == GABA_CASCADE_AFFINE, "%u", r.stage);
+	assert(r.fill->max == amax, "%lld", r.fill->max);
+	assert(r.lmax >= amax, "%lld", r.lmax);
+
+	gaba_alignment_t *t = gaba_dp_trace(ad, r.fill, NULL, NULL);
+	assert(t != NULL && t->score == amax);
+
+	/* rejected by the linear stage */
+	gaba_dp_flush(ld, lim, lim);
+	gaba_dp_flush(ad, lim, lim);
+	r = gaba_dp_fill_cascade(ld, ad, &s->afsec, 0, &s->bfsec, 0, 1000);
+	assert(r.stage == GABA_CASCADE_LINEAR, "%u", r.stage);
+	assert(r.fill->max == r.lmax && r.lmax < 1000, "%lld", r.lmax);
+
+	gaba_dp_clean(ld);
+	gaba_dp_clean(ad);
+	gaba_clean(lc);
+	gaba_clean(ac);
+}
+
+/* slow-call capture */
+unittest(with_seq_pair("GGAAAAAAAA", "AAAAAAAA"))
+{
+	omajinai();
+
+	void const *lim = (void const *)0x800000000000;
+	gaba_t *c = gaba_init(GABA_PARAMS(GABA_SCORE_SIMPLE(1, 1, 0, 1)));
+	gaba_dp_t *d = gaba_dp_init(c, lim, lim);
+	char const *path = "unittest_watchdog.txt";
+	remove(path);
+
+	/* no record under the thresholds */
+	gaba_dp_set_watchdog(d, GABA_WATCHDOG_PARAMS(.cell_thresh = 1000000, .path = path));
+	gaba_fill_t *f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	gaba_alignment_t *r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+	FILE *fp = fopen(path, "r");
+	assert(fp == NULL);
+
+	/* both fill and trace are recorded */
+	gaba_dp_flush(d, lim, lim);
+	gaba_dp_set_watchdog(d, GABA_WATCHDOG_PARAMS(.cell_thresh = 1, .path = path));
+	f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+	f = gaba_dp_fill(d, f, &s->afsec, &s->bftail);
+	f = gaba_dp_fill(d, f, &s->aftail, &s->bftail);
+	r = gaba_dp_trace(d, f, NULL, NULL);
+	assert(r != NULL);
+
+	/* fill_end is recorded as a call, its fills on the margins are not */
+	f = gaba_dp_fill_end(d, f);
+	assert(f != NULL);
+
+	/* disabled */
+	gaba_dp_set_watchdog(d, NULL);
+	f = gaba_dp_fill_root(d, &s->afsec, 0, &s->bfsec, 0);
+
+	char buf[8192] = { 0 };
+	fp = fopen(path, "r");
+	assert(fp != NULL);
+	if(fp != NULL) {
+		fread(buf, 1, sizeof(buf) - 1, fp);
+		fclose(fp);
+	}
+	remove(path);
+
+	char const *fill = strstr(buf, "call\tfill\t");
+	char const *trace = strstr(buf, "call\ttrace\t");
+	char const *end = strstr(buf, "call\tfill_end\t");
+	assert(fill == buf, "%s", buf);
+	assert(trace != NULL && end > trace, "%s", buf);
+	if(fill == NULL || trace == NULL || end == NULL) { goto _unittest_watchdog_clean; }
+	assert(strstr(trace + 1, "call\t") == end && strstr(end + 1, "call\t") == NULL, "%s", buf);
+
+	/* params and sections are recorded in the original form */
+	int v[12] = { 0 };
+	long long stop = -1;
+	char const *params = strstr(fill, "params\t");
+	assert(params != NULL && sscanf(params, "params\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%lld",
+		&v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7], &v[8], &v[9], &v[10], &stop) == 12, "%s", buf);
+	assert(v[0] == 1 && v[1] == 1 && v[2] == 0 && v[3] == 1, "%s", buf);
+	assert(v[6] == GABA_MODE_EXTEND && v[9] == GABA_STEER_EDGE && v[10] == 0 && stop == 0, "%s", buf);
+	assert(strstr(fill, "a\t0\t10\t0\t4411111111\n") != NULL, "%s", buf);
+	assert(strstr(fill, "b\t4\t8\t0\t11111111\n") != NULL, "%s", buf);
+	assert(strstr(fill, "b\t6\t20\t0\t22222222222222222222\n") != NULL, "%s", buf);
+
+	/* trace records hold the root sections */
+	assert(strstr(trace, "a\t0\t10\t0\t4411111111\n") != NULL, "%s", buf);
+	assert(strstr(trace, "b\t4\t8\t0\t11111111\n") != NULL, "%s", buf);
+
+	/* the chain of fill_end ends at the last fill of the caller */
+	assert(strstr(end, "chain\t3\t1\n") != NULL, "%s", buf);
+	assert(strstr(buf, "a\t65534\t") == NULL && strstr(buf, "b\t65535\t") == NULL, "%s", buf);
+
+_unittest_watchdog_clean:;
+
+	gaba_dp_clean(d);
+	gaba_clean(c);
+}
+
 #endif
 /**
  * end of gaba_wrap.c